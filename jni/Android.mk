@@ -5,21 +5,47 @@ LOCAL_MODULE := sys.nusaservice
 LOCAL_SRC_FILES := \
     main.c \
     src/cmd_utils.c \
+    src/tick_arena.c \
     src/nusantara_log.c \
     src/nusantara_profiler.c \
     src/file_utils.c \
     src/process_utils.c \
     src/misc_utils.c \
     src/preload_function.c \
-    src/mlbb_handler.c
+    src/psi_monitor.c \
+    src/thread_boost.c \
+    src/cpu_topology.c \
+    src/cgroup_manager.c \
+    src/app_freezer.c \
+    src/perf_controller.c \
+    src/thermal_monitor.c \
+    src/gpu_controller.c \
+    src/io_booster.c \
+    src/net_monitor.c \
+    src/irq_manager.c \
+    src/launch_boost.c \
+    src/touch_booster.c \
+    src/energy_meter.c \
+    src/daemon_status.c \
+    src/daemon_state.c \
+    src/boot_wait.c \
+    src/package_index.c \
+    src/game_config.c \
+    src/game_session.c \
+    src/session_history.c \
+    src/task_executor.c \
+    src/game_retention.c \
+    src/profile_fsm.c \
+    src/trace_recorder.c \
+    src/game_rules.c
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/include
 
-LOCAL_CFLAGS := -DNDEBUG -Wall -Wextra -Werror \
+LOCAL_CFLAGS := -DNDEBUG -D_GNU_SOURCE -Wall -Wextra -Werror \
                 -pedantic-errors -Wpedantic \
                 -O2 -std=c23 -fPIC -flto
 
 LOCAL_LDFLAGS := -flto
-LOCAL_LDLIBS  += -llog  
+LOCAL_LDLIBS  += -llog -ldl
 
 include $(BUILD_EXECUTABLE)
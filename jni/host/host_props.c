@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Empty property area for the host build.
+ */
+
+#include <nusantara.h>
+#include <sys/system_properties.h>
+
+int __system_property_get(const char* name, char* value) {
+    (void)name;
+    value[0] = '\0';
+    return 0;
+}
+
+const prop_info* __system_property_find(const char* name) {
+    (void)name;
+    return NULL;
+}
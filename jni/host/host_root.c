@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host filesystem root. The Makefile links daemon modules with --wrap for
+ * every libc call taking a path, so /proc, /sys and /data resolve inside a
+ * fixture tree without touching device code. Executed programs and the PATH
+ * handed to them resolve there too, so fixture scripts stand in for dumpsys
+ * and settings. Allocator calls are wrapped too and only counted.
+ */
+
+#include <nusantara.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+
+const char* host_root = NULL;
+unsigned long host_writes = 0;
+unsigned long host_allocs = 0;
+
+FILE* __real_fopen(const char* path, const char* mode);
+int __real_open(const char* path, int flags, ...);
+DIR* __real_opendir(const char* path);
+int __real_access(const char* path, int mode);
+int __real_stat(const char* path, struct stat* st);
+int __real_mkdir(const char* path, mode_t mode);
+int __real_rename(const char* from, const char* to);
+int __real_execv(const char* path, char* const argv[]);
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+char* __real_strdup(const char* string);
+char* __real_strndup(const char* string, size_t len);
+
+/***********************************************************************************
+ * Function Name      : host_path
+ * Inputs             : path (const char *) - path used by the daemon
+ *                      buf (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : const char * - path inside host root
+ * Description        : Relative paths and paths already inside the root are
+ *                      left alone.
+ ***********************************************************************************/
+static const char* host_path(const char* path, char* buf, const size_t len) {
+    if (!host_root || !path || path[0] != '/')
+        return path;
+
+    size_t root_len = strlen(host_root);
+    if (strncmp(path, host_root, root_len) == 0 && (path[root_len] == '/' || path[root_len] == '\0'))
+        return path;
+
+    snprintf(buf, len, "%s%s", host_root, path);
+    return buf;
+}
+
+FILE* __wrap_fopen(const char* path, const char* mode) {
+    char buf[PATH_MAX];
+    if (mode[0] != 'r' || strchr(mode, '+'))
+        host_writes++;
+    return __real_fopen(host_path(path, buf, sizeof(buf)), mode);
+}
+
+int __wrap_open(const char* path, int flags, ...) {
+    char buf[PATH_MAX];
+    mode_t mode = 0;
+
+    if (flags & O_CREAT) {
+        va_list args;
+        va_start(args, flags);
+        mode = (mode_t)va_arg(args, int);
+        va_end(args);
+    }
+
+    if (flags & (O_WRONLY | O_RDWR))
+        host_writes++;
+    return __real_open(host_path(path, buf, sizeof(buf)), flags, mode);
+}
+
+DIR* __wrap_opendir(const char* path) {
+    char buf[PATH_MAX];
+    return __real_opendir(host_path(path, buf, sizeof(buf)));
+}
+
+int __wrap_access(const char* path, int mode) {
+    char buf[PATH_MAX];
+    return __real_access(host_path(path, buf, sizeof(buf)), mode);
+}
+
+int __wrap_stat(const char* path, struct stat* st) {
+    char buf[PATH_MAX];
+    return __real_stat(host_path(path, buf, sizeof(buf)), st);
+}
+
+int __wrap_mkdir(const char* path, mode_t mode) {
+    char buf[PATH_MAX];
+    return __real_mkdir(host_path(path, buf, sizeof(buf)), mode);
+}
+
+int __wrap_rename(const char* from, const char* to) {
+    char from_buf[PATH_MAX], to_buf[PATH_MAX];
+    host_writes++;
+    return __real_rename(host_path(from, from_buf, sizeof(from_buf)), host_path(to, to_buf, sizeof(to_buf)));
+}
+
+/***********************************************************************************
+ * Function Name      : host_search_path
+ * Inputs             : dirs (const char *) - PATH value used by the daemon
+ *                      buf (char *) - output buffer, a whole PATH= entry
+ *                      len (size_t) - output buffer size
+ * Returns            : char * - buf
+ * Description        : Every directory moves inside the host root, host tools
+ *                      follow so pipelines like grep and awk still resolve.
+ ***********************************************************************************/
+static char* host_search_path(const char* dirs, char* buf, const size_t len) {
+    size_t used = (size_t)snprintf(buf, len, "PATH=");
+
+    for (const char* dir = dirs; *dir && used < len;) {
+        size_t dir_len = strcspn(dir, ":");
+        used += (size_t)snprintf(buf + used, len - used, "%s%.*s:", host_root, (int)dir_len, dir);
+        dir += dir_len + (dir[dir_len] == ':');
+    }
+
+    if (used < len)
+        snprintf(buf + used, len - used, "/usr/bin:/bin");
+    return buf;
+}
+
+int __wrap_execv(const char* path, char* const argv[]) {
+    char buf[PATH_MAX];
+    return __real_execv(host_path(path, buf, sizeof(buf)), argv);
+}
+
+int __wrap_execle(const char* path, const char* arg0, ...) {
+    char buf[PATH_MAX];
+    char search[PATH_MAX * 2];
+    const char* argv[16];
+    char* env[32];
+    int argc = 0, envc = 0;
+
+    va_list args;
+    va_start(args, arg0);
+    argv[argc++] = arg0;
+    while (argc < 15 && (argv[argc] = va_arg(args, const char*)))
+        argc++;
+    argv[argc] = NULL;
+    char* const* envp = va_arg(args, char* const*);
+    va_end(args);
+
+    for (int i = 0; envp && envp[i] && envc < 31; i++) {
+        if (host_root && strncmp(envp[i], "PATH=", 5) == 0)
+            env[envc++] = host_search_path(envp[i] + 5, search, sizeof(search));
+        else
+            env[envc++] = envp[i];
+    }
+    env[envc] = NULL;
+
+    return execve(host_path(path, buf, sizeof(buf)), (char* const*)argv, env);
+}
+
+void* __wrap_malloc(size_t size) {
+    host_allocs++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    host_allocs++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    host_allocs++;
+    return __real_realloc(ptr, size);
+}
+
+char* __wrap_strdup(const char* string) {
+    host_allocs++;
+    return __real_strdup(string);
+}
+
+char* __wrap_strndup(const char* string, size_t len) {
+    host_allocs++;
+    return __real_strndup(string, len);
+}
@@ -0,0 +1,1034 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host benchmark of daemon hot paths over a generated /proc, /sys and /data
+ * tree. Fixture sizes are fixed, every case runs several repetitions and the
+ * median is reported, so results can be compared against a saved baseline.
+ *
+ *   nusantara_bench [-n reps] [-r root] [-k] [-o results] [-c baseline] [-t pct]
+ *   nusantara_bench -s ticks    soak the loop tick instead
+ */
+
+#include <nusantara.h>
+#include <ftw.h>
+#include <getopt.h>
+#include <linux/input.h>
+#include <regex.h>
+#include <sys/stat.h>
+
+#define BENCH_PIDS 4000
+#define BENCH_GAME_PID 31337
+#define BENCH_GAME_THREADS 24
+#define BENCH_GAMES 2000
+#define BENCH_LOOKUPS 20000
+#define BENCH_REGEX_LOOKUPS 200
+#define BENCH_WRITES 5000
+#define BENCH_APPLIES 200
+#define BENCH_LIBS 4
+#define BENCH_LIB_MB 32
+#define BENCH_PRELOAD_MB 96
+#define BENCH_PRELOAD_DIR "/data/app/~~bench==/com.bench.game-1/lib/arm64"
+#define BENCH_GAME "com.bench.game"
+#define BENCH_GAME_UID 10234
+#define BENCH_SOCKETS 30000
+#define BENCH_HISTORY_GAMES 40
+#define BENCH_HISTORY_APPENDS 64
+#define BENCH_HISTORY_REPORT MODULE_CONFIG "/history_report"
+#define BENCH_TASKS 1000
+#define BENCH_TOUCH_FRAMES 2000
+#define BENCH_TOUCH_TAP 20
+#define BENCH_TOUCH_STREAM "/data/local/tmp/touch.rec"
+#define BENCH_MAX_CASES 20
+#define SOAK_WARMUP_TICKS 10000
+#define SOAK_STATUS_EVERY 16
+#define SOAK_SPAWN_EVERY 64
+#define SOAK_PHASE_TICKS 1000
+#define SOAK_POWER_STATE "/data/local/tmp/dumpsys_power"
+#define SOAK_LOW_POWER "/data/local/tmp/low_power"
+#define SOAK_MAX_RSS_GROWTH_KB 256
+
+// Daemon globals normally owned by main.c
+char* gamestart = NULL;
+pid_t game_pid = 0;
+
+extern const char* host_root;
+extern unsigned long host_writes;
+extern unsigned long host_allocs;
+
+typedef struct {
+    const char* name;
+    void (*setup)(void);
+    long (*run)(void);
+} BenchCase;
+
+typedef struct {
+    const char* name;
+    double median_ns;
+    double min_ns;
+    double writes;
+} BenchResult;
+
+typedef struct {
+    const char* name;
+    int nr_clusters;
+    int cpus[MAX_CLUSTERS];
+    long capacity[MAX_CLUSTERS];
+    long max_freq[MAX_CLUSTERS];
+    const char* expect;
+} SocFixture;
+
+static const SocFixture soc_fixtures[] = {
+    {"sd8g1", 3, {4, 3, 1}, {325, 828, 1024}, {1785600, 2496000, 2995200}, "little big prime"},
+    {"sd8g3", 4, {2, 2, 3, 1}, {420, 840, 870, 1024}, {2265600, 2956800, 3148800, 3302400}, "little mid big prime"},
+    {"dimensity8100", 2, {4, 4}, {461, 1024}, {2000000, 2850000}, "little big"},
+    {"helio_g99", 2, {6, 2}, {386, 1024}, {2000000, 2200000}, "little big"},
+    {"tensor_g2", 3, {4, 2, 2}, {160, 565, 1024}, {1803000, 2348000, 2850000}, "little big prime"},
+};
+
+static char names[BENCH_LOOKUPS][MAX_PACKAGE];
+static regex_t gamelist_regex;
+static BenchResult results[BENCH_MAX_CASES];
+static int nr_results = 0;
+static int reps = 15;
+static time_t gamelist_stamp = 1000000000;
+
+/***********************************************************************************
+ * Function Name      : now_ns
+ * Inputs             : None
+ * Returns            : long long - monotonic time in nanoseconds
+ ***********************************************************************************/
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/***********************************************************************************
+ * Function Name      : fixture_dir
+ * Inputs             : path (const char *) - device path of a directory
+ * Returns            : None
+ * Description        : mkdir -p inside the host root.
+ ***********************************************************************************/
+static void fixture_dir(const char* path) {
+    char buf[MAX_PATH_LENGTH];
+    snprintf(buf, sizeof(buf), "%s", path);
+
+    for (char* p = buf + 1; *p; p++) {
+        if (*p != '/')
+            continue;
+        *p = '\0';
+        mkdir(buf, 0755);
+        *p = '/';
+    }
+    mkdir(buf, 0755);
+}
+
+/***********************************************************************************
+ * Function Name      : fixture_data
+ * Inputs             : path (const char *) - device path of a file
+ *                      data (const void *) - content
+ *                      len (size_t) - content length
+ * Returns            : None
+ * Description        : Creates parent directories, then writes the file.
+ ***********************************************************************************/
+static void fixture_data(const char* path, const void* data, const size_t len) {
+    char dir[MAX_PATH_LENGTH];
+    snprintf(dir, sizeof(dir), "%s", path);
+    char* slash = strrchr(dir, '/');
+    if (slash && slash != dir) {
+        *slash = '\0';
+        fixture_dir(dir);
+    }
+
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        fprintf(stderr, "fixture: unable to create %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    fwrite(data, 1, len, fp);
+    fclose(fp);
+}
+
+/***********************************************************************************
+ * Function Name      : fixture_file
+ * Inputs             : path (const char *) - device path of a file
+ *                      fmt (const char *) - printf format of the content
+ * Returns            : None
+ ***********************************************************************************/
+static void fixture_file(const char* path, const char* fmt, ...) {
+    char data[MAX_DATA_LENGTH];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(data, sizeof(data), fmt, args);
+    va_end(args);
+    fixture_data(path, data, (size_t)len);
+}
+
+/***********************************************************************************
+ * Function Name      : fixture_script
+ * Inputs             : path (const char *) - device path of a program
+ *                      fmt (const char *) - printf format of the script
+ * Returns            : None
+ * Description        : Executable stand-in for a device program.
+ ***********************************************************************************/
+static void fixture_script(const char* path, const char* fmt, ...) {
+    char data[MAX_DATA_LENGTH];
+    char real[MAX_PATH_LENGTH * 2];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(data, sizeof(data), fmt, args);
+    va_end(args);
+    fixture_data(path, data, (size_t)len);
+
+    // chmod is not wrapped, it takes the host path
+    snprintf(real, sizeof(real), "%s%s", host_root, path);
+    chmod(real, 0755);
+}
+
+/***********************************************************************************
+ * Function Name      : fixture_cpufreq
+ * Inputs             : prefix (const char *) - "" or a SoC subtree
+ *                      soc (const SocFixture *) - cluster layout
+ * Returns            : None
+ * Description        : Writes policies, frequency tables and per-CPU capacity.
+ ***********************************************************************************/
+static void fixture_cpufreq(const char* prefix, const SocFixture* soc) {
+    char path[MAX_PATH_LENGTH];
+    int first = 0;
+
+    for (int c = 0; c < soc->nr_clusters; c++) {
+        int last = first + soc->cpus[c] - 1;
+        char freqs[MAX_OUTPUT_LENGTH] = {0};
+        size_t len = 0;
+
+        // 16 steps from 300MHz up to max
+        for (int i = 0; i < 16; i++)
+            len += snprintf(freqs + len, sizeof(freqs) - len, "%ld ", 300000 + (soc->max_freq[c] - 300000) * i / 15);
+
+        snprintf(path, sizeof(path), "%s/sys/devices/system/cpu/cpufreq/policy%d", prefix, first);
+        fixture_dir(path);
+
+#define POLICY_NODE(node, ...)                                                                          \
+    do {                                                                                                \
+        char node_path[MAX_PATH_LENGTH * 2];                                                            \
+        snprintf(node_path, sizeof(node_path), "%s/" node, path);                                       \
+        fixture_file(node_path, __VA_ARGS__);                                                           \
+    } while (0)
+
+        POLICY_NODE("related_cpus", "%d-%d\n", first, last);
+        POLICY_NODE("cpuinfo_min_freq", "300000\n");
+        POLICY_NODE("cpuinfo_max_freq", "%ld\n", soc->max_freq[c]);
+        POLICY_NODE("scaling_available_frequencies", "%s\n", freqs);
+        POLICY_NODE("scaling_min_freq", "300000\n");
+        POLICY_NODE("scaling_governor", "schedutil\n");
+#undef POLICY_NODE
+
+        for (int cpu = first; cpu <= last; cpu++) {
+            snprintf(path, sizeof(path), "%s/sys/devices/system/cpu/cpu%d/cpu_capacity", prefix, cpu);
+            fixture_file(path, "%ld\n", soc->capacity[c]);
+            snprintf(path, sizeof(path), "%s/sys/devices/system/cpu/cpu%d/topology/cluster_id", prefix, cpu);
+            fixture_file(path, "%d\n", c);
+        }
+
+        first = last + 1;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : fixture_sockets
+ * Inputs             : path (const char *) - socket table, e.g. /proc/net/tcp
+ *                      count (int) - number of sockets
+ *                      v6 (bool) - true for 128 bit addresses
+ * Returns            : None
+ * Description        : Every 97th socket belongs to the game, half of them to
+ *                      a loopback peer.
+ ***********************************************************************************/
+static void fixture_sockets(const char* path, const int count, const bool v6) {
+    static char table[BENCH_SOCKETS * 192];
+    size_t len = snprintf(table, sizeof(table), "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when "
+                                                "retrnsmt   uid  timeout inode\n");
+
+    for (int i = 0; i < count && len < sizeof(table) - 192; i++) {
+        int uid = i % 97 ? 10000 + i % 300 : BENCH_GAME_UID;
+        unsigned int peer = i % 194 ? 0x0001A8C0 + ((unsigned int)(i % 250 + 1) << 24) : 0x0100007F;
+        const char* prefix = v6 ? "0000000000000000FFFF0000" : "";
+        len += snprintf(table + len, sizeof(table) - len,
+                        "%4d: %s0F02000A:%04X %s%08X:01BB %02X 00000000:00000000 00:00000000 00000000 %5d        0 %d 1 "
+                        "0000000000000000 20 4 30 10 -1\n",
+                        i, prefix, 30000 + i % 30000, prefix, peer, i % 3 ? 1 : 6, uid, 100000 + i);
+    }
+
+    fixture_data(path, table, len);
+}
+
+/***********************************************************************************
+ * Function Name      : fixture_build
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Generates the whole tree. Names are derived from the
+ *                      index only, so every run sees the same fixture.
+ ***********************************************************************************/
+static void fixture_build(void) {
+    char path[MAX_PATH_LENGTH];
+    char cmdline[MAX_PACKAGE * 2];
+
+    for (int i = 0; i < BENCH_PIDS; i++) {
+        int len = snprintf(cmdline, sizeof(cmdline), "com.vendor%02d.app%04d", i % 37, i);
+        memcpy(cmdline + len + 1, "--flag", 7);
+        snprintf(path, sizeof(path), "/proc/%d/cmdline", 1000 + i);
+        fixture_data(path, cmdline, (size_t)len + 8);
+    }
+
+    snprintf(path, sizeof(path), "/proc/%d/cmdline", BENCH_GAME_PID);
+    fixture_data(path, BENCH_GAME, sizeof(BENCH_GAME));
+    snprintf(path, sizeof(path), "/proc/%d/oom_score_adj", BENCH_GAME_PID);
+    fixture_file(path, "0\n");
+    for (int t = 0; t < BENCH_GAME_THREADS; t++) {
+        snprintf(path, sizeof(path), "/proc/%d/task/%d/stat", BENCH_GAME_PID, BENCH_GAME_PID + t);
+        fixture_file(path, "%d (%s) S 1 1 1 0 -1 4194560 0 0 0 0 %d %d 0 0 20 0\n", BENCH_GAME_PID + t,
+                     t == 0 ? "UnityMain" : "Worker Thread", 1000 + t, 100);
+    }
+
+    fixture_file("/proc/meminfo", "MemTotal:       11534336 kB\nMemFree:         1048576 kB\n"
+                                  "MemAvailable:    6291456 kB\n");
+    fixture_file(PSI_MEMORY_PATH, "some avg10=0.00 avg60=0.00 avg300=0.00 total=0\n"
+                                  "full avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+    fixture_file(PSI_IO_PATH, "some avg10=0.00 avg60=0.00 avg300=0.00 total=0\n"
+                              "full avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+
+    fixture_cpufreq("", &soc_fixtures[0]);
+    for (size_t i = 0; i < sizeof(soc_fixtures) / sizeof(soc_fixtures[0]); i++) {
+        snprintf(path, sizeof(path), "/soc/%s", soc_fixtures[i].name);
+        fixture_cpufreq(path, &soc_fixtures[i]);
+    }
+
+    fixture_dir(MODULE_CONFIG);
+    fixture_file(MODULE_CONFIG "/default_cpu_gov", "schedutil\n");
+    fixture_file(SOC_RECOGNITION, "2\n");
+    fixture_file(GPU_CONTROLLER, "1\n");
+
+    // Adreno 730 table, listed fastest first like kgsl does
+    fixture_file(KGSL_ROOT "/gpu_busy_percentage", "12 %%\n");
+    fixture_file(KGSL_ROOT "/devfreq/available_frequencies",
+                 "818000000 734000000 676000000 615000000 545000000 490000000 443000000 315000000\n");
+    fixture_file(KGSL_ROOT "/devfreq/min_freq", "315000000\n");
+    fixture_file(KGSL_ROOT "/devfreq/cur_freq", "315000000\n");
+
+    // Snapdragon zone names, SOC_RECOGNITION above says Qualcomm
+    static const char* zones[] = {"cpuss-0", "gpuss-0", "xo-therm"};
+    for (int z = 0; z < 3; z++) {
+        snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/type", z);
+        fixture_file(path, "%s\n", zones[z]);
+        snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/temp", z);
+        fixture_file(path, "%d\n", 41000 + z * 2000);
+        snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/trip_point_0_type", z);
+        fixture_file(path, "passive\n");
+        snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/trip_point_0_temp", z);
+        fixture_file(path, "%d\n", 95000 - z * 20000);
+    }
+
+    fixture_file(BATTERY_SUPPLY "/status", "Discharging\n");
+    fixture_file(BATTERY_SUPPLY "/current_now", "-450000\n");
+    fixture_file(BATTERY_SUPPLY "/voltage_now", "3900000\n");
+
+    // Device programs behind execute_command and execute_direct, state comes from the soak
+    fixture_file(SOAK_POWER_STATE, "mWakefulness=Awake\nmSettingBatterySaverEnabled=false\n");
+    fixture_file(SOAK_LOW_POWER, "0\n");
+    fixture_script("/system/bin/sh", "#!/bin/sh\nexec /bin/sh \"$@\"\n");
+    fixture_script("/system/bin/dumpsys", "#!/bin/sh\n[ \"$1\" = power ] && exec cat '%s%s'\nexit 1\n", host_root,
+                   SOAK_POWER_STATE);
+    fixture_script("/system/bin/settings", "#!/bin/sh\n[ \"$3\" = low_power ] && exec cat '%s%s'\nexit 1\n", host_root,
+                   SOAK_LOW_POWER);
+
+    fixture_sockets("/proc/net/tcp", BENCH_SOCKETS * 8 / 15, false);
+    fixture_sockets("/proc/net/tcp6", BENCH_SOCKETS * 4 / 15, true);
+    fixture_sockets("/proc/net/udp", BENCH_SOCKETS * 2 / 15, false);
+    fixture_sockets("/proc/net/udp6", BENCH_SOCKETS / 15, true);
+
+    // Gamelist in shipped format, one '|' separated line
+    static char list[BENCH_GAMES * MAX_PACKAGE];
+    size_t len = 0;
+    for (int i = 0; i < BENCH_GAMES; i++)
+        len += snprintf(list + len, sizeof(list) - len, "%scom.studio%03d.game%04d", i ? "|" : "", i % 211, i);
+    fixture_data(GAMELIST, list, len);
+    fixture_file(GAME_CONFIG, "com.studio000.game0000 governor=performance floor=50\n");
+
+    // Regex baseline over the same list, the way gamelist used to be matched
+    char* pattern = malloc(len + 8);
+    snprintf(pattern, len + 8, "^(%s)$", list);
+    if (regcomp(&gamelist_regex, pattern, REG_EXTENDED | REG_NOSUB) != 0) {
+        fprintf(stderr, "fixture: regcomp failed\n");
+        exit(1);
+    }
+    free(pattern);
+
+    // Half hits, half misses that share the prefix
+    for (int i = 0; i < BENCH_LOOKUPS; i++) {
+        int g = (i * 7919) % BENCH_GAMES;
+        if (i % 2)
+            snprintf(names[i], MAX_PACKAGE, "com.studio%03d.game%04d", g % 211, g);
+        else
+            snprintf(names[i], MAX_PACKAGE, "com.studio%03d.tool%04d", g % 211, g);
+    }
+
+    fixture_dir(BENCH_PRELOAD_DIR);
+    for (int i = 0; i < BENCH_LIBS; i++) {
+        snprintf(path, sizeof(path), BENCH_PRELOAD_DIR "/libbench%d.so", i);
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1 || ftruncate(fd, (off_t)BENCH_LIB_MB << 20) == -1) {
+            fprintf(stderr, "fixture: unable to create %s\n", path);
+            exit(1);
+        }
+        close(fd);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : check_topology
+ * Inputs             : None
+ * Returns            : int - number of SoC fixtures classified wrong
+ * Description        : Cluster classes must not change while tuning hot paths.
+ ***********************************************************************************/
+static int check_topology(void) {
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(soc_fixtures) / sizeof(soc_fixtures[0]); i++) {
+        const SocFixture* soc = &soc_fixtures[i];
+        char prefix[MAX_PATH_LENGTH];
+        char got[MAX_OUTPUT_LENGTH] = {0};
+        size_t len = 0;
+        CpuTopology topo;
+
+        snprintf(prefix, sizeof(prefix), "/soc/%s", soc->name);
+        if (topology_init(&topo, prefix)) {
+            for (int c = 0; c < topo.nr_clusters; c++)
+                len += snprintf(got + len, sizeof(got) - len, "%s%s", c ? " " : "", cluster_type_name[topo.cluster[c].type]);
+        }
+
+        bool ok = strcmp(got, soc->expect) == 0;
+        printf("topology %-14s %-22s %s\n", soc->name, got, ok ? "ok" : "FAIL");
+        if (!ok) {
+            printf("  expected %s\n", soc->expect);
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+static long run_pidof_hit(void) {
+    for (int i = 0; i < 10; i++) {
+        if (pidof(BENCH_GAME) != BENCH_GAME_PID) {
+            fprintf(stderr, "pidof_hit: wrong pid\n");
+            exit(1);
+        }
+    }
+    return 10;
+}
+
+static long run_pidof_miss(void) {
+    for (int i = 0; i < 10; i++)
+        pidof("com.absent.game");
+    return 10;
+}
+
+static void setup_gamelist_load(void) {
+    // Table only reloads on mtime change, move it forward each repetition
+    char path[MAX_PATH_LENGTH * 2];
+    struct timespec times[2] = {{.tv_sec = ++gamelist_stamp}, {.tv_sec = gamelist_stamp}};
+    snprintf(path, sizeof(path), "%s%s", host_root, GAMELIST);
+    utimensat(AT_FDCWD, path, times, 0);
+}
+
+static long run_gamelist_load(void) {
+    return game_config_refresh() ? 1 : 0;
+}
+
+static long run_gamelist_match(void) {
+    long hits = 0;
+    for (int i = 0; i < BENCH_LOOKUPS; i++)
+        hits += game_config_match(names[i], strlen(names[i]));
+
+    if (hits != BENCH_LOOKUPS / 2) {
+        fprintf(stderr, "gamelist_match: %ld hits, expected %d\n", hits, BENCH_LOOKUPS / 2);
+        exit(1);
+    }
+    return BENCH_LOOKUPS;
+}
+
+static long run_gamelist_regex(void) {
+    for (int i = 0; i < BENCH_REGEX_LOOKUPS; i++)
+        regexec(&gamelist_regex, names[i], 0, NULL, 0);
+    return BENCH_REGEX_LOOKUPS;
+}
+
+static long run_write2file(void) {
+    for (int i = 0; i < BENCH_WRITES; i++)
+        write2file("/sys/devices/system/cpu/cpufreq/policy0/scaling_min_freq", false, false, "%d", 300000 + i);
+    return BENCH_WRITES;
+}
+
+static void setup_log(void) {
+    write2file(LOG_FILE, false, false, "\n");
+}
+
+static long run_log(void) {
+    for (int i = 0; i < BENCH_WRITES; i++)
+        log_nusantara(LOG_INFO, "Benchmark line %d of %s", i, BENCH_GAME);
+    return BENCH_WRITES;
+}
+
+static long run_profile_apply(void) {
+    const GameProfile* profile = game_config_get("com.studio000.game0000");
+    for (int i = 0; i < BENCH_APPLIES; i++)
+        game_config_apply(profile);
+    return BENCH_APPLIES;
+}
+
+static void setup_perf_walk(void) {
+    fixture_cpufreq("", &soc_fixtures[0]);
+}
+
+static long run_perf_walk(void) {
+    perf_controller_start(BENCH_GAME_PID);
+
+    // Ticks without sleeping see no CPU time, demand walks down every level
+    for (int i = 0; i < PERF_DOWN_SAMPLES * PERF_LEVEL_MAX * 2 && perf_controller_level() > PERF_LEVEL_LIGHT; i++)
+        perf_controller_tick(BENCH_GAME_PID);
+
+    perf_controller_stop();
+    return 1;
+}
+
+static void setup_gpu_walk(void) {
+    gpu_init();
+}
+
+static long run_gpu_walk(void) {
+    gpu_controller_start(BENCH_GAME);
+
+    // Light busy at the lowest clock, every tick counts as a menu
+    for (int i = 0; i < PERF_DOWN_SAMPLES * PERF_LEVEL_MAX * 2; i++)
+        gpu_controller_tick();
+
+    gpu_controller_stop();
+    return 1;
+}
+
+static long run_net_parse(void) {
+    if (net_game_flows(BENCH_GAME_UID) <= 0) {
+        fprintf(stderr, "net_parse: no game flows found\n");
+        exit(1);
+    }
+    return BENCH_SOCKETS;
+}
+
+// Per line sscanf over the same tables, the straightforward parser
+static long run_net_sscanf(void) {
+    static const char* tables[] = {"/proc/net/udp", "/proc/net/udp6", "/proc/net/tcp", "/proc/net/tcp6"};
+    char line[MAX_LINE];
+    int flows = 0;
+
+    for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); t++) {
+        FILE* fp = fopen(tables[t], "r");
+        if (!fp || !fgets(line, sizeof(line), fp))
+            exit(1);
+
+        char remote[64];
+        unsigned int st, uid;
+        while (fgets(line, sizeof(line), fp)) {
+            if (sscanf(line, "%*d: %*s %63s %X %*s %*s %*s %u", remote, &st, &uid) == 3 && st == 1 &&
+                uid == BENCH_GAME_UID && !strstr(remote, "0100007F"))
+                flows++;
+        }
+        fclose(fp);
+    }
+
+    return flows > 0 ? BENCH_SOCKETS : 0;
+}
+
+// Ten minutes apart, a full ring spans just under 30 days
+static void fill_history(const int count) {
+    time_t now = time(NULL);
+
+    for (int i = 0; i < count; i++) {
+        HistoryRecord record = {.boost_ms = 300 + (uint32_t)(i * 37 % 900), .preload_ms = 1500, .preload_kb = 65536};
+        snprintf(record.package, sizeof(record.package), "com.studio%03d.game", i % BENCH_HISTORY_GAMES);
+        record.end = (uint32_t)(now - (HISTORY_CAPACITY - i) * 600);
+        record.start = record.end - 1800;
+        record.profile_s[PERFORMANCE_PROFILE] = 1700;
+        record.cluster_mhz[0] = 1400;
+        record.peak_temp[THERMAL_CPU] = 780;
+        history_append(SESSION_HISTORY, &record);
+    }
+}
+
+static long run_history_append(void) {
+    fill_history(BENCH_HISTORY_APPENDS);
+    return BENCH_HISTORY_APPENDS;
+}
+
+static void setup_history_query(void) {
+    fill_history(HISTORY_CAPACITY);
+}
+
+static long run_history_query(void) {
+    FILE* out = fopen(BENCH_HISTORY_REPORT, "w");
+    int n = out ? history_query(SESSION_HISTORY, out, HISTORY_DEFAULT_DAYS, NULL) : -1;
+    if (out)
+        fclose(out);
+
+    if (n != HISTORY_CAPACITY) {
+        fprintf(stderr, "history_query: %d sessions, expected %d\n", n, HISTORY_CAPACITY);
+        exit(1);
+    }
+    return HISTORY_CAPACITY;
+}
+
+static void noop_task(Task* task) {
+    task->result = task->value;
+}
+
+static void setup_executor(void) {
+    static bool started = false;
+    if (!started && executor_start() == 0) {
+        fprintf(stderr, "executor: no worker threads\n");
+        exit(1);
+    }
+    started = true;
+}
+
+// Queue to completion on a worker, lanes alternate so several run at once
+static long run_executor(void) {
+    for (int i = 0; i < BENCH_TASKS; i++) {
+        Task task = {.run = noop_task, .priority = (TaskPriority)(i % TASK_PRIORITY_MAX), .value = i};
+        if (!executor_submit(&task))
+            executor_wait(task.priority);
+    }
+    for (int lane = 0; lane < TASK_PRIORITY_MAX; lane++)
+        executor_wait((TaskPriority)lane);
+    return BENCH_TASKS;
+}
+
+static void touch_frame(FILE* fp, const int code, const int value, const int x) {
+    struct input_event ev[4] = {
+        {.type = EV_ABS, .code = ABS_MT_SLOT, .value = 0},
+        {.type = EV_ABS, .code = (unsigned short)code, .value = value},
+        {.type = EV_ABS, .code = ABS_MT_POSITION_X, .value = x},
+        {.type = EV_SYN, .code = SYN_REPORT},
+    };
+    fwrite(ev, sizeof(ev[0]), 4, fp);
+}
+
+// Recorded stream of taps and drags, a new contact every BENCH_TOUCH_TAP frames
+static void setup_touch(void) {
+    fixture_cpufreq("", &soc_fixtures[0]);
+    fixture_file(TOUCH_BOOST, "1\n");
+    fixture_dir("/data/local/tmp");
+
+    FILE* fp = fopen(BENCH_TOUCH_STREAM, "w");
+    if (!fp) {
+        fprintf(stderr, "touch: unable to write stream\n");
+        exit(1);
+    }
+    for (int i = 0; i < BENCH_TOUCH_FRAMES; i++) {
+        if (i % BENCH_TOUCH_TAP == 0)
+            touch_frame(fp, ABS_MT_TRACKING_ID, i, i);
+        else if (i % BENCH_TOUCH_TAP == BENCH_TOUCH_TAP - 1)
+            touch_frame(fp, ABS_MT_TRACKING_ID, -1, i);
+        else
+            touch_frame(fp, ABS_MT_POSITION_Y, i, i);
+    }
+    fclose(fp);
+}
+
+// Replay bumps the floor once, every later tap lands inside the running bump
+static long run_touch(void) {
+    static const char* floor_node = "/sys/devices/system/cpu/cpufreq/policy0/scaling_min_freq";
+
+    perf_controller_start(BENCH_GAME_PID);
+    touch_init(BENCH_TOUCH_STREAM);
+    int contacts = touch_wait(1);
+    long bumped = read_long(floor_node, 0);
+    touch_release();
+    long restored = read_long(floor_node, 0);
+    perf_controller_stop();
+
+    if (contacts != BENCH_TOUCH_FRAMES / BENCH_TOUCH_TAP || bumped <= restored || restored != 300000) {
+        fprintf(stderr, "touch: %d contacts, floor %ld then %ld\n", contacts, bumped, restored);
+        exit(1);
+    }
+    return BENCH_TOUCH_FRAMES;
+}
+
+static long run_preload(void) {
+    return (long)(preload_directory("bench", BENCH_PRELOAD_DIR, BENCH_PRELOAD_MB, 0) >> 20);
+}
+
+static const BenchCase cases[] = {
+    {"pidof_hit", NULL, run_pidof_hit},
+    {"pidof_miss", NULL, run_pidof_miss},
+    {"gamelist_load", setup_gamelist_load, run_gamelist_load},
+    {"gamelist_match", NULL, run_gamelist_match},
+    {"gamelist_regex", NULL, run_gamelist_regex},
+    {"write2file", NULL, run_write2file},
+    {"log_nusantara", setup_log, run_log},
+    {"profile_apply", NULL, run_profile_apply},
+    {"perf_level_walk", setup_perf_walk, run_perf_walk},
+    {"gpu_level_walk", setup_gpu_walk, run_gpu_walk},
+    {"net_parse", NULL, run_net_parse},
+    {"net_parse_sscanf", NULL, run_net_sscanf},
+    {"history_append", NULL, run_history_append},
+    {"history_query", setup_history_query, run_history_query},
+    {"executor_task", setup_executor, run_executor},
+    {"touch_replay", setup_touch, run_touch},
+    {"preload_mb", NULL, run_preload},
+};
+
+/***********************************************************************************
+ * Function Name      : rss_kb
+ * Inputs             : None
+ * Returns            : long - resident set size of this process in KB
+ * Description        : Reads the real /proc, host root is bypassed.
+ ***********************************************************************************/
+static long rss_kb(void) {
+    const char* root = host_root;
+    host_root = NULL;
+
+    long rss = -1;
+    char line[MAX_LINE];
+    FILE* fp = fopen("/proc/self/status", "r");
+    while (fp && fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "VmRSS: %ld", &rss) == 1)
+            break;
+    }
+    if (fp)
+        fclose(fp);
+
+    host_root = root;
+    return rss;
+}
+
+/***********************************************************************************
+ * Function Name      : soak_tick
+ * Inputs             : fsm (ProfileFsm *) - profile state machine
+ *                      session (GameSession *) - session boosted in performance
+ *                      tick (long) - tick number
+ * Returns            : int - number of fetched states that differ from the
+ *                            ones the fixture scripts were given
+ * Description        : One main loop round: round bookkeeping, thermal and
+ *                      controller ticks while boosted, config reload check,
+ *                      game lookup, decision and status. Every
+ *                      SOAK_SPAWN_EVERY ticks screen and battery saver state
+ *                      come through dumpsys and settings stand-ins, the real
+ *                      fork, exec and pipe read included.
+ ***********************************************************************************/
+static int soak_tick(ProfileFsm* fsm, GameSession* session, const long tick) {
+    static ProfileMode mode = NORMAL_PROFILE;
+    static ThermalState thermal = THERMAL_NORMAL;
+    static bool screen_on = true, low_power = false;
+    int mismatches = 0;
+
+    // wait_next_round
+    energy_tick(mode);
+    session_account(mode);
+    state_save(mode);
+    if (tick % SOAK_STATUS_EVERY == 0)
+        write_status(mode, fsm);
+
+    ThermalState state = thermal_tick();
+    if (mode == PERFORMANCE_PROFILE) {
+        session_thermal(state != thermal);
+        perf_controller_tick(BENCH_GAME_PID);
+    }
+    thermal = state;
+
+    // Inputs hold for a while like real sessions, so decisions do change
+    bool awake = (tick / (3 * SOAK_PHASE_TICKS)) % 7 != 0;
+    bool saver = (tick / (5 * SOAK_PHASE_TICKS)) % 3 == 2;
+    if (tick % SOAK_PHASE_TICKS == 0) {
+        write2file(SOAK_POWER_STATE, false, false, "mWakefulness=%s\nmSettingBatterySaverEnabled=%s\n",
+                   awake ? "Awake" : "Asleep", saver ? "true" : "false");
+        write2file(SOAK_LOW_POWER, false, false, "%d\n", saver);
+    }
+
+    if (tick % SOAK_SPAWN_EVERY == 0) {
+        screen_on = get_screenstate_normal();
+        low_power = get_low_power_state_normal();
+        mismatches = (screen_on != awake) + (low_power != saver);
+    }
+
+    game_config_refresh();
+
+    const char* name = names[(tick / SOAK_PHASE_TICKS) % BENCH_LOOKUPS];
+    ProfileInputs in = {.now_ms = tick * LOOP_INTERVAL * 1000,
+                        .game = game_config_match(name, strlen(name)),
+                        .game_alive = mode == PERFORMANCE_PROFILE};
+    if (in.game)
+        in.screen_on = screen_on;
+    else
+        in.low_power = low_power;
+
+    ProfileMode next = profile_fsm_step(fsm, profile_wanted(&in), in.game_alive, in.now_ms);
+    if (next != mode && (next == PERFORMANCE_PROFILE || mode == PERFORMANCE_PROFILE)) {
+        if (mode == PERFORMANCE_PROFILE)
+            perf_controller_stop();
+        session_activate(next == PERFORMANCE_PROFILE ? session : NULL);
+    }
+    mode = next;
+
+    arena_reset();
+    return mismatches;
+}
+
+/***********************************************************************************
+ * Function Name      : run_soak
+ * Inputs             : ticks (long) - ticks to run
+ * Returns            : int - 0 when RSS stayed flat, nothing was allocated and
+ *                            every fetched state matched the fixture
+ ***********************************************************************************/
+static int run_soak(const long ticks) {
+    FsmConfig config;
+    ProfileFsm fsm;
+    profile_fsm_load(&config, TRANSITION_DWELL);
+    profile_fsm_init(&fsm, &config, NORMAL_PROFILE);
+    thermal_init();
+    GameSession* session = session_open(BENCH_GAME, BENCH_GAME_PID, game_config_get(BENCH_GAME));
+
+    int mismatches = 0;
+    for (long t = 0; t < SOAK_WARMUP_TICKS; t++)
+        mismatches += soak_tick(&fsm, session, t);
+
+    long rss_start = rss_kb(), rss_peak = rss_start;
+    unsigned long allocs = host_allocs;
+    long long start = now_ns();
+
+    printf("%-12s %10s %10s\n", "tick", "rss KB", "mallocs");
+    for (long t = 0; t < ticks; t++) {
+        mismatches += soak_tick(&fsm, session, SOAK_WARMUP_TICKS + t);
+
+        if ((t + 1) % (ticks / 10 > 0 ? ticks / 10 : 1) == 0) {
+            long rss = rss_kb();
+            if (rss > rss_peak)
+                rss_peak = rss;
+            printf("%-12ld %10ld %10lu\n", t + 1, rss, host_allocs - allocs);
+        }
+    }
+
+    long long elapsed = now_ns() - start;
+    long rss_end = rss_kb();
+    allocs = host_allocs - allocs;
+
+    printf("\n%ld ticks, %.0f ns/tick, RSS %ldKB -> %ldKB (peak %ldKB), %lu mallocs, %d state mismatches\n", ticks,
+           (double)elapsed / ticks, rss_start, rss_end, rss_peak, allocs, mismatches);
+
+    if (allocs > 0 || mismatches > 0 || rss_peak - rss_start > SOAK_MAX_RSS_GROWTH_KB) {
+        printf("SOAK FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/***********************************************************************************
+ * Function Name      : run_case
+ * Inputs             : bench (const BenchCase *) - case to run
+ * Returns            : None
+ * Description        : One untimed warm-up, then reps timed repetitions. Writes
+ *                      are counted by the host root layer and must not vary.
+ ***********************************************************************************/
+static void run_case(const BenchCase* bench) {
+    double per_op[reps];
+    unsigned long writes = 0;
+    long ops = 0;
+
+    if (bench->setup)
+        bench->setup();
+    bench->run();
+
+    for (int r = 0; r < reps; r++) {
+        if (bench->setup)
+            bench->setup();
+
+        unsigned long writes_before = host_writes;
+        long long start = now_ns();
+        ops = bench->run();
+        long long elapsed = now_ns() - start;
+        writes = host_writes - writes_before;
+
+        per_op[r] = ops > 0 ? (double)elapsed / ops : (double)elapsed;
+    }
+
+    qsort(per_op, reps, sizeof(per_op[0]), compare_double);
+
+    BenchResult* result = &results[nr_results++];
+    result->name = bench->name;
+    result->median_ns = per_op[reps / 2];
+    result->min_ns = per_op[0];
+    result->writes = ops > 0 ? (double)writes / ops : (double)writes;
+
+    printf("%-16s %12.0f %12.0f %10.2f\n", result->name, result->median_ns, result->min_ns, result->writes);
+}
+
+/***********************************************************************************
+ * Function Name      : compare_baseline
+ * Inputs             : filename (const char *) - results of an earlier run
+ *                      tolerance (int) - allowed slowdown in percent
+ * Returns            : int - number of regressions
+ * Description        : Time regresses past the tolerance, write counts must
+ *                      match exactly.
+ ***********************************************************************************/
+static int compare_baseline(const char* filename, const int tolerance) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        fprintf(stderr, "Unable to open baseline %s\n", filename);
+        return 1;
+    }
+
+    int regressions = 0;
+    char line[MAX_LINE], name[64];
+    double median, writes;
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "%63s %lf %lf", name, &median, &writes) != 3)
+            continue;
+
+        for (int i = 0; i < nr_results; i++) {
+            const BenchResult* result = &results[i];
+            if (strcmp(result->name, name) != 0)
+                continue;
+
+            if (result->median_ns > median * (100 + tolerance) / 100) {
+                printf("REGRESSION %s: %.0fns/op, baseline %.0fns/op\n", name, result->median_ns, median);
+                regressions++;
+            }
+            if (result->writes - writes > 0.005 || writes - result->writes > 0.005) {
+                printf("REGRESSION %s: %.2f writes/op, baseline %.2f\n", name, result->writes, writes);
+                regressions++;
+            }
+        }
+    }
+
+    fclose(fp);
+    return regressions;
+}
+
+static int remove_entry(const char* path, const struct stat* st, int flag, struct FTW* ftw) {
+    (void)st;
+    (void)flag;
+    (void)ftw;
+    return remove(path);
+}
+
+int main(int argc, char** argv) {
+    const char* root = NULL;
+    const char* output = NULL;
+    const char* baseline = NULL;
+    int tolerance = 30;
+    long soak_ticks = 0;
+    bool keep = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:r:ko:c:t:s:")) != -1) {
+        switch (opt) {
+        case 'n':
+            reps = atoi(optarg);
+            break;
+        case 'r':
+            root = optarg;
+            break;
+        case 'k':
+            keep = true;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'c':
+            baseline = optarg;
+            break;
+        case 't':
+            tolerance = atoi(optarg);
+            break;
+        case 's':
+            soak_ticks = atol(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n reps] [-r root] [-k] [-o results] [-c baseline] [-t pct] [-s ticks]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if (reps < 1)
+        reps = 1;
+
+    static char tmp_root[] = "/tmp/nusantara_bench.XXXXXX";
+    if (!root) {
+        root = mkdtemp(tmp_root);
+        if (!root) {
+            perror("mkdtemp");
+            return 1;
+        }
+    } else {
+        mkdir(root, 0755);
+        keep = true;
+    }
+
+    // Output files are host paths, open them before the root is set
+    FILE* out = output ? fopen(output, "w") : NULL;
+
+    host_root = root;
+    fixture_build();
+
+    int failed = check_topology();
+    if (!topology_init(&cpu_topology, "")) {
+        fprintf(stderr, "Unable to read fixture topology\n");
+        return 1;
+    }
+
+    if (soak_ticks > 0) {
+        printf("\n");
+        failed += run_soak(soak_ticks);
+    } else {
+        printf("\n%-16s %12s %12s %10s\n", "case", "median ns/op", "min ns/op", "writes/op");
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+            run_case(&cases[i]);
+    }
+
+    host_root = NULL;
+
+    if (out) {
+        for (int i = 0; i < nr_results; i++)
+            fprintf(out, "%s %.0f %.2f\n", results[i].name, results[i].median_ns, results[i].writes);
+        fclose(out);
+    }
+
+    if (baseline)
+        failed += compare_baseline(baseline, tolerance);
+
+    regfree(&gamelist_regex);
+    if (!keep)
+        nftw(root, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    else
+        printf("\nFixture tree kept at %s\n", root);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host simulator for the profile decision loop.
+ *
+ * Replays a decision trace through profile_wanted() and the profile state
+ * machine, prints the resulting profile timeline and metrics. Accepts binary
+ * traces recorded by the daemon (trace_record) or synthetic text traces:
+ *
+ *   # t_ms package screen_on low_power game_alive game_bg
+ *   0      -                 1 0 0 0
+ *   15000  com.example.game  1 0 1 0
+ *
+ * "-" means no game in front.
+ */
+
+#include <nusantara.h>
+#include <stdarg.h>
+
+typedef struct {
+    ProfileInputs in;
+    char package[MAX_PACKAGE];
+} SimRound;
+
+typedef struct {
+    long time_in[PROFILE_MODE_MAX];
+    long latency_sum;
+    long latency_max;
+    int detections;
+    int switches;
+} SimMetrics;
+
+static bool verbose = false;
+
+void log_nusantara(LogLevel level, const char* message, ...) {
+    if (!verbose && level < LOG_WARN)
+        return;
+
+    va_list args;
+    va_start(args, message);
+    vfprintf(stderr, message, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+char* trim_newline(char* string) {
+    if (string)
+        string[strcspn(string, "\r\n")] = '\0';
+    return string;
+}
+
+/***********************************************************************************
+ * Function Name      : read_binary
+ * Inputs             : fp (FILE *) - trace positioned after the header
+ *                      round (SimRound *) - receives next round
+ *                      names (char (*)[MAX_PACKAGE]) - package names by id
+ * Returns            : bool - false at end of trace
+ ***********************************************************************************/
+static bool read_binary(FILE* fp, SimRound* round, char (*names)[MAX_PACKAGE]) {
+    TraceRecord record;
+
+    while (fread(&record, sizeof(record), 1, fp) == 1) {
+        if (record.kind == TRACE_PACKAGE) {
+            uint8_t len;
+            if (fread(&len, sizeof(len), 1, fp) != 1 || len >= MAX_PACKAGE || record.package == 0 ||
+                record.package > TRACE_MAX_PACKAGES)
+                return false;
+            char* name = names[record.package - 1];
+            if (fread(name, 1, len, fp) != len)
+                return false;
+            name[len] = '\0';
+            continue;
+        }
+
+        memset(round, 0, sizeof(*round));
+        round->in.now_ms = record.t_ms;
+        round->in.game = record.package != 0;
+        round->in.screen_on = record.flags & TRACE_SCREEN_ON;
+        round->in.low_power = record.flags & TRACE_LOW_POWER;
+        round->in.game_alive = record.flags & TRACE_GAME_ALIVE;
+        round->in.game_bg = record.flags & TRACE_GAME_BG;
+        if (round->in.game && record.package <= TRACE_MAX_PACKAGES)
+            snprintf(round->package, sizeof(round->package), "%s", names[record.package - 1]);
+        return true;
+    }
+
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : read_text
+ * Inputs             : fp (FILE *) - text trace
+ *                      round (SimRound *) - receives next round
+ * Returns            : bool - false at end of trace
+ ***********************************************************************************/
+static bool read_text(FILE* fp, SimRound* round) {
+    char line[MAX_LINE];
+
+    while (fgets(line, sizeof(line), fp)) {
+        long t_ms;
+        char package[MAX_PACKAGE];
+        int screen, low_power, alive, bg;
+
+        if (line[0] == '#' || sscanf(line, "%ld %127s %d %d %d %d", &t_ms, package, &screen, &low_power, &alive, &bg) != 6)
+            continue;
+
+        memset(round, 0, sizeof(*round));
+        round->in.now_ms = t_ms;
+        round->in.game = strcmp(package, "-") != 0;
+        round->in.screen_on = screen;
+        round->in.low_power = low_power;
+        round->in.game_alive = alive;
+        round->in.game_bg = bg;
+        if (round->in.game)
+            snprintf(round->package, sizeof(round->package), "%s", package);
+        return true;
+    }
+
+    return false;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [-c transition_dwell] [-g grace_ms] [-x speed] [-v] <trace>\n"
+            "  -c  dwell config, same format as on device\n"
+            "  -g  override grace period\n"
+            "  -x  replay at speed times real time, default as fast as possible\n"
+            "  -v  print every round\n",
+            prog);
+}
+
+int main(int argc, char* argv[]) {
+    const char* config_file = NULL;
+    long grace_ms = -1;
+    double speed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:g:x:v")) != -1) {
+        switch (opt) {
+        case 'c':
+            config_file = optarg;
+            break;
+        case 'g':
+            grace_ms = atol(optarg);
+            break;
+        case 'x':
+            speed = atof(optarg);
+            break;
+        case 'v':
+            verbose = true;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* fp = fopen(argv[optind], "rb");
+    if (!fp) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    TraceHeader header;
+    bool binary = fread(&header, sizeof(header), 1, fp) == 1 && memcmp(header.magic, TRACE_MAGIC, 4) == 0;
+    if (binary && (header.version != TRACE_VERSION || header.record_size != sizeof(TraceRecord))) {
+        fprintf(stderr, "Unsupported trace version %d\n", header.version);
+        fclose(fp);
+        return EXIT_FAILURE;
+    }
+    if (!binary)
+        rewind(fp);
+
+    FsmConfig config;
+    profile_fsm_load(&config, config_file ? config_file : "");
+    if (grace_ms >= 0)
+        config.grace_ms = grace_ms;
+
+    ProfileFsm fsm;
+    profile_fsm_init(&fsm, &config, PERFCOMMON);
+
+    static char names[TRACE_MAX_PACKAGES][MAX_PACKAGE];
+    SimMetrics metrics = {0};
+    SimRound round;
+    long prev_ms = -1;
+    long want_since = -1;
+    ProfileMode prev = PERFCOMMON;
+
+    printf("%10s  %-11s  %s\n", "t_ms", "profile", "game");
+    while (binary ? read_binary(fp, &round, names) : read_text(fp, &round)) {
+        if (prev_ms >= 0) {
+            metrics.time_in[prev] += round.in.now_ms - prev_ms;
+            if (speed > 0)
+                usleep((useconds_t)((round.in.now_ms - prev_ms) * 1000 / speed));
+        }
+        prev_ms = round.in.now_ms;
+
+        ProfileMode wanted = profile_wanted(&round.in);
+        ProfileMode next = profile_fsm_step(&fsm, wanted, round.in.game_alive, round.in.now_ms);
+
+        // Detection latency counts from first round asking for performance
+        if (wanted == PERFORMANCE_PROFILE && prev != PERFORMANCE_PROFILE && want_since < 0)
+            want_since = round.in.now_ms;
+        if (wanted != PERFORMANCE_PROFILE)
+            want_since = -1;
+
+        if (verbose)
+            printf("%10ld  %-11s  %s (wanted %s)\n", round.in.now_ms, profile_mode_name[next], round.package,
+                   profile_mode_name[wanted]);
+
+        if (next == prev)
+            continue;
+
+        if (next == PERFORMANCE_PROFILE && want_since >= 0) {
+            long latency = round.in.now_ms - want_since;
+            metrics.latency_sum += latency;
+            if (latency > metrics.latency_max)
+                metrics.latency_max = latency;
+            metrics.detections++;
+            want_since = -1;
+        }
+
+        if (prev != PERFCOMMON)
+            metrics.switches++;
+
+        if (!verbose)
+            printf("%10ld  %-11s  %s\n", round.in.now_ms, profile_mode_name[next], round.package);
+        prev = next;
+    }
+
+    fclose(fp);
+
+    printf("\nswitches=%d\n", metrics.switches);
+    printf("suppressed=%d\n", fsm.nr_suppressed);
+    printf("detections=%d\n", metrics.detections);
+    printf("detection_latency_avg_ms=%ld\n", metrics.detections ? metrics.latency_sum / metrics.detections : 0);
+    printf("detection_latency_max_ms=%ld\n", metrics.latency_max);
+    for (int p = PERFORMANCE_PROFILE; p < PROFILE_MODE_MAX; p++)
+        printf("time_%s_ms=%ld\n", profile_mode_name[p], metrics.time_in[p]);
+
+    return EXIT_SUCCESS;
+}
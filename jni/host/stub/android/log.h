@@ -0,0 +1,4 @@
+/*
+ * Host build stand-in, the daemon logs to its own file and never calls liblog.
+ */
+#pragma once
@@ -0,0 +1,14 @@
+/*
+ * Host build stand-in for the bionic property API. host_props.c implements
+ * an empty property area, host runs use the boot stand-in file instead.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define PROP_VALUE_MAX 92
+
+typedef struct prop_info prop_info;
+
+int __system_property_get(const char* name, char* value);
+const prop_info* __system_property_find(const char* name);
@@ -3,16 +3,29 @@
 
 #include <ctype.h>
 #include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <sched.h>
+#include <stdalign.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
 #include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include <sys/time.h>
 #include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
 
 #define LOOP_INTERVAL 15
+#define CONTROL_INTERVAL_MS 500
+#define PERF_DOWN_SAMPLES 6
 #define MAX_DATA_LENGTH 1024
 #define MAX_COMMAND_LENGTH 600
 #define MAX_OUTPUT_LENGTH 256
@@ -20,26 +33,182 @@
 
 #define MAX_LINE 512
 #define MAX_PACKAGE 128
+#define MAX_BOOSTED_THREADS 256
+#define MAX_CLUSTERS 8
+#define MAX_CLUSTER_FREQS 64
+#define MAX_GAME_THREAD_PATTERNS 8
+#define MAX_SECONDARY_PROCS 4
+#define MAX_GAME_SESSIONS 4
+#define TICK_ARENA_SIZE (16 << 10)
 
 #define NOTIFY_TITLE "Nusantara Tweaks"
 #define LOG_TAG "NusantaraTweaks"
 
+#define MODULE_CONFIG "/data/adb/.config/Nusantara"
 #define LOCK_FILE "/data/adb/.config/Nusantara/.lock"
 #define LOG_FILE "/data/adb/.config/Nusantara/nusantara.log"
 #define PROFILE_MODE "/data/adb/.config/Nusantara/current_profile"
 #define GAME_INFO "/data/adb/.config/Nusantara/gameinfo"
 #define GAMELIST "/data/adb/.config/Nusantara/gamelist.txt"
+#define GAME_CONFIG "/data/adb/.config/Nusantara/gameconfig.txt"
+#define CPU_TOPOLOGY "/data/adb/.config/Nusantara/cpu_topology"
+#define CGROUP_PLACEMENT "/data/adb/.config/Nusantara/cgroup_placement"
+#define APP_FREEZER "/data/adb/.config/Nusantara/app_freezer"
+#define FREEZE_BUDGET "/data/adb/.config/Nusantara/freeze_budget"
+#define FREEZE_WHITELIST "/data/adb/.config/Nusantara/freeze_whitelist"
+#define TRANSITION_DWELL "/data/adb/.config/Nusantara/transition_dwell"
+#define TRACE_RECORD "/data/adb/.config/Nusantara/trace_record"
+#define SESSION_HISTORY "/data/adb/.config/Nusantara/session_history"
+#define DECISION_TRACE "/data/adb/.config/Nusantara/decision.trace"
+#define SOC_RECOGNITION "/data/adb/.config/Nusantara/soc_recognition"
+#define GPU_CONTROLLER "/data/adb/.config/Nusantara/gpu_controller"
+#define IO_BOOST "/data/adb/.config/Nusantara/io_boost"
+#define NET_MONITOR "/data/adb/.config/Nusantara/net_monitor"
+#define IRQ_AFFINITY "/data/adb/.config/Nusantara/irq_affinity"
+#define RETAIN_GRACE "/data/adb/.config/Nusantara/retain_grace"
+#define RETAIN_WARM "/data/adb/.config/Nusantara/retain_warm"
+#define LAUNCH_BOOST "/data/adb/.config/Nusantara/launch_boost"
+#define TOUCH_BOOST "/data/adb/.config/Nusantara/touch_boost"
+#define TOUCH_BOOST_MS "/data/adb/.config/Nusantara/touch_boost_ms"
+#define TOUCH_BOOST_FLOOR "/data/adb/.config/Nusantara/touch_boost_floor"
+#define DAEMON_STATUS "/data/adb/.config/Nusantara/daemon_status"
+#define DAEMON_STATE "/data/adb/.config/Nusantara/daemon_state"
 #define MODULE_PROP "/data/adb/modules/nusantara/module.prop"
 #define MODULE_UPDATE "/data/adb/modules/nusantara/update"
 
+#define BOOT_ID_PATH "/proc/sys/kernel/random/boot_id"
+#define BATTERY_SUPPLY "/sys/class/power_supply/battery"
+#define PPM_ENABLED "/proc/ppm/enabled"
+
+// Startup, the stand-in file replaces sys.boot_completed when set in the environment
+#define BOOT_STAND_IN_ENV "NUSANTARA_BOOT_FILE"
+#define BOOT_POLL_MS 1000
+#define MAX_INDEXED_PACKAGES 2048
+
+#define PSI_MEMORY_PATH "/proc/pressure/memory"
+#define PSI_IO_PATH "/proc/pressure/io"
+
+// Preload pressure tuning
+#define PRELOAD_CHUNK_SIZE (2 << 20)
+#define PRELOAD_MAX_DEPTH 4
+#define PRELOAD_RESERVE_MB 600
+#define PRELOAD_SETTLE_MS 250
+#define PRELOAD_PAUSE_MS (PRELOAD_PSI_WINDOW_US / 1000 + 100)  // triggers fire once per window at most
+#define PRELOAD_MAX_PAUSE_MS 3000
+#define PRELOAD_MAX_CHUNK_DELAY_US 50000
+#define PRELOAD_ABORT_FULL_AVG10 5.0f
+#define PRELOAD_PSI_STALL_US 100000
+#define PRELOAD_PSI_WINDOW_US 1000000
+
+// Cgroup placement during performance profile
+#define CGROUP_V2_ROOT "/sys/fs/cgroup"
+#define CGROUP_GAME_NAME "nusantara_game"
+#define CGROUP_BG_NAME "nusantara_bg"
+#define CGROUP_GAME_UCLAMP_MIN 30
+#define CGROUP_GAME_WEIGHT 1000
+#define CGROUP_GAME_STUNE_BOOST 10
+#define CGROUP_BG_WEIGHT 20
+#define CGROUP_BG_UCLAMP_MAX 50
+#define CGROUP_BG_MIN_OOM_ADJ 700
+#define FIRST_APPLICATION_UID 10000
+
+// Background app freezer
+#define FREEZER_MIN_OOM_ADJ 900
+#define FREEZER_DEFAULT_BUDGET_MB 1024
+
+// Leaving performance while the game lives waits this long by default
+#define FSM_DEFAULT_GRACE_MS 30000
+
+// Decision trace, fixed size records after a header
+#define TRACE_MAGIC "NTRC"
+#define TRACE_VERSION 1
+#define TRACE_MAX_BYTES (1 << 20)
+#define TRACE_MAX_PACKAGES 64
+#define TRACE_ROUND 0
+#define TRACE_PACKAGE 1
+#define TRACE_SCREEN_ON (1 << 0)
+#define TRACE_LOW_POWER (1 << 1)
+#define TRACE_GAME_ALIVE (1 << 2)
+#define TRACE_GAME_BG (1 << 3)
+
+// Session history, fixed size ring of records after a header
+#define HISTORY_MAGIC "NHST"
+#define HISTORY_VERSION 1
+#define HISTORY_CAPACITY 4096
+#define HISTORY_PACKAGE 64
+#define HISTORY_CLUSTERS 4
+#define HISTORY_DEFAULT_DAYS 30
+
+// Game counts as background once ranked below perceptible apps
+#define GAME_BG_MIN_OOM_ADJ 200
+
+// A visible game hides PiP and split-screen neighbours, foreground is still queried now and then
+#define GAME_RECHECK_ROUNDS 2
+#define MAX_VISIBLE_GAMES 4
+
+// Thermal headroom, margins in degree below the throttle trip
+#define THERMAL_WARM_MARGIN 8
+#define THERMAL_HOT_MARGIN 3
+#define THERMAL_WARM_HEADROOM_S 120
+#define THERMAL_HOT_HEADROOM_S 30
+#define THERMAL_STEP_TICKS 4
+
+// GPU floor controller
+#define MAX_GPU_FREQS 32
+#define KGSL_ROOT "/sys/class/kgsl/kgsl-3d0"
+#define GED_HAL_ROOT "/sys/kernel/ged/hal"
+#define DEVFREQ_ROOT "/sys/class/devfreq"
+
+// Loading phase I/O boost on the block queues behind /data
+#define MAX_IO_QUEUES 4
+#define IO_MAX_STACK_DEPTH 4
+#define IO_BURST_START_KBPS 8192
+#define IO_BURST_SETTLE_KBPS 1024
+#define IO_SETTLE_TICKS 4
+#define IO_BOOST_READ_AHEAD_KB 2048
+#define IO_BOOST_NR_REQUESTS 256
+
+// Network latency mode while the game plays online
+#define NET_SAMPLE_TICKS 4
+#define NET_IDLE_SAMPLES 5
+#define NET_ACTIVE_PPS 20
+#define NET_RT_MAX_PACKET 600
+
+// IRQ steering during performance profile
+#define MAX_MANAGED_IRQS 64
+#define IRQ_SAMPLE_TICKS 4
+
+// Retention of a game that left foreground, adj sits between perceptible and backup
+#define RETAIN_DEFAULT_GRACE_S 300
+#define RETAIN_OOM_ADJ 250
+#define RETAIN_PSI_RELEASE 10.0f
+#define RETAIN_WARM_ROUNDS 4
+#define RETAIN_WARM_BUDGET_MB 64
+
+// Task executor, fixed pool with one running task per lane
+#define EXECUTOR_THREADS 3
+#define MAX_TASKS 32
+#define MAX_TASK_TEXT MAX_PATH_LENGTH
+
+// Launch boost, from zygote specialization until the game reaches foreground
+#define LAUNCH_FLOOR_PCT 65
+#define LAUNCH_PRELOAD_MB 128
+#define LAUNCH_TIMEOUT_MS 10000
+#define LAUNCH_POLL_MS 1000
+
+// Touch boost, short floor bump on contact while a game is boosted
+#define INPUT_DEV_ROOT "/dev/input"
+#define TOUCH_STAND_IN_ENV "NUSANTARA_TOUCH_FILE"
+#define TOUCH_DEFAULT_BOOST_MS 250
+#define TOUCH_DEFAULT_FLOOR_PCT 50
+#define TOUCH_MAX_HOLD_MS 2000
+#define TOUCH_COOLDOWN_MS 250
+#define TOUCH_STALE_MS 100
+
 #define MY_PATH                                                                                                                    \
     "PATH=/system/bin:/system/xbin:/data/adb/ap/bin:/data/adb/ksu/bin:/data/adb/magisk:/debug_ramdisk:/sbin:/sbin/su:/su/bin:/su/" \
     "xbin:/data/data/com.termux/files/usr/bin"
 
-#define IS_MLBB(gamestart)                                                                               \
-    (strcmp(gamestart, "com.mobile.legends") == 0 || strcmp(gamestart, "com.mobilelegends.hwag") == 0 || \
-     strcmp(gamestart, "com.mobiin.gp") == 0 || strcmp(gamestart, "com.mobilechess.gp") == 0)
-
 #define IS_AWAKE(state) (strcmp(state, "Awake") == 0 || strcmp(state, "true") == 0)
 #define IS_LOW_POWER(state) (strcmp(state, "true") == 0 || strcmp(state, "1") == 0)
 
@@ -56,16 +225,270 @@ typedef enum : char {
     PERFCOMMON,
     PERFORMANCE_PROFILE,
     NORMAL_PROFILE,
-    POWERSAVE_PROFILE
+    POWERSAVE_PROFILE,
+    PROFILE_MODE_MAX
 } ProfileMode;
 
+typedef struct {
+    long dwell_ms[PROFILE_MODE_MAX][PROFILE_MODE_MAX];
+    long grace_ms;
+} FsmConfig;
+
+// Everything profile decision depends on, no I/O behind it
+typedef struct {
+    long now_ms;
+    bool game;
+    bool screen_on;
+    bool low_power;
+    bool game_bg;
+    bool game_alive;
+} ProfileInputs;
+
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+} TraceHeader;
+
+// TRACE_PACKAGE records are followed by uint8_t length and the package name
+typedef struct {
+    uint32_t t_ms;
+    uint8_t kind;
+    uint8_t flags;
+    uint16_t package;
+} TraceRecord;
+
+typedef struct {
+    FsmConfig config;
+    ProfileMode current;
+    ProfileMode pending;
+    long pending_since_ms;
+    long last_change_ms;
+    int nr_transitions;
+    int nr_suppressed;
+    int suppressed[PROFILE_MODE_MAX][PROFILE_MODE_MAX];
+} ProfileFsm;
+
+typedef enum : char {
+    PSI_MEMORY,
+    PSI_IO,
+    PSI_MAX
+} PsiResource;
+
+typedef struct {
+    float some_avg10;
+    float full_avg10;
+} PsiStat;
+
+typedef struct {
+    int fd[PSI_MAX];
+} PsiMonitor;
+
+typedef enum : char {
+    THREAD_CLASS_NONE,
+    THREAD_MAIN,
+    THREAD_RENDER,
+    THREAD_AUDIO,
+    THREAD_WORKER,
+    THREAD_CLASS_MAX
+} ThreadClass;
+
+typedef struct {
+    char pattern[16];
+    ThreadClass cls;
+} ThreadPattern;
+
+typedef enum : char {
+    GAME_BG_AUTO,
+    GAME_BG_NEVER,
+    GAME_BG_RENDER_MISSING,
+    GAME_BG_OOM_ADJ
+} GameBgIndicator;
+
+typedef struct {
+    char governor[32];
+    int floor_pct;
+    bool preload;
+    long preload_budget_mb;
+    bool cgroup;
+    ThreadPattern threads[MAX_GAME_THREAD_PATTERNS];
+    int nr_threads;
+    char secondary[MAX_SECONDARY_PROCS][MAX_PACKAGE];
+    int nr_secondary;
+    char render[MAX_PACKAGE];
+    GameBgIndicator background;
+} GameProfile;
+
+typedef enum : char {
+    THERMAL_CPU,
+    THERMAL_GPU,
+    THERMAL_SKIN,
+    THERMAL_CLASS_MAX
+} ThermalClass;
+
+typedef struct {
+    char package[MAX_PACKAGE];
+    pid_t pid;
+    pid_t main_pid;
+    int uid;
+    time_t started;
+    time_t last_active;
+    int switches;
+    bool active;
+    bool preloaded;
+    long long energy_mj;   // metered while boosted
+    long long metered_ms;
+    long boost_ms;         // detection to applied profile, first boost only
+    long preload_ms;
+    size_t preload_bytes;
+    long long profile_ms[PROFILE_MODE_MAX];
+    unsigned long long freq_weight[HISTORY_CLUSTERS];  // while boosted, as in energy meter
+    unsigned long long freq_time[HISTORY_CLUSTERS];
+    int peak_temp[THERMAL_CLASS_MAX];  // millidegree
+    int thermal_steps;
+    GameProfile profile;
+} GameSession;
+
+// Lanes in priority order, a free worker takes the highest one first
+typedef enum : char {
+    TASK_PROFILE,
+    TASK_BOOST,
+    TASK_PRELOAD,
+    TASK_NOTIFY,
+    TASK_PRIORITY_MAX
+} TaskPriority;
+
+typedef struct Task Task;
+
+struct Task {
+    void (*run)(Task* task);
+    void (*done)(const Task* task);  // on main loop via executor_reap, may be NULL
+    TaskPriority priority;
+    pid_t pid;
+    long value;
+    long result;
+    long elapsed_ms;
+    char package[MAX_PACKAGE];       // cancellation key
+    char text[MAX_TASK_TEXT];
+    bool has_profile;
+    GameProfile profile;
+};
+
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t capacity;
+    uint32_t head;         // slot the next record goes to
+    uint32_t count;
+} HistoryHeader;
+
+typedef struct {
+    char package[HISTORY_PACKAGE];  // not terminated at full length
+    uint32_t start;        // wall clock seconds
+    uint32_t end;
+    uint32_t boost_ms;
+    uint32_t preload_ms;
+    uint32_t preload_kb;
+    uint32_t profile_s[PROFILE_MODE_MAX];
+    uint16_t cluster_mhz[HISTORY_CLUSTERS];
+    int16_t peak_temp[THERMAL_CLASS_MAX];  // decidegree
+    uint16_t thermal_steps;
+} HistoryRecord;
+
+typedef enum : char {
+    AFFINITY_ALL,
+    AFFINITY_PERF,
+    AFFINITY_PRIME,
+    AFFINITY_MAX
+} ThreadAffinity;
+
+typedef enum : char {
+    CLUSTER_LITTLE,
+    CLUSTER_MID,
+    CLUSTER_BIG,
+    CLUSTER_PRIME,
+    CLUSTER_TYPE_MAX
+} ClusterType;
+
+typedef struct {
+    int policy;
+    int cluster_id;
+    ClusterType type;
+    cpu_set_t cpus;
+    int nr_cpus;
+    long capacity;
+    long min_freq;
+    long max_freq;
+    long freqs[MAX_CLUSTER_FREQS];
+    int nr_freqs;
+} CpuCluster;
+
+typedef struct {
+    CpuCluster cluster[MAX_CLUSTERS];
+    int nr_clusters;
+    int nr_cpus;
+    cpu_set_t all;
+    cpu_set_t mask[CLUSTER_TYPE_MAX];
+    cpu_set_t affinity[AFFINITY_MAX];
+} CpuTopology;
+
+typedef enum : char {
+    CGROUP_NONE,
+    CGROUP_V2,
+    CGROUP_LEGACY
+} CgroupBackend;
+
+typedef enum : char {
+    PERF_LEVEL_LIGHT,
+    PERF_LEVEL_MEDIUM,
+    PERF_LEVEL_HEAVY,
+    PERF_LEVEL_MAX
+} PerfLevel;
+
 typedef enum : char {
-    MLBB_NOT_RUNNING,
-    MLBB_RUN_BG,
-    MLBB_RUNNING
-} MLBBState;
+    GPU_NONE,
+    GPU_ADRENO,
+    GPU_MALI_MTK,
+    GPU_DEVFREQ,
+    GPU_BACKEND_MAX
+} GpuBackend;
+
+typedef enum : char {
+    IRQ_TOUCH,
+    IRQ_GPU,
+    IRQ_STORAGE,
+    IRQ_MODEM,
+    IRQ_CLASS_MAX
+} IrqClass;
+
+typedef enum : char {
+    THERMAL_NORMAL,
+    THERMAL_WARM,
+    THERMAL_HOT,
+    THERMAL_CRITICAL,
+    THERMAL_STATE_MAX
+} ThermalState;
+
+typedef enum : char {
+    GAME_NO_RULE,
+    GAME_RUN_BG,
+    GAME_RUNNING
+} GameState;
+
+typedef struct {
+    char boot_id[40];
+    ProfileMode mode;
+    char game[MAX_PACKAGE];
+    pid_t pid;
+} DaemonState;
 
 extern char* gamestart;
+extern CpuTopology cpu_topology;
+extern const char* cluster_type_name[CLUSTER_TYPE_MAX];
+extern const char* perf_level_name[PERF_LEVEL_MAX + 1];
+extern const char* thread_class_name[THREAD_CLASS_MAX];
+extern const char* profile_mode_name[PROFILE_MODE_MAX];
 extern char* custom_log_tag;
 extern pid_t game_pid;
 
@@ -78,9 +501,23 @@ void is_kanged(void);
 char* timern(void);
 bool return_true(void);
 bool return_false(void);
+bool get_meminfo(long* mem_total_mb, long* mem_avail_mb);
 
 // NPreload
-extern void NusantaraPreload(const char* package);
+extern size_t NusantaraPreload(const char* package, const long budget_mb);
+size_t preload_directory(const char* label, const char* target, const long budget_mb, const int settle_ms);
+
+// PSI Monitor
+bool psi_available(void);
+bool psi_read(const PsiResource resource, PsiStat* stat);
+bool psi_monitor_open(PsiMonitor* mon, const long stall_us, const long window_us);
+int psi_monitor_wait(PsiMonitor* mon, const int timeout_ms);
+void psi_monitor_close(PsiMonitor* mon);
+
+// Tick Arena
+char* arena_strndup(const char* string, const size_t len);
+void arena_reset(void);
+void arena_status(FILE* fp);
 
 // Shell and Command execution
 char* execute_command(const char* format, ...);
@@ -90,24 +527,188 @@ int systemv(const char* format, ...);
 // File Utilities
 int create_lock_file(void);
 int write2file(const char* filename, const bool append, const bool use_flock, const char* data, ...);
+bool is_enabled(const char* filename);
+long read_long(const char* filename, const long fallback);
 
 // Logging system
 void log_nusantara(LogLevel level, const char* message, ...);
 void external_log(LogLevel level, const char* tag, const char* message);
 
 // Process Utilities
-void set_priority(const pid_t pid);
 pid_t pidof(const char* name);
 int uidof(pid_t pid);
 
-// MLBB Handler
-extern pid_t mlbb_pid;
-MLBBState handle_mlbb(const char* gamestart);
+// CPU Topology
+bool topology_init(CpuTopology* topo, const char* root);
+int parse_cpu_list(const char* list, cpu_set_t* set);
+char* format_cpu_list(const cpu_set_t* set, char* out, const size_t len);
+const CpuCluster* topology_cluster(const ClusterType type);
+int topology_dump(const CpuTopology* topo, const char* filename);
+const cpu_set_t* affinity_mask(const ThreadAffinity affinity);
+
+// Cgroup Manager
+bool cgroup_init(void);
+int cgroup_place_game(const pid_t pid);
+void cgroup_restore(void);
+unsigned int cgroup_generation(void);
+void cgroup_save(FILE* fp);
+void cgroup_adopt(const char* key, const char* value);
+
+// App Freezer
+void freeze_background_apps(const int game_uid);
+void thaw_background_apps(void);
+int app_freezer_recheck(void);
+bool app_freezer_active(void);
+unsigned int app_freezer_generation(void);
+void app_freezer_save(FILE* fp);
+void app_freezer_adopt(const char* cgroup);
+
+// Thread Booster
+int boost_game_threads(const pid_t pid);
+bool boost_secondary_process(const pid_t pid);
+void unboost_game_threads(void);
+void set_boost_uclamp_cap(const int cap);
+void set_boost_game_patterns(const ThreadPattern* patterns, const int count);
+
+// Performance Controller
+void perf_controller_start(const pid_t pid);
+bool perf_controller_tick(const pid_t pid);
+void perf_controller_stop(void);
+PerfLevel perf_controller_level(void);
+void perf_controller_touch(const int pct);
+
+// Thermal Monitor
+int thermal_init(void);
+ThermalState thermal_tick(void);
+PerfLevel thermal_level_cap(void);
+int thermal_temp(const ThermalClass cls);
+void thermal_status(FILE* fp);
+
+// GPU Controller
+GpuBackend gpu_init(void);
+void gpu_controller_start(const char* package);
+void gpu_controller_tick(void);
+void gpu_controller_stop(void);
+void gpu_controller_touch(const int pct);
+void gpu_status(FILE* fp);
+
+// I/O Booster
+int io_boost_init(void);
+void io_boost_start(const pid_t pid);
+void io_boost_tick(void);
+void io_boost_stop(void);
+void io_boost_status(FILE* fp);
+
+// Network Monitor
+int net_game_flows(const int uid);
+void net_monitor_hold(void);
+void net_monitor_start(const int uid);
+void net_monitor_tick(void);
+void net_monitor_stop(void);
+void net_monitor_status(FILE* fp);
+
+// IRQ Manager
+int irq_init(void);
+void irq_steer(void);
+void irq_tick(void);
+void irq_restore(void);
+unsigned int irq_generation(void);
+void irq_save(FILE* fp);
+void irq_adopt(const char* value);
+void irq_status(FILE* fp);
+
+// Profile State Machine
+ProfileMode profile_wanted(const ProfileInputs* in);
+void profile_fsm_init(ProfileFsm* fsm, const FsmConfig* config, const ProfileMode initial);
+ProfileMode profile_fsm_step(ProfileFsm* fsm, const ProfileMode wanted, const bool game_alive, const long now_ms);
+void profile_fsm_force(ProfileFsm* fsm, const ProfileMode mode);
+void profile_fsm_load(FsmConfig* config, const char* filename);
+void profile_fsm_status(const ProfileFsm* fsm, FILE* fp);
+
+// Trace Recorder
+bool trace_open(const char* filename);
+void trace_record(const ProfileInputs* in, const char* package);
+void trace_close(void);
+
+// Energy Meter
+void energy_tick(const ProfileMode mode);
+void energy_status(FILE* fp);
+
+// Daemon Status
+void write_status(const ProfileMode mode, const ProfileFsm* fsm);
+
+// Daemon State
+void state_save(const ProfileMode mode);
+bool state_restore(DaemonState* state);
+
+// Boot Wait
+bool wait_boot_completed(const char* stand_in, const long timeout_ms);
+
+// Package Index
+int package_index_build(void);
+bool package_index_find(const char* package, char* out, const size_t len);
+bool package_lib_dir(const char* package, char* out, const size_t len);
+
+// Game Config
+bool game_config_refresh(void);
+bool game_config_match(const char* name, const size_t len);
+const GameProfile* game_config_get(const char* package);
+void game_config_apply(const GameProfile* profile);
+
+// Game Sessions
+GameSession* session_find(const char* package);
+GameSession* session_active(void);
+GameSession* session_open(const char* package, const pid_t pid, const GameProfile* profile);
+void session_activate(GameSession* session);
+bool session_prune(void);
+bool session_on_screen(const GameSession* session);
+void session_publish(const bool in_game);
+void session_account(const ProfileMode mode);
+void session_thermal(const bool stepped);
+void session_status(FILE* fp);
+
+// Session History
+bool history_append(const char* filename, const HistoryRecord* record);
+int history_query(const char* filename, FILE* out, const long days, const char* package);
+int history_main(const int argc, char** argv);
+
+// Game Retention
+void retention_start(const GameSession* session);
+void retention_tick(void);
+void retention_resume(const GameSession* session, const bool cached);
+void retention_status(FILE* fp);
+
+// Task Executor
+int executor_start(void);
+bool executor_submit(const Task* task);
+int executor_cancel(const char* package);
+bool task_cancelled(void);
+bool executor_busy(const TaskPriority lane);
+void executor_wait(const TaskPriority lane);
+int executor_reap(void);
+void executor_status(FILE* fp);
+
+// Launch Boost
+bool launch_init(void);
+bool launch_wait(const int timeout_ms);
+bool launch_poll(void);
+void launch_tick(void);
+void launch_handover(const GameSession* session);
+void launch_status(FILE* fp);
+
+// Touch Booster
+bool touch_init(const char* stand_in);
+int touch_wait(const int timeout_ms);
+void touch_release(void);
+void touch_status(FILE* fp);
+
+// Game Rules
+GameState resolve_game_process(const char* package, const GameProfile* profile, pid_t* pid);
 
 // Nusantara Profiler
 extern bool (*get_screenstate)(void);
 extern bool (*get_low_power_state)(void);
-char* get_gamestart(void);
+bool get_gamestart(char* out, const size_t len);
 bool get_screenstate_normal(void);
 bool get_low_power_state_normal(void);
 void run_profiler(const int profile);
@@ -16,9 +16,21 @@
 
 #include <nusantara.h>
 #include <libgen.h>
+#include <pthread.h>
 
+// Points into gamestart_buf while a game is visible, owned by main loop only
 char* gamestart = NULL;
+static char gamestart_buf[MAX_PACKAGE];
 pid_t game_pid = 0;
+static bool use_cgroup = false;
+static ProfileFsm profile_fsm;
+
+// Session waiting for its profile to be applied before controllers attach
+static char attach_pending[MAX_PACKAGE] = {0};
+static long attach_seen_ms = 0;
+
+// Rounds the active game skipped the foreground query for
+static int onscreen_rounds = 0;
 
 int is_file_empty(const char *filename) {
     FILE *file = fopen(filename, "rb");
@@ -43,6 +55,436 @@ int is_file_empty(const char *filename) {
     return 0;
 }
 
+/***********************************************************************************
+ * Function Name      : now_ms
+ * Inputs             : None
+ * Returns            : long - monotonic time in milliseconds
+ ***********************************************************************************/
+static long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/***********************************************************************************
+ * Function Name      : profile_task
+ * Inputs             : task (Task *) - profile and optional game overrides
+ * Returns            : None
+ ***********************************************************************************/
+static void profile_task(Task* task) {
+    run_profiler((int)task->value);
+    if (task->has_profile)
+        game_config_apply(&task->profile);
+}
+
+/***********************************************************************************
+ * Function Name      : boost_task
+ * Inputs             : task (Task *) - game PID and its overrides
+ * Returns            : None
+ ***********************************************************************************/
+static void boost_task(Task* task) {
+    const GameProfile* profile = &task->profile;
+
+    // Main thread is classified and snapshotted by the thread booster like any other
+    boost_game_threads(task->pid);
+    for (int i = 0; i < profile->nr_secondary; i++) {
+        pid_t pid = pidof(profile->secondary[i]);
+        if (pid != 0)
+            boost_secondary_process(pid);
+    }
+    if (use_cgroup && profile->cgroup)
+        cgroup_place_game(task->pid);
+}
+
+/***********************************************************************************
+ * Function Name      : freeze_task
+ * Inputs             : task (Task *) - game UID
+ * Returns            : None
+ ***********************************************************************************/
+static void freeze_task(Task* task) {
+    freeze_background_apps((int)task->value);
+}
+
+/***********************************************************************************
+ * Function Name      : preload_task
+ * Inputs             : task (Task *) - game package and preload budget
+ * Returns            : None
+ ***********************************************************************************/
+static void preload_task(Task* task) {
+    task->result = (long)NusantaraPreload(task->package, task->value);
+}
+
+/***********************************************************************************
+ * Function Name      : preload_done
+ * Inputs             : task (const Task *) - finished preload
+ * Returns            : None
+ ***********************************************************************************/
+static void preload_done(const Task* task) {
+    GameSession* session = session_find(task->package);
+    if (!session)
+        return;
+
+    session->preload_bytes = (size_t)task->result;
+    session->preload_ms = task->elapsed_ms;
+}
+
+/***********************************************************************************
+ * Function Name      : toast_task
+ * Inputs             : task (Task *) - message
+ * Returns            : None
+ ***********************************************************************************/
+static void toast_task(Task* task) {
+    toast(task->text);
+}
+
+/***********************************************************************************
+ * Function Name      : post_toast
+ * Inputs             : message (const char *) - message to display
+ * Returns            : None
+ * Description        : Toasts hold their worker for over two seconds, they go
+ *                      on the lowest lane.
+ ***********************************************************************************/
+static void post_toast(const char* message) {
+    Task task = {.run = toast_task, .priority = TASK_NOTIFY};
+    snprintf(task.text, sizeof(task.text), "%s", message);
+    executor_submit(&task);
+}
+
+/***********************************************************************************
+ * Function Name      : apply_profile
+ * Inputs             : mode (ProfileMode) - profile to apply
+ *                      profile (const GameProfile *) - game overrides applied
+ *                                                      after it, NULL for none
+ * Returns            : None
+ * Description        : Profile changes are serialized on the profile lane, the
+ *                      detection loop keeps running while the profiler does.
+ ***********************************************************************************/
+static void apply_profile(const ProfileMode mode, const GameProfile* profile) {
+    session_publish(mode == PERFORMANCE_PROFILE);
+
+    Task task = {.run = profile_task, .priority = TASK_PROFILE, .value = mode, .has_profile = profile != NULL};
+    if (profile)
+        task.profile = *profile;
+    executor_submit(&task);
+}
+
+/***********************************************************************************
+ * Function Name      : submit_boost
+ * Inputs             : session (const GameSession *) - boosted game
+ * Returns            : None
+ ***********************************************************************************/
+static void submit_boost(const GameSession* session) {
+    Task task = {.run = boost_task, .priority = TASK_BOOST, .pid = game_pid, .has_profile = true, .profile = session->profile};
+    snprintf(task.package, sizeof(task.package), "%s", session->package);
+    executor_submit(&task);
+}
+
+/***********************************************************************************
+ * Function Name      : submit_freeze
+ * Inputs             : session (const GameSession *) - active game session
+ * Returns            : None
+ * Description        : Queues freezing of cached background apps, unless they
+ *                      are held for the game already.
+ ***********************************************************************************/
+static void submit_freeze(const GameSession* session) {
+    if (!is_enabled(APP_FREEZER) || app_freezer_active())
+        return;
+
+    Task task = {.run = freeze_task, .priority = TASK_BOOST, .value = session->uid};
+    snprintf(task.package, sizeof(task.package), "%s", session->package);
+    executor_submit(&task);
+}
+
+/***********************************************************************************
+ * Function Name      : leave_performance
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Undoes everything applied on top of the profiler for a
+ *                      game session, before the next profile gets applied.
+ ***********************************************************************************/
+static void leave_performance(void) {
+    GameSession* prev = session_active();
+    if (prev)
+        retention_start(prev);
+
+    attach_pending[0] = '\0';
+    if (prev)
+        executor_cancel(prev->package);
+    touch_release();
+    perf_controller_stop();
+    gpu_controller_stop();
+    io_boost_stop();
+    net_monitor_stop();
+    irq_restore();
+
+    // Boost tasks are short or cancelled above, let them land before they are undone
+    executor_wait(TASK_BOOST);
+    unboost_game_threads();
+    // Also hands back processes adopted from a previous instance
+    cgroup_restore();
+    if (app_freezer_active())
+        thaw_background_apps();
+    set_boost_game_patterns(NULL, 0);
+}
+
+/***********************************************************************************
+ * Function Name      : has_cpu_overrides
+ * Inputs             : profile (const GameProfile *) - game overrides
+ * Returns            : bool - true if the game changes profiler cpufreq values
+ ***********************************************************************************/
+static bool has_cpu_overrides(const GameProfile* profile) {
+    return profile->governor[0] || profile->floor_pct >= 0;
+}
+
+/***********************************************************************************
+ * Function Name      : attach_game
+ * Inputs             : session (GameSession *) - active game session
+ * Returns            : None
+ * Description        : Session policies applied on top of the profiler, shared
+ *                      by a fresh boost and a resumed one after restart.
+ *                      Controllers snapshot what the profiler wrote, so they
+ *                      start here on the main loop, the rest is queued.
+ ***********************************************************************************/
+static void attach_game(GameSession* session) {
+    const GameProfile* profile = &session->profile;
+
+    perf_controller_start(game_pid);
+    gpu_controller_start(session->package);
+    io_boost_start(game_pid);
+    net_monitor_start(session->uid);
+    irq_steer();
+    set_boost_game_patterns(profile->threads, profile->nr_threads);
+    submit_boost(session);
+    submit_freeze(session);
+    if (profile->preload && !session->preloaded) {
+        Task task = {.run = preload_task, .done = preload_done, .priority = TASK_PRELOAD, .value = profile->preload_budget_mb};
+        snprintf(task.package, sizeof(task.package), "%s", session->package);
+        executor_submit(&task);
+        session->preloaded = true;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : attach_ready
+ * Inputs             : None
+ * Returns            : bool - true once session policies are attached
+ * Description        : Attaches the pending session as soon as the profile
+ *                      lane has drained. Time to boost ends here.
+ ***********************************************************************************/
+static bool attach_ready(void) {
+    if (!attach_pending[0])
+        return true;
+    if (executor_busy(TASK_PROFILE))
+        return false;
+
+    GameSession* session = session_find(attach_pending);
+    attach_pending[0] = '\0';
+    if (!session || !session->active)
+        return false;
+
+    if (attach_seen_ms)
+        session->boost_ms = now_ms() - attach_seen_ms;
+    attach_game(session);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : enter_performance
+ * Inputs             : session (GameSession *) - game session to boost
+ *                      cached (bool) - true if session was tracked before
+ *                      switching (bool) - true if another game is boosted now
+ *                      seen_ms (long) - when the game was first wanted boosted
+ * Returns            : None
+ * Description        : Applies performance profile and session policies. Cached
+ *                      sessions skip preload, and switching between games skips
+ *                      the profiler unless one of them overrides cpufreq.
+ ***********************************************************************************/
+static void enter_performance(GameSession* session, const bool cached, const bool switching, const long seen_ms) {
+    GameSession* prev = session_active();
+    bool rerun_profiler = !switching || has_cpu_overrides(&session->profile) || (prev && has_cpu_overrides(&prev->profile));
+
+    if (switching)
+        leave_performance();
+    else
+        post_toast("Applying performance profile");
+
+    perf_controller_stop();
+    gpu_controller_stop();
+    io_boost_stop();
+    net_monitor_stop();
+    launch_handover(session);
+    retention_resume(session, cached);
+    session_activate(session);
+    game_pid = session->pid;
+
+    if (rerun_profiler) {
+        if (!switching)
+            net_monitor_hold();
+        apply_profile(PERFORMANCE_PROFILE, &session->profile);
+    } else {
+        session_publish(true);
+    }
+
+    // Controllers follow once the profile lane applied it, preload is timed on its own
+    snprintf(attach_pending, sizeof(attach_pending), "%s", session->package);
+    attach_seen_ms = cached ? 0 : seen_ms;
+    attach_ready();
+    log_nusantara(LOG_INFO, "Applying performance profile for %s%s", session->package, cached ? " (cached session)" : "");
+}
+
+/***********************************************************************************
+ * Function Name      : resume_performance
+ * Inputs             : saved (const DaemonState *) - state of previous instance
+ * Returns            : bool - true if the boosted game still runs
+ * Description        : Controllers snapshot profiler values when they attach,
+ *                      but after a restart the previous instance's controllers
+ *                      left lowered levels, GPU floor and network values in
+ *                      place. Performance runs through the profiler again and
+ *                      the session attaches once the profile lane drained, as
+ *                      for a fresh boost. IRQ and cgroup originals come from
+ *                      daemon state. The saved PID must still belong to the
+ *                      game, PIDs get reused.
+ ***********************************************************************************/
+static bool resume_performance(const DaemonState* saved) {
+    char path[MAX_PATH_LENGTH];
+    char cmdline[MAX_PACKAGE] = {0};
+    snprintf(path, sizeof(path), "/proc/%d/cmdline", saved->pid);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return false;
+    size_t len = fread(cmdline, 1, sizeof(cmdline) - 1, fp);
+    fclose(fp);
+
+    if (!saved->game[0] || len == 0 || strncmp(cmdline, saved->game, strlen(saved->game)) != 0)
+        return false;
+
+    GameSession* session = session_open(saved->game, saved->pid, game_config_get(saved->game));
+    session->preloaded = true;
+    session_activate(session);
+    game_pid = saved->pid;
+    snprintf(gamestart_buf, sizeof(gamestart_buf), "%s", saved->game);
+    gamestart = gamestart_buf;
+
+    apply_profile(PERFORMANCE_PROFILE, &session->profile);
+    snprintf(attach_pending, sizeof(attach_pending), "%s", session->package);
+    attach_seen_ms = 0;
+    attach_ready();
+    log_nusantara(LOG_INFO, "Resumed performance profile for %s (PID %d)", saved->game, saved->pid);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : startup_setup
+ * Inputs             : arg (void *) - unused
+ * Returns            : void * - NULL
+ * Description        : Work that needs no booted system, runs while the main
+ *                      thread waits for boot completion.
+ ***********************************************************************************/
+static void* startup_setup(void* arg) {
+    (void)arg;
+
+    // Build SoC model once, everything else works per cluster
+    if (topology_init(&cpu_topology, "")) [[clang::likely]] {
+        for (int i = 0; i < cpu_topology.nr_clusters; i++) {
+            const CpuCluster* cluster = &cpu_topology.cluster[i];
+            log_nusantara(LOG_INFO, "Cluster policy%d: %s, %d CPUs, capacity %ld, %ld-%ldKHz", cluster->policy,
+                          cluster_type_name[cluster->type], cluster->nr_cpus, cluster->capacity, cluster->min_freq,
+                          cluster->max_freq);
+        }
+        topology_dump(&cpu_topology, CPU_TOPOLOGY);
+    }
+
+    game_config_refresh();
+    log_nusantara(LOG_INFO, "Indexed %d installed packages", package_index_build());
+    return NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : boot_tweaks
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Once per boot, after boot completed. Puts the default
+ *                      governor back over what init scripts set, and restarts
+ *                      PPM to clear buggy post-boot throttling on old MediaTek.
+ ***********************************************************************************/
+static void boot_tweaks(void) {
+    char gov[32] = {0};
+    FILE* fp = fopen(MODULE_CONFIG "/custom_default_cpu_gov", "r");
+    if (!fp)
+        fp = fopen(MODULE_CONFIG "/default_cpu_gov", "r");
+    if (fp) {
+        if (!fgets(gov, sizeof(gov), fp))
+            gov[0] = '\0';
+        fclose(fp);
+        trim_newline(gov);
+    }
+
+    for (int i = 0; gov[0] && i < cpu_topology.nr_clusters; i++) {
+        char path[MAX_PATH_LENGTH];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpufreq/policy%d/scaling_governor", cpu_topology.cluster[i].policy);
+        write2file(path, false, false, "%s", gov);
+    }
+
+    if (access(PPM_ENABLED, F_OK) == 0) {
+        write2file(PPM_ENABLED, false, false, "0");
+        sleep(1);
+        write2file(PPM_ENABLED, false, false, "1");
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : wait_next_round
+ * Inputs             : cur_mode (ProfileMode) - current profile
+ * Returns            : None
+ * Description        : Publishes status and sleeps until next detection round.
+ *                      In performance profile the wait is sliced into thermal
+ *                      and controller ticks, touches boost in between, and
+ *                      ends early once the game process is gone or another
+ *                      game launches.
+ ***********************************************************************************/
+static void wait_next_round(const ProfileMode cur_mode) {
+    executor_reap();
+    energy_tick(cur_mode);
+    session_account(cur_mode);
+    state_save(cur_mode);
+    write_status(cur_mode, &profile_fsm);
+
+    if (cur_mode != PERFORMANCE_PROFILE || game_pid == 0) {
+        launch_wait(LOOP_INTERVAL * 1000);
+        thermal_tick();
+        return;
+    }
+
+    ThermalState thermal = thermal_tick();
+    for (int tick = 0; tick < LOOP_INTERVAL * 1000 / CONTROL_INTERVAL_MS; tick++) {
+        touch_wait(CONTROL_INTERVAL_MS);
+
+        // Another game launching gets detected in the next round right away
+        if (launch_poll())
+            break;
+
+        // Thermal first, controller clamps its level to the thermal cap
+        ThermalState state = thermal_tick();
+        session_thermal(state != thermal);
+        if (state != thermal) {
+            thermal = state;
+            write_status(cur_mode, &profile_fsm);
+        }
+
+        executor_reap();
+        if (!attach_ready())
+            continue;
+
+        if (!perf_controller_tick(game_pid))
+            break;
+        gpu_controller_tick();
+        io_boost_tick();
+        net_monitor_tick();
+        irq_tick();
+    }
+}
+
 int main(int argc, char* argv[]) {
     // Handle case when not running on root
     if (getuid() != 0) {
@@ -85,6 +527,10 @@ int main(int argc, char* argv[]) {
         return EXIT_SUCCESS;
     }
 
+    // Session history report
+    if (strcmp(base_name, "nusantara_history") == 0)
+        return history_main(argc, argv);
+
     // Sanity check for dumpsys
     if (access("/system/bin/dumpsys", F_OK) != 0) {
         fprintf(stderr, "\033[31mFATAL ERROR:\033[0m /system/bin/dumpsys: inaccessible or not found\n");
@@ -128,14 +574,66 @@ int main(int argc, char* argv[]) {
 
     // Initialize variables
     bool need_profile_checkup = false;
-    MLBBState mlbb_is_running = MLBB_NOT_RUNNING;
+    GameState game_state = GAME_NO_RULE;
+    pid_t rule_pid = 0;
     ProfileMode cur_mode = PERFCOMMON;
 
     log_nusantara(LOG_INFO, "Daemon started as PID %d", getpid());
-    run_profiler(PERFCOMMON); // exec perfcommon
+
+    // Saved state of this boot means we were restarted, tuning is still applied
+    DaemonState saved;
+    bool warm = state_restore(&saved);
+    if (warm)
+        cur_mode = saved.mode;
+    else
+        log_nusantara(LOG_INFO, "Waiting for boot completion");
+
+    pthread_t setup_thread;
+    bool threaded = pthread_create(&setup_thread, NULL, startup_setup, NULL) == 0;
+    if (!threaded) [[clang::unlikely]]
+        startup_setup(NULL);
+
+    long boot_wait_ms = now_ms();
+    if (!warm)
+        wait_boot_completed(getenv(BOOT_STAND_IN_ENV), -1);
+    boot_wait_ms = now_ms() - boot_wait_ms;
+
+    if (threaded)
+        pthread_join(setup_thread, NULL);
+
+    if (warm)
+        log_nusantara(LOG_INFO, "Restarted within the same boot, keeping %s profile", profile_mode_name[cur_mode]);
+    else
+        log_nusantara(LOG_INFO, "Boot completed, waited %ldms", boot_wait_ms);
+
+    use_cgroup = is_enabled(CGROUP_PLACEMENT) && cgroup_init();
+    thermal_init();
+    gpu_init();
+    io_boost_init();
+    irq_init();
+    launch_init();
+    touch_init(getenv(TOUCH_STAND_IN_ENV));
+    executor_start();
+
+    FsmConfig fsm_config;
+    profile_fsm_load(&fsm_config, TRANSITION_DWELL);
+    profile_fsm_init(&profile_fsm, &fsm_config, cur_mode);
+
+    if (is_enabled(TRACE_RECORD))
+        trace_open(DECISION_TRACE);
+
+    // A game gone meanwhile is left to the loop, it leaves performance as usual
+    if (!warm) {
+        boot_tweaks();
+        apply_profile(PERFCOMMON, NULL); // exec perfcommon
+    } else if (cur_mode == PERFORMANCE_PROFILE && !resume_performance(&saved)) {
+        log_nusantara(LOG_INFO, "Game %s is gone since restart", saved.game);
+    }
 
     while (1) {
-        sleep(LOOP_INTERVAL);
+        // Strings of the previous tick are dead by now
+        arena_reset();
+        wait_next_round(cur_mode);
 
         // Handle case when module gets updated
         if (access(MODULE_UPDATE, F_OK) == 0) [[clang::unlikely]] {
@@ -144,65 +642,108 @@ int main(int argc, char* argv[]) {
             break;
         }
 
-        // Only fetch gamestart when user not in-game
-        // prevent overhead from dumpsys commands.
-        if (!gamestart) {
-            gamestart = get_gamestart();
-        } else if (game_pid != 0 && kill(game_pid, 0) == -1) [[clang::unlikely]] {
-            log_nusantara(LOG_INFO, "Game %s exited, resetting profile...", gamestart);
-            game_pid = 0;
-            free(gamestart);
-            gamestart = get_gamestart();
+        // Pick up gamelist and gameconfig edits
+        game_config_refresh();
 
-            // Force profile recheck to make sure new game session get boosted
+        // Drop exited games, force profile recheck to make sure new game session get boosted
+        if (session_prune()) {
+            game_pid = 0;
             need_profile_checkup = true;
         }
+        retention_tick();
+        launch_tick();
+        app_freezer_recheck();
+
+        // Fetch gamestart when the active game left the screen or none is known, and every
+        // GAME_RECHECK_ROUNDS while it stays visible so a game next to it gets noticed.
+        GameSession* active = session_active();
+        if (!gamestart || !active || !session_on_screen(active) || ++onscreen_rounds >= GAME_RECHECK_ROUNDS) {
+            onscreen_rounds = 0;
+            gamestart = get_gamestart(gamestart_buf, sizeof(gamestart_buf)) ? gamestart_buf : NULL;
+        }
 
         if (gamestart)
-            mlbb_is_running = handle_mlbb(gamestart);
+            game_state = resolve_game_process(gamestart, game_config_get(gamestart), &rule_pid);
+
+        // Sample inputs lazily, the same way the decision reads them
+        ProfileInputs inputs = {.now_ms = now_ms(), .game = gamestart != NULL, .game_alive = active != NULL};
+        if (inputs.game) {
+            inputs.screen_on = get_screenstate();
+            inputs.game_bg = game_state == GAME_RUN_BG;
+        }
+
+        bool game_foreground = inputs.game && inputs.screen_on && !inputs.game_bg;
+        if (!game_foreground)
+            inputs.low_power = get_low_power_state();
+
+        trace_record(&inputs, gamestart);
+
+        // Inputs decide what profile is wanted, the state machine decides when it happens
+        ProfileMode wanted = profile_wanted(&inputs);
+        ProfileMode next = profile_fsm_step(&profile_fsm, wanted, inputs.game_alive, inputs.now_ms);
 
-        if (gamestart && get_screenstate() && mlbb_is_running != MLBB_RUN_BG) {
-            // Bail out if we already on performance profile
+        if (next == PERFORMANCE_PROFILE) {
+            // Grace period, keep the game boosted while it is briefly away.
+            // Whatever the user went to may be frozen, so give apps back meanwhile.
+            if (!game_foreground) {
+                if (app_freezer_active())
+                    thaw_background_apps();
+                continue;
+            }
+
+            GameSession* session = session_find(gamestart);
+
+            // Bail out if we already on performance profile for this game
             // However we will pass this if need_profile_checkup was true
-            if (!need_profile_checkup && cur_mode == PERFORMANCE_PROFILE)
+            if (!need_profile_checkup && cur_mode == PERFORMANCE_PROFILE && session && session == active) {
+                // Catch threads and processes spawned after the initial boost
+                if (attach_ready() && !executor_busy(TASK_BOOST)) {
+                    submit_boost(session);
+                    submit_freeze(session);
+                }
                 continue;
+            }
 
             // Get PID and check if the game is "real" running program
-            // Handle weird behavior of MLBB
-            game_pid = (mlbb_is_running == MLBB_RUNNING) ? mlbb_pid : pidof(gamestart);
-            if (game_pid == 0) [[clang::unlikely]] {
+            // Games with a render process rule get that process boosted instead
+            pid_t pid = (game_state == GAME_RUNNING) ? rule_pid : (session ? session->pid : pidof(gamestart));
+            if (pid == 0) [[clang::unlikely]] {
                 log_nusantara(LOG_ERROR, "Unable to fetch PID of %s", gamestart);
-                free(gamestart);
                 gamestart = NULL;
+                profile_fsm_force(&profile_fsm, cur_mode);
                 continue;
             }
 
+            bool cached = session != NULL;
+            if (!session)
+                session = session_open(gamestart, pid, game_config_get(gamestart));
+            session->pid = pid;
+
+            // Dwell included, the game was waiting for the boost all along
+            bool switching = cur_mode == PERFORMANCE_PROFILE;
+            enter_performance(session, cached, switching, switching ? inputs.now_ms : profile_fsm.pending_since_ms);
             cur_mode = PERFORMANCE_PROFILE;
             need_profile_checkup = false;
-            toast("Applying performance profile");
-            run_profiler(PERFORMANCE_PROFILE);
-            set_priority(game_pid);
-            NusantaraPreload(gamestart);
-            log_nusantara(LOG_INFO, "Applying performance profile for %s", gamestart);
-        } else if (get_low_power_state()) {
-            // Bail out if we already on powersave profile
-            if (cur_mode == POWERSAVE_PROFILE)
-                continue;
+            continue;
+        }
 
-            cur_mode = POWERSAVE_PROFILE;
-            need_profile_checkup = false;
-            toast("Applying powersave profile");
-            run_profiler(POWERSAVE_PROFILE);
+        // Bail out if we already on this profile
+        if (next == cur_mode)
+            continue;
+
+        if (cur_mode == PERFORMANCE_PROFILE)
+            leave_performance();
+
+        cur_mode = next;
+        need_profile_checkup = false;
+        launch_handover(NULL);
+        if (next == POWERSAVE_PROFILE) {
+            post_toast("Applying powersave profile");
+            apply_profile(POWERSAVE_PROFILE, NULL);
             log_nusantara(LOG_INFO, "Applying powersave profile");
         } else {
-            // Bail out if we already on normal profile
-            if (cur_mode == NORMAL_PROFILE)
-                continue;
-
-            cur_mode = NORMAL_PROFILE;
-            need_profile_checkup = false;
-            toast("Applying normal profile");
-            run_profiler(NORMAL_PROFILE);
+            post_toast("Applying normal profile");
+            apply_profile(NORMAL_PROFILE, NULL);
             log_nusantara(LOG_INFO, "Applying normal profile");
         }
     }
@@ -0,0 +1,571 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#ifndef MADV_COLD
+    #define MADV_COLD 20
+#endif
+#ifndef MADV_PAGEOUT
+    #define MADV_PAGEOUT 21
+#endif
+#ifndef __NR_pidfd_open
+    #define __NR_pidfd_open 434
+#endif
+#ifndef __NR_process_madvise
+    #define __NR_process_madvise 440
+#endif
+
+#define MAX_WHITELIST 64
+#define MADVISE_BATCH 512
+
+typedef struct {
+    pid_t pid;
+    long rss_kb;
+    bool frozen_by_us;
+    char cgroup[MAX_PATH_LENGTH];
+} FreezeCandidate;
+
+// Candidates belong to the freeze task, frozen groups are shared under the lock
+static FreezeCandidate* candidates = NULL;
+static int nr_candidates = 0;
+static int candidates_cap = 0;
+static FreezeCandidate* frozen_apps = NULL;
+static int nr_frozen_apps = 0;
+static int frozen_cap = 0;
+static bool reclaim_supported = true;
+static bool freezer_active = false;
+static unsigned int generation = 0;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static char whitelist[MAX_WHITELIST][MAX_PACKAGE];
+static int nr_whitelist = 0;
+
+/***********************************************************************************
+ * Function Name      : whitelist_add
+ * Inputs             : package (const char *) - package name
+ * Returns            : None
+ * Description        : Adds a package to the in-memory whitelist.
+ ***********************************************************************************/
+static void whitelist_add(const char* package) {
+    if (!package || package[0] == '\0' || nr_whitelist >= MAX_WHITELIST)
+        return;
+
+    snprintf(whitelist[nr_whitelist++], MAX_PACKAGE, "%s", package);
+}
+
+/***********************************************************************************
+ * Function Name      : load_whitelist
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Loads user whitelist plus current launcher and keyboard,
+ *                      freezing those makes the return from game sluggish.
+ ***********************************************************************************/
+static void load_whitelist(void) {
+    nr_whitelist = 0;
+
+    FILE* fp = fopen(FREEZE_WHITELIST, "r");
+    if (fp) {
+        char line[MAX_PACKAGE];
+        while (fgets(line, sizeof(line), fp)) {
+            trim_newline(line);
+            if (line[0] != '#')
+                whitelist_add(line);
+        }
+        fclose(fp);
+    }
+
+    // Default IME is stored as package/.Service
+    char* ime = execute_direct("/system/bin/settings", "settings", "get", "secure", "default_input_method", NULL);
+    if (ime) {
+        char* slash = strchr(ime, '/');
+        if (slash)
+            *slash = '\0';
+        whitelist_add(ime);
+    }
+
+    char* launcher = execute_command("cmd package resolve-activity --brief -a android.intent.action.MAIN "
+                                     "-c android.intent.category.HOME | tail -n1 | cut -d/ -f1");
+    if (launcher)
+        whitelist_add(launcher);
+}
+
+/***********************************************************************************
+ * Function Name      : is_whitelisted
+ * Inputs             : pid (pid_t) - process id
+ * Returns            : bool - true if process belongs to a whitelisted package
+ * Description        : Matches package part of cmdline (before ':') against whitelist.
+ ***********************************************************************************/
+static bool is_whitelisted(const pid_t pid) {
+    char path[MAX_PATH_LENGTH];
+    char cmdline[MAX_PACKAGE] = {0};
+    snprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return true;
+
+    size_t len = fread(cmdline, 1, sizeof(cmdline) - 1, fp);
+    fclose(fp);
+    if (len == 0)
+        return true;
+
+    char* colon = strchr(cmdline, ':');
+    if (colon)
+        *colon = '\0';
+
+    for (int i = 0; i < nr_whitelist; i++) {
+        if (strcmp(cmdline, whitelist[i]) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : rss_of
+ * Inputs             : pid (pid_t) - process id
+ * Returns            : long - resident set size in KB, -1 on error
+ * Description        : Reads RSS from /proc/<pid>/statm.
+ ***********************************************************************************/
+static long rss_of(const pid_t pid) {
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "/proc/%d/statm", pid);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return -1;
+
+    long size, resident;
+    bool ok = fscanf(fp, "%ld %ld", &size, &resident) == 2;
+    fclose(fp);
+
+    return ok ? resident * (sysconf(_SC_PAGESIZE) / 1024) : -1;
+}
+
+/***********************************************************************************
+ * Function Name      : v2_cgroup_of
+ * Inputs             : pid (pid_t) - process id
+ *                      out (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : bool - true if process lives in a cgroup v2 group
+ * Description        : Builds cgroup v2 directory of a process (uid_X/pid_Y on
+ *                      Android 11+) to reach its cgroup.freeze node.
+ ***********************************************************************************/
+static bool v2_cgroup_of(const pid_t pid, char* out, const size_t len) {
+    char path[MAX_PATH_LENGTH];
+    char line[MAX_LINE];
+    bool found = false;
+    snprintf(path, sizeof(path), "/proc/%d/cgroup", pid);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return false;
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, "0::", 3) != 0)
+            continue;
+
+        trim_newline(line);
+        snprintf(out, len, "%s%s", CGROUP_V2_ROOT, line + 3);
+        found = true;
+        break;
+    }
+
+    fclose(fp);
+
+    // Our own background group is shared, freezing it hits every process inside
+    return found && strstr(out, CGROUP_BG_NAME) == NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : set_frozen
+ * Inputs             : cgroup (const char *) - cgroup v2 directory
+ *                      frozen (bool) - true to freeze, false to thaw
+ * Returns            : bool - true on success
+ * Description        : Writes cgroup.freeze of a group.
+ ***********************************************************************************/
+static bool set_frozen(const char* cgroup, const bool frozen) {
+    char node[MAX_PATH_LENGTH + 16];
+    snprintf(node, sizeof(node), "%s/cgroup.freeze", cgroup);
+    return write2file(node, false, false, "%d", frozen ? 1 : 0) == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : is_frozen
+ * Inputs             : cgroup (const char *) - cgroup v2 directory
+ * Returns            : bool - true if group is already frozen
+ * Description        : Android cached apps freezer may have frozen it already,
+ *                      such groups are left to the system on thaw.
+ ***********************************************************************************/
+static bool is_frozen(const char* cgroup) {
+    char node[MAX_PATH_LENGTH + 16];
+    snprintf(node, sizeof(node), "%s/cgroup.freeze", cgroup);
+    return is_enabled(node);
+}
+
+/***********************************************************************************
+ * Function Name      : reclaim_process
+ * Inputs             : pid (pid_t) - process id
+ *                      advice (int) - MADV_PAGEOUT or MADV_COLD
+ * Returns            : bool - true if process_madvise was accepted
+ * Description        : Applies advice on every mapping of a process through
+ *                      process_madvise(2), batched per UIO_MAXIOV.
+ ***********************************************************************************/
+static bool reclaim_process(const pid_t pid, const int advice) {
+    if (!reclaim_supported)
+        return false;
+
+    int pidfd = (int)syscall(__NR_pidfd_open, pid, 0);
+    if (pidfd == -1) {
+        if (errno == ENOSYS) {
+            log_nusantara(LOG_WARN, "Kernel lacks pidfd_open, proactive reclaim disabled");
+            reclaim_supported = false;
+        }
+        return false;
+    }
+
+    char path[MAX_PATH_LENGTH];
+    char line[MAX_LINE];
+    snprintf(path, sizeof(path), "/proc/%d/maps", pid);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        close(pidfd);
+        return false;
+    }
+
+    struct iovec vec[MADVISE_BATCH];
+    int nr_vec = 0;
+    bool ok = true;
+
+    while (ok) {
+        bool more = fgets(line, sizeof(line), fp) != NULL;
+        if (more) {
+            unsigned long start, end;
+            if (sscanf(line, "%lx-%lx", &start, &end) != 2 || strstr(line, "[v"))
+                continue;
+
+            vec[nr_vec].iov_base = (void*)start;
+            vec[nr_vec].iov_len = end - start;
+            nr_vec++;
+        }
+
+        if (nr_vec == MADVISE_BATCH || (!more && nr_vec > 0)) {
+            if (syscall(__NR_process_madvise, pidfd, vec, nr_vec, advice, 0) == -1) {
+                if (errno == ENOSYS) {
+                    log_nusantara(LOG_WARN, "Kernel lacks process_madvise, proactive reclaim disabled");
+                    reclaim_supported = false;
+                }
+                ok = false;
+            }
+            nr_vec = 0;
+        }
+
+        if (!more)
+            break;
+    }
+
+    fclose(fp);
+    close(pidfd);
+    return ok;
+}
+
+/***********************************************************************************
+ * Function Name      : compare_rss
+ * Inputs             : a, b (const void *) - FreezeCandidate pointers
+ * Returns            : int - qsort order, biggest RSS first
+ * Description        : Reclaim budget is best spent on the fattest apps.
+ ***********************************************************************************/
+static int compare_rss(const void* a, const void* b) {
+    long ra = ((const FreezeCandidate*)a)->rss_kb;
+    long rb = ((const FreezeCandidate*)b)->rss_kb;
+    return (rb > ra) - (rb < ra);
+}
+
+/***********************************************************************************
+ * Function Name      : remember_frozen
+ * Inputs             : app (const FreezeCandidate *) - group we just froze
+ * Returns            : bool - false if it could not be recorded
+ * Description        : Caller holds the lock.
+ ***********************************************************************************/
+static bool remember_frozen(const FreezeCandidate* app) {
+    if (nr_frozen_apps == frozen_cap) {
+        int cap = frozen_cap ? frozen_cap * 2 : 32;
+        FreezeCandidate* grown = realloc(frozen_apps, cap * sizeof(FreezeCandidate));
+        if (!grown) [[clang::unlikely]]
+            return false;
+        frozen_apps = grown;
+        frozen_cap = cap;
+    }
+
+    frozen_apps[nr_frozen_apps] = *app;
+    frozen_apps[nr_frozen_apps++].frozen_by_us = true;
+    generation++;
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : thaw_locked
+ * Inputs             : None
+ * Returns            : int - number of groups thawed
+ * Description        : Caller holds the lock.
+ ***********************************************************************************/
+static int thaw_locked(void) {
+    int thawed = 0;
+
+    for (int i = 0; i < nr_frozen_apps; i++) {
+        if (frozen_apps[i].frozen_by_us && set_frozen(frozen_apps[i].cgroup, false))
+            thawed++;
+    }
+
+    nr_frozen_apps = 0;
+    freezer_active = false;
+    generation++;
+    return thawed;
+}
+
+/***********************************************************************************
+ * Function Name      : freeze_background_apps
+ * Inputs             : game_uid (int) - UID of the game to leave alone
+ * Returns            : None
+ * Description        : Freezes cached apps through cgroup v2 freezer and pages
+ *                      out their memory with process_madvise, biggest first,
+ *                      until the configured budget is reached. Whitelisted,
+ *                      perceptible (music playback) and visible apps are never
+ *                      touched because only cached oom_score_adj is selected.
+ *                      Runs on an executor worker and stops early once its
+ *                      task is cancelled, the lock is only held to record a
+ *                      frozen group.
+ ***********************************************************************************/
+void freeze_background_apps(const int game_uid) {
+    pthread_mutex_lock(&lock);
+    if (freezer_active) {
+        int thawed = thaw_locked();
+        if (thawed > 0)
+            log_nusantara(LOG_INFO, "App freezer: thawed %d apps", thawed);
+    }
+    freezer_active = true;
+    pthread_mutex_unlock(&lock);
+
+    load_whitelist();
+
+    DIR* proc_dir = opendir("/proc");
+    if (!proc_dir) [[clang::unlikely]]
+        return;
+
+    nr_candidates = 0;
+    struct dirent* entry;
+    while ((entry = readdir(proc_dir)) && !task_cancelled()) {
+        if (!isdigit((unsigned char)entry->d_name[0]))
+            continue;
+
+        pid_t pid = (pid_t)atoi(entry->d_name);
+        int uid = uidof(pid);
+        if (uid < FIRST_APPLICATION_UID || uid == game_uid)
+            continue;
+
+        char path[MAX_PATH_LENGTH];
+        snprintf(path, sizeof(path), "/proc/%d/oom_score_adj", pid);
+        if (read_long(path, 0) < FREEZER_MIN_OOM_ADJ || is_whitelisted(pid))
+            continue;
+
+        if (nr_candidates == candidates_cap) {
+            int cap = candidates_cap ? candidates_cap * 2 : 32;
+            FreezeCandidate* grown = realloc(candidates, cap * sizeof(FreezeCandidate));
+            if (!grown) [[clang::unlikely]]
+                break;
+            candidates = grown;
+            candidates_cap = cap;
+        }
+
+        FreezeCandidate* app = &candidates[nr_candidates];
+        memset(app, 0, sizeof(*app));
+        app->pid = pid;
+        app->rss_kb = rss_of(pid);
+        if (app->rss_kb > 0)
+            nr_candidates++;
+    }
+
+    closedir(proc_dir);
+
+    if (nr_candidates == 0)
+        return;
+
+    qsort(candidates, nr_candidates, sizeof(FreezeCandidate), compare_rss);
+
+    long budget_kb = read_long(FREEZE_BUDGET, FREEZER_DEFAULT_BUDGET_MB) * 1024;
+    long mem_total_mb = 0, avail_before = 0, avail_after = 0;
+    long freed_kb = 0;
+    int nr_frozen = 0, nr_reclaimed = 0;
+    get_meminfo(&mem_total_mb, &avail_before);
+
+    for (int i = 0; i < nr_candidates && !task_cancelled(); i++) {
+        FreezeCandidate* app = &candidates[i];
+
+        if (v2_cgroup_of(app->pid, app->cgroup, sizeof(app->cgroup)) && !is_frozen(app->cgroup)) {
+            pthread_mutex_lock(&lock);
+            if (freezer_active && set_frozen(app->cgroup, true)) {
+                if (remember_frozen(app))
+                    nr_frozen++;
+                else
+                    set_frozen(app->cgroup, false);
+            }
+            pthread_mutex_unlock(&lock);
+        }
+
+        // Past the budget only deactivate pages, let kswapd decide
+        int advice = freed_kb < budget_kb ? MADV_PAGEOUT : MADV_COLD;
+        if (!reclaim_process(app->pid, advice))
+            continue;
+
+        long rss_after = rss_of(app->pid);
+        if (advice == MADV_PAGEOUT && rss_after >= 0 && rss_after < app->rss_kb)
+            freed_kb += app->rss_kb - rss_after;
+        nr_reclaimed++;
+    }
+
+    get_meminfo(&mem_total_mb, &avail_after);
+    log_nusantara(LOG_INFO, "App freezer: froze %d, reclaimed %d of %d apps, freed %ldMB, MemAvailable %ldMB -> %ldMB (%+ldMB)",
+                  nr_frozen, nr_reclaimed, nr_candidates, freed_kb / 1024, avail_before, avail_after, avail_after - avail_before);
+}
+
+/***********************************************************************************
+ * Function Name      : thaw_background_apps
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Thaws every group we froze. Groups that were frozen by
+ *                      Android before us stay frozen. A freeze still running
+ *                      freezes nothing more after this.
+ ***********************************************************************************/
+void thaw_background_apps(void) {
+    pthread_mutex_lock(&lock);
+    int thawed = thaw_locked();
+    pthread_mutex_unlock(&lock);
+
+    if (thawed > 0)
+        log_nusantara(LOG_INFO, "App freezer: thawed %d apps", thawed);
+}
+
+/***********************************************************************************
+ * Function Name      : app_freezer_recheck
+ * Inputs             : None
+ * Returns            : int - number of groups thawed
+ * Description        : Called every loop round. An app the user switched to or
+ *                      that started a service gets its oom_score_adj lowered by
+ *                      ActivityManager while still frozen, such groups are
+ *                      thawed right away instead of hanging until the game
+ *                      session ends. Groups of exited processes are dropped.
+ ***********************************************************************************/
+int app_freezer_recheck(void) {
+    char path[MAX_PATH_LENGTH];
+    int thawed = 0;
+
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < nr_frozen_apps; i++) {
+        FreezeCandidate* app = &frozen_apps[i];
+        if (app->pid <= 0)
+            continue;
+
+        snprintf(path, sizeof(path), "/proc/%d/oom_score_adj", app->pid);
+        bool alive = kill(app->pid, 0) == 0;
+        if (alive && read_long(path, FREEZER_MIN_OOM_ADJ) >= FREEZER_MIN_OOM_ADJ)
+            continue;
+
+        if (alive && app->frozen_by_us && set_frozen(app->cgroup, false))
+            thawed++;
+
+        frozen_apps[i--] = frozen_apps[--nr_frozen_apps];
+        generation++;
+    }
+    pthread_mutex_unlock(&lock);
+
+    if (thawed > 0)
+        log_nusantara(LOG_INFO, "App freezer: thawed %d apps back in use", thawed);
+    return thawed;
+}
+
+/***********************************************************************************
+ * Function Name      : app_freezer_active
+ * Inputs             : None
+ * Returns            : bool - true while background apps are held for a game
+ * Description        : Lets preload know memory was already made room for.
+ ***********************************************************************************/
+bool app_freezer_active(void) {
+    pthread_mutex_lock(&lock);
+    bool active = freezer_active;
+    pthread_mutex_unlock(&lock);
+    return active;
+}
+
+/***********************************************************************************
+ * Function Name      : app_freezer_generation
+ * Inputs             : None
+ * Returns            : unsigned int - changes whenever the set of groups we
+ *                                     froze changes
+ * Description        : Lets daemon state know its frozen= lines are outdated.
+ ***********************************************************************************/
+unsigned int app_freezer_generation(void) {
+    pthread_mutex_lock(&lock);
+    unsigned int current = generation;
+    pthread_mutex_unlock(&lock);
+    return current;
+}
+
+/***********************************************************************************
+ * Function Name      : app_freezer_save
+ * Inputs             : fp (FILE *) - daemon state output
+ * Returns            : None
+ * Description        : Writes one frozen=<cgroup> line per group we froze, so a
+ *                      restarted daemon can still thaw them.
+ ***********************************************************************************/
+void app_freezer_save(FILE* fp) {
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < nr_frozen_apps; i++) {
+        if (frozen_apps[i].frozen_by_us)
+            fprintf(fp, "frozen=%s\n", frozen_apps[i].cgroup);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+/***********************************************************************************
+ * Function Name      : app_freezer_adopt
+ * Inputs             : cgroup (const char *) - group frozen by a previous instance
+ * Returns            : None
+ * Description        : Takes over a group from saved daemon state, it gets
+ *                      thawed with the rest when the game session ends.
+ ***********************************************************************************/
+void app_freezer_adopt(const char* cgroup) {
+    if (!is_frozen(cgroup))
+        return;
+
+    FreezeCandidate app = {0};
+    snprintf(app.cgroup, sizeof(app.cgroup), "%s", cgroup);
+
+    // Android names v2 process groups uid_X/pid_Y, the pid lets the loop recheck it
+    const char* pid_dir = strstr(cgroup, "/pid_");
+    if (pid_dir)
+        app.pid = (pid_t)atoi(pid_dir + 5);
+
+    pthread_mutex_lock(&lock);
+    if (remember_frozen(&app))
+        freezer_active = true;
+    pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <dlfcn.h>
+#include <libgen.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/system_properties.h>
+
+// Not in the android-24 headers, looked up at runtime
+typedef bool (*PropWaitFn)(const prop_info* pi, uint32_t old_serial, uint32_t* new_serial,
+                           const struct timespec* relative_timeout);
+typedef uint32_t (*PropSerialFn)(const prop_info* pi);
+typedef uint32_t (*AreaSerialFn)(void);
+
+/***********************************************************************************
+ * Function Name      : monotonic_ms
+ * Inputs             : None
+ * Returns            : long - monotonic time in milliseconds
+ ***********************************************************************************/
+static long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/***********************************************************************************
+ * Function Name      : time_left
+ * Inputs             : deadline (long) - monotonic deadline, -1 for none
+ * Returns            : long - milliseconds until deadline, -1 without deadline
+ ***********************************************************************************/
+static long time_left(const long deadline) {
+    if (deadline < 0)
+        return -1;
+
+    long left = deadline - monotonic_ms();
+    return left > 0 ? left : 0;
+}
+
+/***********************************************************************************
+ * Function Name      : boot_completed
+ * Inputs             : None
+ * Returns            : bool - true once sys.boot_completed is 1
+ ***********************************************************************************/
+static bool boot_completed(void) {
+    char value[PROP_VALUE_MAX] = {0};
+    return __system_property_get("sys.boot_completed", value) > 0 && strcmp(value, "1") == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : wait_property
+ * Inputs             : deadline (long) - monotonic deadline, -1 for none
+ * Returns            : bool - true if boot completed before the deadline
+ * Description        : Sleeps on the property area futex. The property does not
+ *                      exist before boot completes, so until then any property
+ *                      change wakes us for a recheck. Android 7 lacks the wait
+ *                      API and falls back to polling.
+ ***********************************************************************************/
+static bool wait_property(const long deadline) {
+    PropWaitFn prop_wait = NULL;
+    PropSerialFn prop_serial = NULL;
+    AreaSerialFn area_serial = NULL;
+    void* sym = dlsym(RTLD_DEFAULT, "__system_property_wait");
+    memcpy(&prop_wait, &sym, sizeof(sym));
+    sym = dlsym(RTLD_DEFAULT, "__system_property_serial");
+    memcpy(&prop_serial, &sym, sizeof(sym));
+    sym = dlsym(RTLD_DEFAULT, "__system_property_area_serial");
+    memcpy(&area_serial, &sym, sizeof(sym));
+
+    while (1) {
+        const prop_info* pi = prop_serial ? __system_property_find("sys.boot_completed") : NULL;
+        uint32_t serial = pi ? prop_serial(pi) : (area_serial ? area_serial() : 0);
+
+        // Serial is taken before the check, a change in between ends the wait at once
+        if (boot_completed())
+            return true;
+
+        long left = time_left(deadline);
+        if (left == 0)
+            return false;
+
+        if (!prop_wait || (!pi && !area_serial)) {
+            usleep((left < 0 || left > BOOT_POLL_MS ? BOOT_POLL_MS : left) * 1000);
+            continue;
+        }
+
+        struct timespec timeout = {.tv_sec = left / 1000, .tv_nsec = left % 1000 * 1000000};
+        uint32_t new_serial;
+        prop_wait(pi, serial, &new_serial, left < 0 ? NULL : &timeout);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : wait_stand_in
+ * Inputs             : path (const char *) - file replacing the property
+ *                      deadline (long) - monotonic deadline, -1 for none
+ * Returns            : bool - true once the file holds 1
+ * Description        : Watches the parent directory with inotify, so tests can
+ *                      finish boot by writing the file.
+ ***********************************************************************************/
+static bool wait_stand_in(const char* path, const long deadline) {
+    char dir[MAX_PATH_LENGTH];
+    snprintf(dir, sizeof(dir), "%s", path);
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd != -1 && inotify_add_watch(fd, dirname(dir), IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+        close(fd);
+        fd = -1;
+    }
+
+    bool done;
+    while (!(done = read_long(path, 0) == 1)) {
+        long left = time_left(deadline);
+        if (left == 0)
+            break;
+
+        int slice = left < 0 || left > BOOT_POLL_MS ? BOOT_POLL_MS : (int)left;
+        if (fd == -1) {
+            usleep(slice * 1000);
+            continue;
+        }
+
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        if (poll(&pfd, 1, slice) > 0) {
+            char events[sizeof(struct inotify_event) + NAME_MAX + 1];
+            while (read(fd, events, sizeof(events)) > 0)
+                ;
+        }
+    }
+
+    if (fd != -1)
+        close(fd);
+    return done;
+}
+
+/***********************************************************************************
+ * Function Name      : wait_boot_completed
+ * Inputs             : stand_in (const char *) - file to wait on instead of
+ *                                                sys.boot_completed, may be NULL
+ *                      timeout_ms (long) - give up after this long, -1 for never
+ * Returns            : bool - true if boot completed
+ * Description        : Event driven wait, replaces the sleep loop of service.sh.
+ *                      Does not log, startup setup runs in parallel meanwhile.
+ ***********************************************************************************/
+bool wait_boot_completed(const char* stand_in, const long timeout_ms) {
+    long deadline = timeout_ms < 0 ? -1 : monotonic_ms() + timeout_ms;
+
+    if (stand_in && stand_in[0])
+        return wait_stand_in(stand_in, deadline);
+
+    return wait_property(deadline);
+}
@@ -0,0 +1,755 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+typedef enum : char {
+    CG_CPU,
+    CG_CPUSET,
+    CG_STUNE,
+    CG_MAX
+} CgroupController;
+
+typedef enum : char {
+    CG_GROUP_GAME,
+    CG_GROUP_BG
+} CgroupGroup;
+
+typedef enum : char {
+    KNOB_UCLAMP_MIN,
+    KNOB_UCLAMP_MAX,
+    KNOB_WEIGHT,
+    KNOB_CPUS,
+    KNOB_MAX
+} CgroupKnob;
+
+typedef struct {
+    pid_t pid;
+    CgroupGroup group;
+    unsigned char moved;   // bitmask of controllers we actually moved
+    unsigned char enabled; // v2: bitmask of controllers we enabled below its uid group
+    char* orig[CG_MAX]; // cgroup v2 only uses CG_CPU
+    char* knob[KNOB_MAX]; // v2: process group values before we tuned them
+} CgroupTask;
+
+// Legacy v1 hierarchies as mounted by Android init
+static const struct {
+    const char* name;
+    const char* mount;
+} legacy_controller[CG_MAX] = {
+    [CG_CPU] = {"cpu", "/dev/cpuctl"},
+    [CG_CPUSET] = {"cpuset", "/dev/cpuset"},
+    [CG_STUNE] = {"schedtune", "/dev/stune"},
+};
+
+// Knobs tuned in place on the framework's uid_X/pid_Y groups on cgroup v2
+static const char* const knob_name[KNOB_MAX] = {
+    [KNOB_UCLAMP_MIN] = "cpu.uclamp.min",
+    [KNOB_UCLAMP_MAX] = "cpu.uclamp.max",
+    [KNOB_WEIGHT] = "cpu.weight",
+    [KNOB_CPUS] = "cpuset.cpus",
+};
+
+static CgroupBackend backend = CGROUP_NONE;
+static bool legacy_present[CG_MAX] = {false};
+static CgroupTask* tasks = NULL;
+static int nr_tasks = 0;
+static int cap_tasks = 0;
+static int placed_uid = -1;
+static char little_cpus[MAX_OUTPUT_LENGTH] = {0};
+static unsigned int generation = 0;
+
+// Placement runs on a boost worker, daemon state reads the table on the main loop
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+/***********************************************************************************
+ * Function Name      : has_token
+ * Inputs             : list (const char *) - space or comma separated list
+ *                      token (const char *) - whole token to look for
+ * Returns            : bool - true if token is in list
+ * Description        : Whole word match, so "cpu" does not hit "cpuset".
+ ***********************************************************************************/
+static bool has_token(const char* list, const char* token) {
+    size_t len = strlen(token);
+    for (const char* tok = list; (tok = strstr(tok, token)); tok += len) {
+        bool starts = tok == list || tok[-1] == ' ' || tok[-1] == ',';
+        bool ends = tok[len] == '\0' || tok[len] == ' ' || tok[len] == ',' || tok[len] == '\n';
+        if (starts && ends)
+            return true;
+    }
+
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : group_path
+ * Inputs             : ctrl (CgroupController) - legacy controller
+ *                      group (CgroupGroup) - our group
+ *                      out (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : char * - out
+ * Description        : Builds directory of one of our legacy groups.
+ ***********************************************************************************/
+static char* group_path(const CgroupController ctrl, const CgroupGroup group, char* out, const size_t len) {
+    const char* name = group == CG_GROUP_GAME ? CGROUP_GAME_NAME : CGROUP_BG_NAME;
+    snprintf(out, len, "%s/%s", legacy_controller[ctrl].mount, name);
+    return out;
+}
+
+/***********************************************************************************
+ * Function Name      : read_node
+ * Inputs             : path (const char *) - cgroup node
+ *                      out (char *) - output buffer, first line without newline
+ *                      len (size_t) - output buffer size
+ * Returns            : bool - true if the node could be read
+ * Description        : Reads first line of a cgroup node. An empty node such as
+ *                      an inheriting cpuset.cpus reads back as "".
+ ***********************************************************************************/
+static bool read_node(const char* path, char* out, const size_t len) {
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return false;
+
+    if (!fgets(out, len, fp))
+        out[0] = '\0';
+    fclose(fp);
+    trim_newline(out);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : copy_node
+ * Inputs             : from (const char *) - source node
+ *                      to (const char *) - destination node
+ * Returns            : None
+ * Description        : Copies first line of a cgroup node, used for cpuset.mems.
+ ***********************************************************************************/
+static void copy_node(const char* from, const char* to) {
+    char value[MAX_OUTPUT_LENGTH] = {0};
+    if (read_node(from, value, sizeof(value)) && value[0])
+        write2file(to, false, false, "%s", value);
+}
+
+/***********************************************************************************
+ * Function Name      : setup_groups
+ * Inputs             : None
+ * Returns            : bool - true if at least game group exists
+ * Description        : Creates legacy game and background groups and writes their
+ *                      knobs. Game group gets an elevated uclamp.min and weight,
+ *                      background group is squeezed into little cores with a
+ *                      low weight. On cgroup v2 processes stay in the uid_X/pid_Y
+ *                      groups ActivityManager and the app freezer rely on, so
+ *                      only the root controllers are enabled here.
+ ***********************************************************************************/
+static bool setup_groups(void) {
+    char path[MAX_PATH_LENGTH];
+    char node[MAX_PATH_LENGTH * 2];
+    const char* little = little_cpus;
+
+    const CpuCluster* little_cluster = topology_cluster(CLUSTER_LITTLE);
+    if (little_cluster)
+        format_cpu_list(&little_cluster->cpus, little_cpus, sizeof(little_cpus));
+
+    if (backend == CGROUP_V2) {
+        char enabled[MAX_OUTPUT_LENGTH] = {0};
+        write2file(CGROUP_V2_ROOT "/cgroup.subtree_control", false, false, "+cpu +cpuset");
+        return read_node(CGROUP_V2_ROOT "/cgroup.subtree_control", enabled, sizeof(enabled)) && has_token(enabled, "cpu");
+    }
+
+    for (int c = 0; c < CG_MAX; c++) {
+        if (!legacy_present[c])
+            continue;
+
+        for (int g = CG_GROUP_GAME; g <= CG_GROUP_BG; g++) {
+            group_path(c, g, path, sizeof(path));
+            if (mkdir(path, 0755) == -1 && errno != EEXIST)
+                legacy_present[c] = false;
+        }
+    }
+
+    if (legacy_present[CG_CPU]) {
+        group_path(CG_CPU, CG_GROUP_GAME, path, sizeof(path));
+        snprintf(node, sizeof(node), "%s/cpu.uclamp.min", path);
+        write2file(node, false, false, "%d", CGROUP_GAME_UCLAMP_MIN);
+        snprintf(node, sizeof(node), "%s/cpu.shares", path);
+        write2file(node, false, false, "%d", CGROUP_GAME_WEIGHT * 1024 / 100);
+
+        group_path(CG_CPU, CG_GROUP_BG, path, sizeof(path));
+        snprintf(node, sizeof(node), "%s/cpu.shares", path);
+        write2file(node, false, false, "%d", CGROUP_BG_WEIGHT * 1024 / 100);
+        snprintf(node, sizeof(node), "%s/cpu.uclamp.max", path);
+        write2file(node, false, false, "%d", CGROUP_BG_UCLAMP_MAX);
+    }
+
+    if (legacy_present[CG_CPUSET]) {
+        // Child cpuset is unusable until both cpus and mems are populated
+        for (int g = CG_GROUP_GAME; g <= CG_GROUP_BG; g++) {
+            group_path(CG_CPUSET, g, path, sizeof(path));
+            snprintf(node, sizeof(node), "%s/cpuset.mems", path);
+            copy_node("/dev/cpuset/cpuset.mems", node);
+            snprintf(node, sizeof(node), "%s/cpuset.cpus", path);
+            if (g == CG_GROUP_BG && little[0])
+                write2file(node, false, false, "%s", little);
+            else
+                copy_node("/dev/cpuset/top-app/cpuset.cpus", node);
+        }
+    }
+
+    if (legacy_present[CG_STUNE]) {
+        group_path(CG_STUNE, CG_GROUP_GAME, path, sizeof(path));
+        snprintf(node, sizeof(node), "%s/schedtune.boost", path);
+        write2file(node, false, false, "%d", CGROUP_GAME_STUNE_BOOST);
+        snprintf(node, sizeof(node), "%s/schedtune.prefer_idle", path);
+        write2file(node, false, false, "1");
+    }
+
+    return legacy_present[CG_CPU] || legacy_present[CG_CPUSET] || legacy_present[CG_STUNE];
+}
+
+/***********************************************************************************
+ * Function Name      : cgroup_init
+ * Inputs             : None
+ * Returns            : bool - true if a usable cgroup backend was found
+ * Description        : Picks cgroup v2 when it owns the cpu controller, otherwise
+ *                      falls back to Android legacy cpuctl/cpuset/schedtune.
+ ***********************************************************************************/
+bool cgroup_init(void) {
+    char controllers[MAX_OUTPUT_LENGTH] = {0};
+    FILE* fp = fopen(CGROUP_V2_ROOT "/cgroup.controllers", "r");
+    if (fp) {
+        if (!fgets(controllers, sizeof(controllers), fp))
+            controllers[0] = '\0';
+        fclose(fp);
+    }
+
+    if (has_token(controllers, "cpu")) {
+        backend = CGROUP_V2;
+    } else {
+        for (int c = 0; c < CG_MAX; c++) {
+            legacy_present[c] = access(legacy_controller[c].mount, F_OK) == 0;
+            if (legacy_present[c])
+                backend = CGROUP_LEGACY;
+        }
+    }
+
+    if (backend == CGROUP_NONE || !setup_groups()) {
+        log_nusantara(LOG_WARN, "No usable cgroup hierarchy, skipping cgroup placement");
+        backend = CGROUP_NONE;
+        return false;
+    }
+
+    log_nusantara(LOG_INFO, "Cgroup placement using %s hierarchy", backend == CGROUP_V2 ? "v2" : "legacy");
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : cgroup_of
+ * Inputs             : pid (pid_t) - process id
+ *                      ctrl (CgroupController) - legacy controller, ignored on v2
+ *                      out (char *) - output buffer, path relative to the mount
+ *                      len (size_t) - output buffer size
+ * Returns            : bool - true if the process has a cgroup for ctrl
+ * Description        : Looks up current cgroup of a process in /proc/<pid>/cgroup.
+ ***********************************************************************************/
+static bool cgroup_of(const pid_t pid, const CgroupController ctrl, char* out, const size_t len) {
+    char path[MAX_PATH_LENGTH];
+    char line[MAX_LINE];
+    snprintf(path, sizeof(path), "/proc/%d/cgroup", pid);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return false;
+
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), fp)) {
+        trim_newline(line);
+
+        // Format: hierarchy-ID:controller-list:cgroup-path
+        char* ctrls = strchr(line, ':');
+        char* cg_path = ctrls ? strchr(ctrls + 1, ':') : NULL;
+        if (!cg_path)
+            continue;
+        *cg_path++ = '\0';
+        ctrls++;
+
+        found = backend == CGROUP_V2 ? *ctrls == '\0' : has_token(ctrls, legacy_controller[ctrl].name);
+        if (found)
+            snprintf(out, len, "%s", cg_path);
+    }
+
+    fclose(fp);
+    return found;
+}
+
+/***********************************************************************************
+ * Function Name      : read_task_cgroups
+ * Inputs             : task (CgroupTask *) - task to fill
+ * Returns            : bool - true if every needed path was found
+ * Description        : Remembers current cgroup of a process so we can put it back.
+ ***********************************************************************************/
+static bool read_task_cgroups(CgroupTask* task) {
+    char cg_path[MAX_PATH_LENGTH];
+
+    for (int c = 0; c < CG_MAX; c++) {
+        if (backend == CGROUP_V2 && c != CG_CPU)
+            break;
+        if (backend == CGROUP_LEGACY && !legacy_present[c])
+            continue;
+
+        if (cgroup_of(task->pid, c, cg_path, sizeof(cg_path)))
+            task->orig[c] = strdup(cg_path);
+    }
+
+    return backend == CGROUP_V2 ? task->orig[CG_CPU] != NULL : true;
+}
+
+/***********************************************************************************
+ * Function Name      : still_placed
+ * Inputs             : task (CgroupTask *) - placed task
+ *                      ctrl (CgroupController) - legacy controller, ignored on v2
+ * Returns            : bool - true if the process is still where we left it
+ * Description        : ActivityManager keeps migrating processes as apps change
+ *                      state, a process it has moved since placement belongs to
+ *                      the framework again and must not be touched on restore.
+ ***********************************************************************************/
+static bool still_placed(const CgroupTask* task, const CgroupController ctrl) {
+    char cur[MAX_PATH_LENGTH];
+    char ours[MAX_PATH_LENGTH];
+
+    if (!cgroup_of(task->pid, ctrl, cur, sizeof(cur)))
+        return false;
+
+    if (backend == CGROUP_V2)
+        return strcmp(cur, task->orig[CG_CPU]) == 0;
+
+    snprintf(ours, sizeof(ours), "/%s", task->group == CG_GROUP_GAME ? CGROUP_GAME_NAME : CGROUP_BG_NAME);
+    return strcmp(cur, ours) == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : tune_task
+ * Inputs             : task (CgroupTask *) - task to tune, orig[CG_CPU] filled
+ * Returns            : bool - true if at least one knob was written
+ * Description        : cgroup v2 placement. Instead of migrating the process away
+ *                      from its uid_X/pid_Y group, which would break
+ *                      killProcessGroup, the cached app freezer and memcg
+ *                      accounting, the knobs are written on that group itself.
+ *                      cpu/cpuset are enabled below the uid group when needed and
+ *                      previous knob values are kept for cgroup_restore.
+ ***********************************************************************************/
+static bool tune_task(CgroupTask* task) {
+    char dir[MAX_PATH_LENGTH];
+    char node[MAX_PATH_LENGTH * 2];
+    char value[MAX_OUTPUT_LENGTH];
+
+    const char* cg_path = task->orig[CG_CPU];
+    const char* leaf = strrchr(cg_path, '/');
+    if (!leaf || leaf[1] == '\0')
+        return false;  // Root group has no cpu knobs
+
+    snprintf(dir, sizeof(dir), "%s%s", CGROUP_V2_ROOT, cg_path);
+
+    // Knobs only show up once the parent delegates the controllers
+    snprintf(node, sizeof(node), "%s%.*s/cgroup.subtree_control", CGROUP_V2_ROOT, (int)(leaf - cg_path), cg_path);
+    if (read_node(node, value, sizeof(value))) {
+        // Enabled one by one, cpuset is not always delegated and cpu alone still helps
+        for (int c = CG_CPU; c <= CG_CPUSET; c++) {
+            if (!has_token(value, legacy_controller[c].name) && write2file(node, false, false, "+%s", legacy_controller[c].name) == 0)
+                task->enabled |= 1 << c;
+        }
+    }
+
+    char wanted[KNOB_MAX][MAX_OUTPUT_LENGTH] = {{0}};
+    if (task->group == CG_GROUP_GAME) {
+        snprintf(wanted[KNOB_UCLAMP_MIN], sizeof(wanted[0]), "%d.00", CGROUP_GAME_UCLAMP_MIN);
+        snprintf(wanted[KNOB_WEIGHT], sizeof(wanted[0]), "%d", CGROUP_GAME_WEIGHT);
+    } else {
+        snprintf(wanted[KNOB_UCLAMP_MAX], sizeof(wanted[0]), "%d.00", CGROUP_BG_UCLAMP_MAX);
+        snprintf(wanted[KNOB_WEIGHT], sizeof(wanted[0]), "%d", CGROUP_BG_WEIGHT);
+        snprintf(wanted[KNOB_CPUS], sizeof(wanted[0]), "%s", little_cpus);
+    }
+
+    for (int k = 0; k < KNOB_MAX; k++) {
+        if (!wanted[k][0])
+            continue;
+
+        snprintf(node, sizeof(node), "%s/%s", dir, knob_name[k]);
+        if (!read_node(node, value, sizeof(value)))
+            continue;
+
+        if (write2file(node, false, false, "%s", wanted[k]) == 0) {
+            task->knob[k] = strdup(value);
+            task->moved |= 1 << CG_CPU;
+        }
+    }
+
+    return task->moved != 0;
+}
+
+/***********************************************************************************
+ * Function Name      : untune_task
+ * Inputs             : task (CgroupTask *) - tuned task
+ * Returns            : bool - true if knobs were written back
+ * Description        : Writes back knob values saved by tune_task, unless the
+ *                      framework moved the process to another group meanwhile.
+ ***********************************************************************************/
+static bool untune_task(const CgroupTask* task) {
+    char node[MAX_PATH_LENGTH * 2];
+
+    if (!task->moved || !task->orig[CG_CPU] || !still_placed(task, CG_CPU))
+        return false;
+
+    for (int k = 0; k < KNOB_MAX; k++) {
+        if (!task->knob[k])
+            continue;
+
+        snprintf(node, sizeof(node), "%s%s/%s", CGROUP_V2_ROOT, task->orig[CG_CPU], knob_name[k]);
+        // An empty cpuset.cpus means "inherit", a bare newline writes that back
+        write2file(node, false, false, "%s\n", task->knob[k]);
+    }
+
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : release_task
+ * Inputs             : task (CgroupTask *) - task to free
+ * Returns            : None
+ * Description        : Frees saved paths and knob values of a task.
+ ***********************************************************************************/
+static void release_task(CgroupTask* task) {
+    for (int c = 0; c < CG_MAX; c++)
+        free(task->orig[c]);
+    for (int k = 0; k < KNOB_MAX; k++)
+        free(task->knob[k]);
+}
+
+/***********************************************************************************
+ * Function Name      : move_task
+ * Inputs             : task (CgroupTask *) - task to move
+ *                      restore (bool) - true to move back into original cgroups
+ * Returns            : bool - true if at least one controller accepted the task
+ * Description        : Writes pid into cgroup.procs of legacy target groups. On
+ *                      restore, controllers the framework has since moved the
+ *                      process out of our group in are left alone.
+ ***********************************************************************************/
+static bool move_task(CgroupTask* task, const bool restore) {
+    char path[MAX_PATH_LENGTH];
+    char node[MAX_PATH_LENGTH * 2];
+    bool moved = false;
+
+    for (int c = 0; c < CG_MAX; c++) {
+        if (!legacy_present[c])
+            continue;
+
+        // Game keeps Android cpuset (top-app), only background is fenced
+        if (!restore && c == CG_CPUSET && task->group == CG_GROUP_GAME)
+            continue;
+        // schedtune only carries the game boost
+        if (!restore && c == CG_STUNE && task->group == CG_GROUP_BG)
+            continue;
+
+        if (restore) {
+            if (!(task->moved & (1 << c)) || !task->orig[c] || !still_placed(task, c))
+                continue;
+            snprintf(node, sizeof(node), "%s%s/cgroup.procs", legacy_controller[c].mount, task->orig[c]);
+        } else {
+            snprintf(node, sizeof(node), "%s/cgroup.procs", group_path(c, task->group, path, sizeof(path)));
+        }
+
+        if (write2file(node, false, false, "%d", task->pid) == 0) {
+            if (!restore)
+                task->moved |= 1 << c;
+            moved = true;
+        }
+    }
+
+    return moved;
+}
+
+/***********************************************************************************
+ * Function Name      : track_task
+ * Inputs             : task (const CgroupTask *) - placed task, ownership moves
+ * Returns            : bool - false if the table could not grow
+ * Description        : Caller holds the lock.
+ ***********************************************************************************/
+static bool track_task(const CgroupTask* task) {
+    if (nr_tasks == cap_tasks) {
+        int cap = cap_tasks ? cap_tasks * 2 : 64;
+        CgroupTask* grown = realloc(tasks, cap * sizeof(CgroupTask));
+        if (!grown) [[clang::unlikely]]
+            return false;
+        tasks = grown;
+        cap_tasks = cap;
+    }
+
+    tasks[nr_tasks++] = *task;
+    generation++;
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : is_tracked
+ * Inputs             : pid (pid_t) - process id
+ * Returns            : bool - true if process was already placed
+ * Description        : Checks placement table. Takes the lock, the main loop
+ *                      restores the table while placement runs.
+ ***********************************************************************************/
+static bool is_tracked(const pid_t pid) {
+    bool tracked = false;
+
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < nr_tasks && !tracked; i++)
+        tracked = tasks[i].pid == pid;
+    pthread_mutex_unlock(&lock);
+    return tracked;
+}
+
+/***********************************************************************************
+ * Function Name      : read_proc_info
+ * Inputs             : pid (pid_t) - process id
+ *                      uid (int *) - output, real UID
+ *                      oom_adj (int *) - output, oom_score_adj
+ * Returns            : bool - true on success
+ * Description        : Fetches UID and oom_score_adj of a process.
+ ***********************************************************************************/
+static bool read_proc_info(const pid_t pid, int* uid, int* oom_adj) {
+    *uid = uidof(pid);
+    if (*uid < 0)
+        return false;
+
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "/proc/%d/oom_score_adj", pid);
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return false;
+
+    bool ok = fscanf(fp, "%d", oom_adj) == 1;
+    fclose(fp);
+    return ok;
+}
+
+/***********************************************************************************
+ * Function Name      : cgroup_place_game
+ * Inputs             : pid (pid_t) - game PID
+ * Returns            : int - number of newly placed processes
+ * Description        : Moves every process of the game UID into game group and
+ *                      non-essential background apps into background group, or
+ *                      tunes their own process groups on cgroup v2.
+ *                      Safe to call repeatedly, already placed processes are
+ *                      skipped so late spawned game processes are caught.
+ ***********************************************************************************/
+int cgroup_place_game(const pid_t pid) {
+    if (backend == CGROUP_NONE || pid <= 0)
+        return 0;
+
+    int game_uid = uidof(pid);
+    if (game_uid < 0)
+        return 0;
+
+    // Different game took over, give everything back first
+    pthread_mutex_lock(&lock);
+    bool switched = placed_uid != -1 && placed_uid != game_uid;
+    pthread_mutex_unlock(&lock);
+    if (switched)
+        cgroup_restore();
+
+    pthread_mutex_lock(&lock);
+    placed_uid = game_uid;
+    pthread_mutex_unlock(&lock);
+
+    DIR* proc_dir = opendir("/proc");
+    if (!proc_dir) [[clang::unlikely]]
+        return 0;
+
+    int placed[2] = {0};
+    struct dirent* entry;
+    while ((entry = readdir(proc_dir))) {
+        if (!isdigit((unsigned char)entry->d_name[0]))
+            continue;
+
+        pid_t cur = (pid_t)atoi(entry->d_name);
+        if (is_tracked(cur))
+            continue;
+
+        int uid, oom_adj;
+        if (!read_proc_info(cur, &uid, &oom_adj))
+            continue;
+
+        CgroupGroup group;
+        if (uid == game_uid)
+            group = CG_GROUP_GAME;
+        else if (uid >= FIRST_APPLICATION_UID && oom_adj >= CGROUP_BG_MIN_OOM_ADJ)
+            group = CG_GROUP_BG;
+        else
+            continue;
+
+        CgroupTask task = {.pid = cur, .group = group};
+        bool ok = read_task_cgroups(&task) && (backend == CGROUP_V2 ? tune_task(&task) : move_task(&task, false));
+        if (!ok) {
+            release_task(&task);
+            continue;
+        }
+
+        pthread_mutex_lock(&lock);
+        ok = track_task(&task);
+        pthread_mutex_unlock(&lock);
+        if (!ok) [[clang::unlikely]] {
+            if (backend == CGROUP_V2)
+                untune_task(&task);
+            else
+                move_task(&task, true);
+            release_task(&task);
+            break;
+        }
+
+        placed[group]++;
+    }
+
+    closedir(proc_dir);
+
+    if (placed[CG_GROUP_GAME] || placed[CG_GROUP_BG])
+        log_nusantara(LOG_INFO, "Cgroup placement: %d game, %d background processes", placed[CG_GROUP_GAME], placed[CG_GROUP_BG]);
+
+    return placed[CG_GROUP_GAME] + placed[CG_GROUP_BG];
+}
+
+/***********************************************************************************
+ * Function Name      : cgroup_restore
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Moves every placed process that is still alive back into
+ *                      the exact cgroups it was in before, only for controllers
+ *                      we moved it in, or writes back its v2 knobs. Processes
+ *                      the framework re-homed since placement are skipped.
+ ***********************************************************************************/
+void cgroup_restore(void) {
+    char node[MAX_PATH_LENGTH * 2];
+    int restored = 0;
+
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < nr_tasks; i++) {
+        CgroupTask* task = &tasks[i];
+        if (kill(task->pid, 0) == 0 && (backend == CGROUP_V2 ? untune_task(task) : move_task(task, true)))
+            restored++;
+    }
+
+    // Controllers go away only after every process group below dropped its knobs
+    for (int i = 0; i < nr_tasks; i++) {
+        CgroupTask* task = &tasks[i];
+        const char* leaf = task->enabled && task->orig[CG_CPU] ? strrchr(task->orig[CG_CPU], '/') : NULL;
+        if (leaf) {
+            snprintf(node, sizeof(node), "%s%.*s/cgroup.subtree_control", CGROUP_V2_ROOT, (int)(leaf - task->orig[CG_CPU]), task->orig[CG_CPU]);
+            for (int c = CG_CPUSET; c >= CG_CPU; c--) {
+                if (task->enabled & (1 << c))
+                    write2file(node, false, false, "-%s", legacy_controller[c].name);
+            }
+        }
+        release_task(task);
+    }
+
+    if (nr_tasks > 0) {
+        log_nusantara(LOG_INFO, "Cgroup placement restored for %d of %d processes", restored, nr_tasks);
+        generation++;
+    }
+
+    nr_tasks = 0;
+    placed_uid = -1;
+    pthread_mutex_unlock(&lock);
+}
+
+/***********************************************************************************
+ * Function Name      : cgroup_generation
+ * Inputs             : None
+ * Returns            : unsigned int - changes whenever processes get placed or
+ *                                     restored
+ * Description        : Lets daemon state know its cgroup lines are outdated.
+ ***********************************************************************************/
+unsigned int cgroup_generation(void) {
+    pthread_mutex_lock(&lock);
+    unsigned int current = generation;
+    pthread_mutex_unlock(&lock);
+    return current;
+}
+
+/***********************************************************************************
+ * Function Name      : cgroup_save
+ * Inputs             : fp (FILE *) - daemon state output
+ * Returns            : None
+ * Description        : Writes every placed process with what it is restored to,
+ *                      so a restarted daemon can still hand it back:
+ *                        cgroup=<backend> <pid> <group> <moved> <enabled>
+ *                        cgroup_path=<pid> <controller> <original cgroup>
+ *                        cgroup_knob=<pid> <knob> <original value>
+ ***********************************************************************************/
+void cgroup_save(FILE* fp) {
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < nr_tasks; i++) {
+        const CgroupTask* task = &tasks[i];
+        fprintf(fp, "cgroup=%d %d %d %d %d\n", backend, task->pid, task->group, task->moved, task->enabled);
+        for (int c = 0; c < CG_MAX; c++) {
+            if (task->orig[c])
+                fprintf(fp, "cgroup_path=%d %d %s\n", task->pid, c, task->orig[c]);
+        }
+        for (int k = 0; k < KNOB_MAX; k++) {
+            if (task->knob[k])
+                fprintf(fp, "cgroup_knob=%d %d %s\n", task->pid, k, task->knob[k]);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+/***********************************************************************************
+ * Function Name      : cgroup_adopt
+ * Inputs             : key (const char *) - daemon state key written by cgroup_save
+ *                      value (const char *) - its value
+ * Returns            : None
+ * Description        : Takes over processes placed by a previous instance. They
+ *                      count as placed, so they are not snapshotted again in
+ *                      their tuned state, and get restored with the rest.
+ ***********************************************************************************/
+void cgroup_adopt(const char* key, const char* value) {
+    int pid, index, consumed = 0;
+
+    pthread_mutex_lock(&lock);
+    if (strcmp(key, "cgroup") == 0) {
+        int saved_backend, group, moved, enabled;
+        if (sscanf(value, "%d %d %d %d %d", &saved_backend, &pid, &group, &moved, &enabled) == 5 &&
+            (saved_backend == CGROUP_V2 || saved_backend == CGROUP_LEGACY) &&
+            (backend == CGROUP_NONE || backend == (CgroupBackend)saved_backend)) {
+            backend = (CgroupBackend)saved_backend;
+            for (int c = 0; backend == CGROUP_LEGACY && c < CG_MAX; c++) {
+                if (moved & (1 << c))
+                    legacy_present[c] = true;
+            }
+
+            CgroupTask task = {.pid = pid, .group = (CgroupGroup)group, .moved = (unsigned char)moved, .enabled = (unsigned char)enabled};
+            track_task(&task);
+        }
+    } else if (sscanf(value, "%d %d %n", &pid, &index, &consumed) == 2 && consumed > 0 && nr_tasks > 0 &&
+               tasks[nr_tasks - 1].pid == pid) {
+        // Path and knob lines follow the line of their process
+        CgroupTask* task = &tasks[nr_tasks - 1];
+        if (strcmp(key, "cgroup_path") == 0 && index >= 0 && index < CG_MAX && !task->orig[index])
+            task->orig[index] = strdup(value + consumed);
+        else if (strcmp(key, "cgroup_knob") == 0 && index >= 0 && index < KNOB_MAX && !task->knob[index])
+            task->knob[index] = strdup(value + consumed);
+    }
+    pthread_mutex_unlock(&lock);
+}
@@ -19,9 +19,10 @@
 /***********************************************************************************
  * Function Name      : execute_command
  * Inputs             : command (const char *) - shell command to execute
- * Returns            : char * - Pointer to the dynamically allocated output of the command
+ * Returns            : char * - Output of the command in the tick arena
  *                      variadic arguments - Additional arguments for command
  * Description        : Executes a shell command and captures its output.
+ * Note               : Output is valid until the end of the current loop tick.
  ***********************************************************************************/
 char* execute_command(const char* format, ...) {
     char command[MAX_COMMAND_LENGTH];
@@ -75,7 +76,7 @@ char* execute_command(const char* format, ...) {
     if (WEXITSTATUS(status))
         return NULL;
 
-    return strdup(trim_newline(output));
+    return arena_strndup(trim_newline(output), sizeof(output));
 }
 
 /***********************************************************************************
@@ -83,9 +84,9 @@ char* execute_command(const char* format, ...) {
  * Inputs             : path (const char *) - Path to the executable
  *                      arg0 (const char *) - First argument (typically the program name)
  *                      variadic arguments - Additional arguments, must end with NULL
- * Returns            : char * - Pointer to the dynamically allocated output of the command
+ * Returns            : char * - Output of the command in the tick arena
  * Description        : Executes a binary directly with specified arguments and captures output.
- * Note               : Caller is responsible for freeing the returned string.
+ * Note               : Output is valid until the end of the current loop tick.
  ***********************************************************************************/
 char* execute_direct(const char* path, const char* arg0, ...) {
     // Supports up to 15 arguments + NULL
@@ -146,7 +147,7 @@ char* execute_direct(const char* path, const char* arg0, ...) {
     if (WEXITSTATUS(status))
         return NULL;
 
-    return strdup(trim_newline(output));
+    return arena_strndup(trim_newline(output), sizeof(output));
 }
 
 /***********************************************************************************
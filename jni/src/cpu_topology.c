@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+CpuTopology cpu_topology = {0};
+
+const char* cluster_type_name[CLUSTER_TYPE_MAX] = {"little", "mid", "big", "prime"};
+
+/***********************************************************************************
+ * Function Name      : parse_cpu_list
+ * Inputs             : list (const char *) - "0 1 2 3" or "0-3,6" style list
+ *                      set (cpu_set_t *) - output
+ * Returns            : int - number of CPUs in the list
+ * Description        : Parses related_cpus and cpulist formats.
+ ***********************************************************************************/
+int parse_cpu_list(const char* list, cpu_set_t* set) {
+    CPU_ZERO(set);
+    const char* p = list;
+
+    while (*p) {
+        if (!isdigit((unsigned char)*p)) {
+            p++;
+            continue;
+        }
+
+        char* end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (*end == '-')
+            last = strtol(end + 1, &end, 10);
+
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+            CPU_SET(cpu, set);
+
+        p = end;
+    }
+
+    return CPU_COUNT(set);
+}
+
+/***********************************************************************************
+ * Function Name      : format_cpu_list
+ * Inputs             : set (const cpu_set_t *) - CPUs to format
+ *                      out (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : char * - out, "0-3,6" style list
+ * Description        : Formats a CPU set for cpuset.cpus and similar nodes.
+ ***********************************************************************************/
+char* format_cpu_list(const cpu_set_t* set, char* out, const size_t len) {
+    size_t used = 0;
+    out[0] = '\0';
+
+    for (int cpu = 0; cpu < CPU_SETSIZE && used < len; cpu++) {
+        if (!CPU_ISSET(cpu, set))
+            continue;
+
+        int last = cpu;
+        while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, set))
+            last++;
+
+        if (last == cpu)
+            used += snprintf(out + used, len - used, "%s%d", used ? "," : "", cpu);
+        else
+            used += snprintf(out + used, len - used, "%s%d-%d", used ? "," : "", cpu, last);
+
+        cpu = last;
+    }
+
+    return out;
+}
+
+/***********************************************************************************
+ * Function Name      : load_freq_table
+ * Inputs             : cluster (CpuCluster *) - cluster to fill
+ *                      policy_path (const char *) - cpufreq policy directory
+ * Returns            : None
+ * Description        : Loads available frequencies, falls back to the first
+ *                      column of stats/time_in_state when the driver does not
+ *                      expose scaling_available_frequencies.
+ ***********************************************************************************/
+static void load_freq_table(CpuCluster* cluster, const char* policy_path) {
+    char path[MAX_PATH_LENGTH * 2];
+    long freq;
+    cluster->nr_freqs = 0;
+
+    snprintf(path, sizeof(path), "%s/scaling_available_frequencies", policy_path);
+    FILE* fp = fopen(path, "r");
+    if (fp) {
+        while (cluster->nr_freqs < MAX_CLUSTER_FREQS && fscanf(fp, "%ld", &freq) == 1)
+            cluster->freqs[cluster->nr_freqs++] = freq;
+        fclose(fp);
+    }
+
+    if (cluster->nr_freqs == 0) {
+        snprintf(path, sizeof(path), "%s/stats/time_in_state", policy_path);
+        fp = fopen(path, "r");
+        if (fp) {
+            long ticks;
+            while (cluster->nr_freqs < MAX_CLUSTER_FREQS && fscanf(fp, "%ld %ld", &freq, &ticks) == 2)
+                cluster->freqs[cluster->nr_freqs++] = freq;
+            fclose(fp);
+        }
+    }
+
+    // Keep table ascending, some drivers list it from the top
+    for (int i = 1; i < cluster->nr_freqs; i++) {
+        long key = cluster->freqs[i];
+        int j = i - 1;
+        while (j >= 0 && cluster->freqs[j] > key) {
+            cluster->freqs[j + 1] = cluster->freqs[j];
+            j--;
+        }
+        cluster->freqs[j + 1] = key;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : cluster_score
+ * Inputs             : cluster (const CpuCluster *) - cluster
+ * Returns            : long - ordering key of cluster performance
+ * Description        : Prefers cpu_capacity (scheduler view of the core) and
+ *                      falls back to max frequency on kernels without it.
+ ***********************************************************************************/
+static long cluster_score(const CpuCluster* cluster) {
+    return cluster->capacity > 0 ? cluster->capacity * 10000000L + cluster->max_freq : cluster->max_freq;
+}
+
+/***********************************************************************************
+ * Function Name      : classify_clusters
+ * Inputs             : topo (CpuTopology *) - topology with loaded clusters
+ * Returns            : None
+ * Description        : Sorts clusters from slowest to fastest and names them.
+ *                      Two clusters are little/big, three are little/big/prime,
+ *                      four or more get mid clusters in between.
+ ***********************************************************************************/
+static void classify_clusters(CpuTopology* topo) {
+    for (int i = 1; i < topo->nr_clusters; i++) {
+        CpuCluster key = topo->cluster[i];
+        int j = i - 1;
+        while (j >= 0 && cluster_score(&topo->cluster[j]) > cluster_score(&key)) {
+            topo->cluster[j + 1] = topo->cluster[j];
+            j--;
+        }
+        topo->cluster[j + 1] = key;
+    }
+
+    int n = topo->nr_clusters;
+    for (int i = 0; i < n; i++) {
+        CpuCluster* cluster = &topo->cluster[i];
+
+        if (n == 1)
+            cluster->type = CLUSTER_BIG;
+        else if (i == 0)
+            cluster->type = CLUSTER_LITTLE;
+        else if (i == n - 1)
+            cluster->type = n == 2 ? CLUSTER_BIG : CLUSTER_PRIME;
+        else if (i == n - 2)
+            cluster->type = CLUSTER_BIG;
+        else
+            cluster->type = CLUSTER_MID;
+
+        // Same core type split in two policies, keep them in one class
+        if (i > 0 && cluster_score(cluster) == cluster_score(&topo->cluster[i - 1]))
+            cluster->type = topo->cluster[i - 1].type;
+    }
+
+    for (int i = 0; i < CLUSTER_TYPE_MAX; i++)
+        CPU_ZERO(&topo->mask[i]);
+
+    for (int i = 0; i < n; i++)
+        CPU_OR(&topo->mask[topo->cluster[i].type], &topo->mask[topo->cluster[i].type], &topo->cluster[i].cpus);
+
+    // Performance group is big + prime, falling back on SoCs with fewer clusters
+    cpu_set_t* perf = &topo->affinity[AFFINITY_PERF];
+    CPU_OR(perf, &topo->mask[CLUSTER_BIG], &topo->mask[CLUSTER_PRIME]);
+    if (CPU_COUNT(perf) == 0)
+        *perf = topo->all;
+
+    topo->affinity[AFFINITY_ALL] = topo->all;
+    topo->affinity[AFFINITY_PRIME] = CPU_COUNT(&topo->mask[CLUSTER_PRIME]) ? topo->mask[CLUSTER_PRIME] : *perf;
+}
+
+/***********************************************************************************
+ * Function Name      : topology_init
+ * Inputs             : topo (CpuTopology *) - output
+ *                      root (const char *) - filesystem root, "" on device or a
+ *                                            fixture tree for testing
+ * Returns            : bool - true if at least one cpufreq policy was found
+ * Description        : Builds the SoC model from cpufreq policies, related_cpus,
+ *                      cpu_capacity, topology/cluster_id and cpuinfo_max_freq.
+ ***********************************************************************************/
+bool topology_init(CpuTopology* topo, const char* root) {
+    char path[MAX_PATH_LENGTH * 2];
+    memset(topo, 0, sizeof(*topo));
+
+    snprintf(path, sizeof(path), "%s/sys/devices/system/cpu/cpufreq", root);
+    DIR* dir = opendir(path);
+    if (!dir) [[clang::unlikely]] {
+        log_nusantara(LOG_ERROR, "Unable to open %s", path);
+        return false;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) && topo->nr_clusters < MAX_CLUSTERS) {
+        int policy;
+        if (sscanf(entry->d_name, "policy%d", &policy) != 1)
+            continue;
+
+        char policy_path[MAX_PATH_LENGTH];
+        snprintf(policy_path, sizeof(policy_path), "%s/sys/devices/system/cpu/cpufreq/policy%d", root, policy);
+
+        CpuCluster* cluster = &topo->cluster[topo->nr_clusters];
+        cluster->policy = policy;
+
+        char related[MAX_OUTPUT_LENGTH] = {0};
+        snprintf(path, sizeof(path), "%s/related_cpus", policy_path);
+        FILE* fp = fopen(path, "r");
+        if (fp) {
+            if (!fgets(related, sizeof(related), fp))
+                related[0] = '\0';
+            fclose(fp);
+        }
+
+        cluster->nr_cpus = parse_cpu_list(related, &cluster->cpus);
+        if (cluster->nr_cpus == 0) {
+            CPU_SET(policy, &cluster->cpus);
+            cluster->nr_cpus = 1;
+        }
+
+        snprintf(path, sizeof(path), "%s/cpuinfo_max_freq", policy_path);
+        cluster->max_freq = read_long(path, 0);
+        snprintf(path, sizeof(path), "%s/cpuinfo_min_freq", policy_path);
+        cluster->min_freq = read_long(path, 0);
+
+        snprintf(path, sizeof(path), "%s/sys/devices/system/cpu/cpu%d/cpu_capacity", root, policy);
+        cluster->capacity = read_long(path, 0);
+        snprintf(path, sizeof(path), "%s/sys/devices/system/cpu/cpu%d/topology/cluster_id", root, policy);
+        cluster->cluster_id = (int)read_long(path, -1);
+
+        load_freq_table(cluster, policy_path);
+        CPU_OR(&topo->all, &topo->all, &cluster->cpus);
+        topo->nr_clusters++;
+    }
+
+    closedir(dir);
+
+    if (topo->nr_clusters == 0) [[clang::unlikely]]
+        return false;
+
+    topo->nr_cpus = CPU_COUNT(&topo->all);
+    classify_clusters(topo);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : topology_cluster
+ * Inputs             : type (ClusterType) - wanted cluster class
+ * Returns            : const CpuCluster * - first cluster of that class, or NULL
+ * Description        : Looks up a cluster of the global topology by class.
+ ***********************************************************************************/
+const CpuCluster* topology_cluster(const ClusterType type) {
+    for (int i = 0; i < cpu_topology.nr_clusters; i++) {
+        if (cpu_topology.cluster[i].type == type)
+            return &cpu_topology.cluster[i];
+    }
+
+    return NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : topology_dump
+ * Inputs             : topo (const CpuTopology *) - topology to export
+ *                      filename (const char *) - output file
+ * Returns            : int - 0 on success, -1 on error
+ * Description        : Exports one line per cluster for shell scripts:
+ *                      <policy> <class> <first cpu>-<last cpu> <capacity> <min> <max>
+ ***********************************************************************************/
+int topology_dump(const CpuTopology* topo, const char* filename) {
+    FILE* fp = fopen(filename, "w");
+    if (!fp)
+        return -1;
+
+    for (int i = 0; i < topo->nr_clusters; i++) {
+        const CpuCluster* cluster = &topo->cluster[i];
+        int first = -1, last = -1;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (!CPU_ISSET(cpu, &cluster->cpus))
+                continue;
+            if (first == -1)
+                first = cpu;
+            last = cpu;
+        }
+
+        fprintf(fp, "policy%d %s %d-%d %ld %ld %ld\n", cluster->policy, cluster_type_name[cluster->type], first, last,
+                cluster->capacity, cluster->min_freq, cluster->max_freq);
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : affinity_mask
+ * Inputs             : affinity (ThreadAffinity) - wanted core group
+ * Returns            : const cpu_set_t * - mask of core group, NULL if unknown
+ * Description        : Returns ready-made affinity mask of the global topology.
+ ***********************************************************************************/
+const cpu_set_t* affinity_mask(const ThreadAffinity affinity) {
+    if (cpu_topology.nr_clusters == 0) [[clang::unlikely]]
+        return NULL;
+
+    return &cpu_topology.affinity[affinity];
+}
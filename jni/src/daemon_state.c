@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+static DaemonState saved = {.mode = PROFILE_MODE_MAX};
+static unsigned int saved_generation = 0;
+
+/***********************************************************************************
+ * Function Name      : snapshot_generation
+ * Inputs             : None
+ * Returns            : unsigned int - changes with any saved snapshot
+ * Description        : Each counter only grows, so their sum moves whenever
+ *                      frozen groups, steered IRQs or placed processes change.
+ ***********************************************************************************/
+static unsigned int snapshot_generation(void) {
+    return app_freezer_generation() + irq_generation() + cgroup_generation();
+}
+
+/***********************************************************************************
+ * Function Name      : read_boot_id
+ * Inputs             : out (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : None
+ * Description        : Kernel boot id, changes on every boot.
+ ***********************************************************************************/
+static void read_boot_id(char* out, const size_t len) {
+    out[0] = '\0';
+
+    FILE* fp = fopen(BOOT_ID_PATH, "r");
+    if (!fp) [[clang::unlikely]]
+        return;
+
+    if (fgets(out, len, fp))
+        trim_newline(out);
+    else
+        out[0] = '\0';
+    fclose(fp);
+}
+
+/***********************************************************************************
+ * Function Name      : state_save
+ * Inputs             : mode (ProfileMode) - profile in effect
+ * Returns            : None
+ * Description        : Persists what the daemon applied, tagged with the boot
+ *                      id. Rewritten only when profile, boosted game or the
+ *                      snapshots taken for it change, through a temporary file
+ *                      and rename. Freezing, IRQ steering and cgroup placement
+ *                      follow the profile by a round or more, their lines must
+ *                      not wait for the next game.
+ ***********************************************************************************/
+void state_save(const ProfileMode mode) {
+    const GameSession* active = mode == PERFORMANCE_PROFILE ? session_active() : NULL;
+    const char* game = active ? active->package : "";
+    pid_t pid = active ? active->pid : 0;
+    unsigned int generation = snapshot_generation();
+
+    if (saved.mode == mode && saved.pid == pid && strcmp(saved.game, game) == 0 && saved_generation == generation)
+        return;
+
+    if (!saved.boot_id[0])
+        read_boot_id(saved.boot_id, sizeof(saved.boot_id));
+
+    FILE* fp = fopen(DAEMON_STATE ".tmp", "w");
+    if (!fp) [[clang::unlikely]]
+        return;
+
+    fprintf(fp, "boot_id=%s\n", saved.boot_id);
+    fprintf(fp, "profile=%s\n", profile_mode_name[mode]);
+    fprintf(fp, "game=%s\n", game);
+    fprintf(fp, "pid=%d\n", pid);
+    if (active) {
+        app_freezer_save(fp);
+        irq_save(fp);
+        cgroup_save(fp);
+    }
+
+    fclose(fp);
+    if (rename(DAEMON_STATE ".tmp", DAEMON_STATE) != 0) [[clang::unlikely]]
+        return;
+
+    saved.mode = mode;
+    saved.pid = pid;
+    snprintf(saved.game, sizeof(saved.game), "%s", game);
+    saved_generation = generation;
+}
+
+/***********************************************************************************
+ * Function Name      : state_restore
+ * Inputs             : state (DaemonState *) - receives saved state
+ * Returns            : bool - true if state was saved earlier in this boot
+ * Description        : A daemon restarted within the same boot finds its tuning
+ *                      still applied. Groups frozen, IRQs steered and processes
+ *                      placed by the previous instance are adopted so they get
+ *                      restored to their real originals later.
+ ***********************************************************************************/
+bool state_restore(DaemonState* state) {
+    memset(state, 0, sizeof(*state));
+    state->mode = PROFILE_MODE_MAX;
+
+    FILE* fp = fopen(DAEMON_STATE, "r");
+    if (!fp)
+        return false;
+
+    char boot_id[sizeof(state->boot_id)];
+    read_boot_id(boot_id, sizeof(boot_id));
+
+    char line[MAX_LINE];
+    bool same_boot = false;
+
+    while (fgets(line, sizeof(line), fp)) {
+        trim_newline(line);
+        char* value = strchr(line, '=');
+        if (!value)
+            continue;
+        *value++ = '\0';
+
+        // boot_id comes first, nothing else counts from an older boot
+        if (strcmp(line, "boot_id") == 0) {
+            same_boot = boot_id[0] && strcmp(value, boot_id) == 0;
+            if (!same_boot)
+                break;
+            snprintf(state->boot_id, sizeof(state->boot_id), "%s", value);
+        } else if (!same_boot) {
+            break;
+        } else if (strcmp(line, "profile") == 0) {
+            for (int i = 0; i < PROFILE_MODE_MAX; i++) {
+                if (strcmp(value, profile_mode_name[i]) == 0)
+                    state->mode = (ProfileMode)i;
+            }
+        } else if (strcmp(line, "game") == 0) {
+            snprintf(state->game, sizeof(state->game), "%s", value);
+        } else if (strcmp(line, "pid") == 0) {
+            state->pid = (pid_t)atoi(value);
+        } else if (strcmp(line, "frozen") == 0) {
+            app_freezer_adopt(value);
+        } else if (strcmp(line, "irq") == 0) {
+            irq_adopt(value);
+        } else if (strncmp(line, "cgroup", 6) == 0) {
+            cgroup_adopt(line, value);
+        }
+    }
+
+    fclose(fp);
+
+    if (!same_boot || state->mode == PROFILE_MODE_MAX)
+        return false;
+
+    saved = *state;
+    saved_generation = snapshot_generation();
+    return true;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+/***********************************************************************************
+ * Function Name      : write_status
+ * Inputs             : mode (ProfileMode) - current profile
+ *                      fsm (const ProfileFsm *) - profile state machine
+ * Returns            : None
+ * Description        : Publishes daemon state as key=value lines. Written to a
+ *                      temporary file and renamed, so readers like WebUI never
+ *                      see a half written status.
+ ***********************************************************************************/
+void write_status(const ProfileMode mode, const ProfileFsm* fsm) {
+    FILE* fp = fopen(DAEMON_STATUS ".tmp", "w");
+    if (!fp) [[clang::unlikely]]
+        return;
+
+    fprintf(fp, "updated=%ld\n", (long)time(NULL));
+    fprintf(fp, "profile=%s\n", profile_mode_name[mode]);
+    fprintf(fp, "game=%s\n", gamestart ? gamestart : "");
+    fprintf(fp, "game_pid=%d\n", game_pid);
+    fprintf(fp, "perf_level=%s\n", mode == PERFORMANCE_PROFILE ? perf_level_name[perf_controller_level()] : "none");
+    profile_fsm_status(fsm, fp);
+    session_status(fp);
+    retention_status(fp);
+    launch_status(fp);
+    touch_status(fp);
+    executor_status(fp);
+    thermal_status(fp);
+    gpu_status(fp);
+    io_boost_status(fp);
+    net_monitor_status(fp);
+    irq_status(fp);
+    energy_status(fp);
+    arena_status(fp);
+
+    fclose(fp);
+    rename(DAEMON_STATUS ".tmp", DAEMON_STATUS);
+}
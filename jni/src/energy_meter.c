@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+typedef struct {
+    long long energy_mj;
+    long long time_ms;
+    unsigned long long freq_weight[MAX_CLUSTERS];  // kHz * time_in_state ticks
+    unsigned long long freq_time[MAX_CLUSTERS];
+} ProfileEnergy;
+
+static ProfileEnergy profile_energy[PROFILE_MODE_MAX];
+static unsigned long long tis_last[MAX_CLUSTERS][MAX_CLUSTER_FREQS];
+static char last_package[MAX_PACKAGE] = {0};
+static ProfileMode last_mode = PERFCOMMON;
+static long last_power_mw = -1;
+static long long last_counter_uwh = -1;
+static struct timespec last_sample = {0};
+static bool use_counter = false;
+static bool charging = false;
+
+/***********************************************************************************
+ * Function Name      : read_power
+ * Inputs             : None
+ * Returns            : long - battery discharge power in mW, -1 if unknown
+ * Description        : Vendors disagree on the sign of current_now and a few
+ *                      report mA instead of uA, a phone never draws under 10mA
+ *                      so smaller magnitudes are taken as mA.
+ ***********************************************************************************/
+static long read_power(void) {
+    long current = read_long(BATTERY_SUPPLY "/current_now", LONG_MIN);
+    long voltage = read_long(BATTERY_SUPPLY "/voltage_now", 0);
+    if (current == LONG_MIN || voltage <= 0)
+        return -1;
+
+    if (current < 0)
+        current = -current;
+    if (current < 10000)
+        current *= 1000;
+
+    // uA * mV is nW * 1000
+    return (long)((long long)current * (voltage / 1000) / 1000000);
+}
+
+/***********************************************************************************
+ * Function Name      : sample_clusters
+ * Inputs             : energy (ProfileEnergy *) - profile the interval belongs to
+ *                      session (GameSession *) - boosted game, NULL if none
+ * Returns            : None
+ * Description        : Accumulates frequency residency of every cluster from
+ *                      cpufreq stats/time_in_state deltas.
+ ***********************************************************************************/
+static void sample_clusters(ProfileEnergy* energy, GameSession* session) {
+    for (int c = 0; c < cpu_topology.nr_clusters; c++) {
+        char path[MAX_PATH_LENGTH];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpufreq/policy%d/stats/time_in_state", cpu_topology.cluster[c].policy);
+        FILE* fp = fopen(path, "r");
+        if (!fp)
+            continue;
+
+        long freq;
+        unsigned long long time;
+        int idx = 0;
+        while (idx < MAX_CLUSTER_FREQS && fscanf(fp, "%ld %llu", &freq, &time) == 2) {
+            unsigned long long delta = tis_last[c][idx] ? time - tis_last[c][idx] : 0;
+            tis_last[c][idx++] = time;
+            if (energy) {
+                energy->freq_weight[c] += delta * (unsigned long long)freq;
+                energy->freq_time[c] += delta;
+            }
+            if (session && c < HISTORY_CLUSTERS) {
+                session->freq_weight[c] += delta * (unsigned long long)freq;
+                session->freq_time[c] += delta;
+            }
+        }
+        fclose(fp);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : energy_tick
+ * Inputs             : mode (ProfileMode) - profile in effect from now on
+ * Returns            : None
+ * Description        : Once per round. Energy of the interval since the last
+ *                      sample is the trapezoid of both power readings, or the
+ *                      energy_now delta on gauges without current_now. It goes
+ *                      to the profile and game session that were in effect
+ *                      during the interval. Time on the charger is skipped,
+ *                      the battery then measures the charger instead.
+ ***********************************************************************************/
+void energy_tick(const ProfileMode mode) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long elapsed_ms = (now.tv_sec - last_sample.tv_sec) * 1000 + (now.tv_nsec - last_sample.tv_nsec) / 1000000;
+    bool first = last_sample.tv_sec == 0;
+    last_sample = now;
+
+    char status[32] = {0};
+    FILE* fp = fopen(BATTERY_SUPPLY "/status", "r");
+    if (fp) {
+        if (!fgets(status, sizeof(status), fp))
+            status[0] = '\0';
+        fclose(fp);
+    }
+    bool was_charging = charging;
+    charging = strncmp(status, "Charging", 8) == 0 || strncmp(status, "Full", 4) == 0;
+
+    long power = read_power();
+    long long counter = read_long(BATTERY_SUPPLY "/energy_now", -1);
+    use_counter = power < 0 && counter >= 0;
+
+    long long energy_mj = -1;
+    if (!first && !was_charging && !charging && elapsed_ms > 0) {
+        if (power >= 0 && last_power_mw >= 0)
+            energy_mj = (long long)(power + last_power_mw) * elapsed_ms / 2000;
+        else if (use_counter && last_counter_uwh > counter)
+            energy_mj = (last_counter_uwh - counter) * 36 / 10;
+    }
+
+    ProfileEnergy* energy = energy_mj >= 0 ? &profile_energy[last_mode] : NULL;
+    GameSession* session = last_mode == PERFORMANCE_PROFILE ? session_find(last_package) : NULL;
+    sample_clusters(energy, session);
+
+    if (energy) {
+        energy->energy_mj += energy_mj;
+        energy->time_ms += elapsed_ms;
+
+        if (session) {
+            session->energy_mj += energy_mj;
+            session->metered_ms += elapsed_ms;
+        }
+    }
+
+    const GameSession* active = mode == PERFORMANCE_PROFILE ? session_active() : NULL;
+    snprintf(last_package, sizeof(last_package), "%s", active ? active->package : "");
+    last_power_mw = power;
+    last_counter_uwh = counter;
+    last_mode = mode;
+}
+
+/***********************************************************************************
+ * Function Name      : energy_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes energy section of daemon status, one line per
+ *                      profile with its energy, metered time, average power
+ *                      and average frequency of each cluster.
+ ***********************************************************************************/
+void energy_status(FILE* fp) {
+    fprintf(fp, "energy_source=%s\n", last_power_mw >= 0 ? "current" : use_counter ? "counter" : "none");
+    fprintf(fp, "energy_power_mw=%ld\n", charging ? -1 : last_power_mw);
+
+    for (int m = 0; m < PROFILE_MODE_MAX; m++) {
+        const ProfileEnergy* energy = &profile_energy[m];
+        if (energy->time_ms == 0)
+            continue;
+
+        fprintf(fp, "energy_%s=mj=%lld s=%lld mw=%lld", profile_mode_name[m], energy->energy_mj, energy->time_ms / 1000,
+                energy->energy_mj * 1000 / energy->time_ms);
+        for (int c = 0; c < cpu_topology.nr_clusters; c++) {
+            if (energy->freq_time[c] > 0)
+                fprintf(fp, " %s%d_mhz=%llu", cluster_type_name[cpu_topology.cluster[c].type], cpu_topology.cluster[c].policy,
+                        energy->freq_weight[c] / energy->freq_time[c] / 1000);
+        }
+        fputc('\n', fp);
+    }
+}
@@ -94,3 +94,41 @@ int create_lock_file(void) {
 
     return 0;
 }
+
+/***********************************************************************************
+ * Function Name      : is_enabled
+ * Inputs             : filename (const char *) - path to a 0/1 config node
+ * Returns            : bool - true if node exists and starts with '1'
+ * Description        : Reads a boolean toggle from module config directory.
+ ***********************************************************************************/
+bool is_enabled(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    char value = '0';
+    ssize_t len = read(fd, &value, 1);
+    close(fd);
+
+    return len == 1 && value == '1';
+}
+
+/***********************************************************************************
+ * Function Name      : read_long
+ * Inputs             : filename (const char *) - path to a numeric node
+ *                      fallback (long) - value returned on error
+ * Returns            : long - first integer in the node
+ * Description        : Reads a single integer from sysfs, procfs or config node.
+ ***********************************************************************************/
+long read_long(const char* filename, const long fallback) {
+    FILE* fp = fopen(filename, "r");
+    if (!fp)
+        return fallback;
+
+    long value;
+    if (fscanf(fp, "%ld", &value) != 1)
+        value = fallback;
+
+    fclose(fp);
+    return value;
+}
@@ -0,0 +1,498 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <regex.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+typedef struct {
+    uint32_t hash;
+    uint32_t name;  // offset in name pool
+    int profile;    // index in profiles, -1 for defaults
+} GameEntry;
+
+typedef struct {
+    GameEntry* entries;
+    int nr_entries;
+    int cap_entries;
+    uint32_t* slots;  // entry index + 1, 0 is empty
+    uint32_t nr_slots;
+    char* pool;
+    size_t pool_len;
+    size_t pool_cap;
+    GameProfile* profiles;
+    int nr_profiles;
+    regex_t regex;
+    bool has_regex;
+} GameTable;
+
+static const GameProfile default_profile = {
+    .governor = "",
+    .floor_pct = -1,
+    .preload = true,
+    .preload_budget_mb = 0,
+    .cgroup = true,
+    .background = GAME_BG_NEVER,
+};
+
+static GameTable table = {0};
+static time_t gamelist_mtime = 0;
+static time_t config_mtime = 0;
+
+/***********************************************************************************
+ * Function Name      : hash_name
+ * Inputs             : name (const char *) - package name
+ *                      len (size_t) - length of name
+ * Returns            : uint32_t - FNV-1a hash
+ ***********************************************************************************/
+static uint32_t hash_name(const char* name, const size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/***********************************************************************************
+ * Function Name      : table_free
+ * Inputs             : t (GameTable *) - table
+ * Returns            : None
+ ***********************************************************************************/
+static void table_free(GameTable* t) {
+    free(t->entries);
+    free(t->slots);
+    free(t->pool);
+    free(t->profiles);
+    if (t->has_regex)
+        regfree(&t->regex);
+    memset(t, 0, sizeof(*t));
+}
+
+/***********************************************************************************
+ * Function Name      : table_find
+ * Inputs             : t (const GameTable *) - table
+ *                      name (const char *) - package name
+ *                      len (size_t) - length of name
+ * Returns            : GameEntry * - entry, NULL if not a game
+ * Description        : Open addressing lookup, linear probing.
+ ***********************************************************************************/
+static GameEntry* table_find(const GameTable* t, const char* name, const size_t len) {
+    if (t->nr_slots == 0)
+        return NULL;
+
+    uint32_t hash = hash_name(name, len);
+    for (uint32_t i = hash & (t->nr_slots - 1);; i = (i + 1) & (t->nr_slots - 1)) {
+        uint32_t slot = t->slots[i];
+        if (slot == 0)
+            return NULL;
+
+        GameEntry* entry = &t->entries[slot - 1];
+        const char* entry_name = t->pool + entry->name;
+        if (entry->hash == hash && strncmp(entry_name, name, len) == 0 && entry_name[len] == '\0')
+            return entry;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : table_grow
+ * Inputs             : t (GameTable *) - table
+ * Returns            : bool - true on success
+ * Description        : Doubles slot count and rehashes entries, keeping slots at
+ *                      most half full.
+ ***********************************************************************************/
+static bool table_grow(GameTable* t) {
+    uint32_t nr_slots = t->nr_slots ? t->nr_slots * 2 : 1024;
+    uint32_t* slots = calloc(nr_slots, sizeof(uint32_t));
+    if (!slots)
+        return false;
+
+    for (int e = 0; e < t->nr_entries; e++) {
+        uint32_t i = t->entries[e].hash & (nr_slots - 1);
+        while (slots[i] != 0)
+            i = (i + 1) & (nr_slots - 1);
+        slots[i] = (uint32_t)e + 1;
+    }
+
+    free(t->slots);
+    t->slots = slots;
+    t->nr_slots = nr_slots;
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : table_add
+ * Inputs             : t (GameTable *) - table
+ *                      name (const char *) - package name
+ *                      len (size_t) - length of name
+ * Returns            : GameEntry * - new or existing entry, NULL on allocation failure
+ * Description        : Appends name to the pool and entry to the slots.
+ ***********************************************************************************/
+static GameEntry* table_add(GameTable* t, const char* name, const size_t len) {
+    GameEntry* found = table_find(t, name, len);
+    if (found)
+        return found;
+
+    if ((uint32_t)(t->nr_entries + 1) * 2 > t->nr_slots && !table_grow(t))
+        return NULL;
+
+    if (t->nr_entries == t->cap_entries) {
+        int cap = t->cap_entries ? t->cap_entries * 2 : 256;
+        GameEntry* entries = realloc(t->entries, cap * sizeof(GameEntry));
+        if (!entries)
+            return NULL;
+        t->entries = entries;
+        t->cap_entries = cap;
+    }
+
+    if (t->pool_len + len + 1 > t->pool_cap) {
+        size_t cap = t->pool_cap ? t->pool_cap * 2 : 16384;
+        while (cap < t->pool_len + len + 1)
+            cap *= 2;
+        char* pool = realloc(t->pool, cap);
+        if (!pool)
+            return NULL;
+        t->pool = pool;
+        t->pool_cap = cap;
+    }
+
+    memcpy(t->pool + t->pool_len, name, len);
+    t->pool[t->pool_len + len] = '\0';
+
+    GameEntry* entry = &t->entries[t->nr_entries];
+    entry->hash = hash_name(name, len);
+    entry->name = (uint32_t)t->pool_len;
+    entry->profile = -1;
+    t->pool_len += len + 1;
+
+    uint32_t i = entry->hash & (t->nr_slots - 1);
+    while (t->slots[i] != 0)
+        i = (i + 1) & (t->nr_slots - 1);
+    t->slots[i] = (uint32_t)++t->nr_entries;
+    return entry;
+}
+
+/***********************************************************************************
+ * Function Name      : is_pattern
+ * Inputs             : name (const char *) - gamelist entry
+ *                      len (size_t) - length of entry
+ * Returns            : bool - true if entry uses regex syntax beyond plain dots
+ ***********************************************************************************/
+static bool is_pattern(const char* name, const size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (strchr("*+?[]()^$\\{}", name[i]))
+            return true;
+    }
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : load_gamelist
+ * Inputs             : t (GameTable *) - table
+ * Returns            : int - number of games loaded
+ * Description        : Gamelist is '|' joined (as installed) or one package per
+ *                      line. Plain package names go into the hash table, the
+ *                      rare regex entry is compiled into one fallback pattern.
+ ***********************************************************************************/
+static int load_gamelist(GameTable* t) {
+    FILE* fp = fopen(GAMELIST, "r");
+    if (!fp)
+        return 0;
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    rewind(fp);
+    if (size <= 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    char* data = malloc(size + 1);
+    if (!data) {
+        fclose(fp);
+        return 0;
+    }
+
+    size_t got = fread(data, 1, size, fp);
+    data[got] = '\0';
+    fclose(fp);
+
+    char* patterns = NULL;
+    size_t patterns_len = 0;
+    int count = 0;
+
+    for (char* p = data; *p;) {
+        size_t len = strcspn(p, "|\r\n \t");
+        if (len > 0 && len < MAX_PACKAGE) {
+            if (is_pattern(p, len)) {
+                char* grown = realloc(patterns, patterns_len + len + 2);
+                if (grown) {
+                    patterns = grown;
+                    if (patterns_len > 0)
+                        patterns[patterns_len++] = '|';
+                    memcpy(patterns + patterns_len, p, len);
+                    patterns_len += len;
+                    patterns[patterns_len] = '\0';
+                    count++;
+                }
+            } else if (table_add(t, p, len)) {
+                count++;
+            }
+        }
+
+        p += len;
+        if (*p)
+            p++;
+    }
+
+    free(data);
+
+    if (patterns) {
+        t->has_regex = regcomp(&t->regex, patterns, REG_EXTENDED | REG_NOSUB) == 0;
+        if (!t->has_regex)
+            log_nusantara(LOG_WARN, "Invalid pattern in gamelist: %s", patterns);
+        free(patterns);
+    }
+
+    return count;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_option
+ * Inputs             : profile (GameProfile *) - profile to fill
+ *                      key (const char *) - option name
+ *                      value (char *) - option value
+ * Returns            : bool - false for unknown option
+ ***********************************************************************************/
+static bool parse_option(GameProfile* profile, const char* key, char* value) {
+    if (strcmp(key, "governor") == 0) {
+        snprintf(profile->governor, sizeof(profile->governor), "%s", value);
+    } else if (strcmp(key, "floor") == 0) {
+        int pct = atoi(value);
+        profile->floor_pct = pct < 0 ? 0 : (pct > 100 ? 100 : pct);
+    } else if (strcmp(key, "preload") == 0) {
+        profile->preload = atoi(value) != 0;
+    } else if (strcmp(key, "preload_budget") == 0) {
+        profile->preload_budget_mb = atol(value);
+    } else if (strcmp(key, "cgroup") == 0) {
+        profile->cgroup = atoi(value) != 0;
+    } else if (strcmp(key, "secondary") == 0) {
+        for (char* name = strtok(value, ","); name && profile->nr_secondary < MAX_SECONDARY_PROCS; name = strtok(NULL, ","))
+            snprintf(profile->secondary[profile->nr_secondary++], MAX_PACKAGE, "%s", name);
+    } else if (strcmp(key, "render") == 0) {
+        snprintf(profile->render, sizeof(profile->render), "%s", value);
+    } else if (strcmp(key, "background") == 0) {
+        if (strcmp(value, "render_missing") == 0)
+            profile->background = GAME_BG_RENDER_MISSING;
+        else if (strcmp(value, "oom_adj") == 0)
+            profile->background = GAME_BG_OOM_ADJ;
+        else if (strcmp(value, "never") == 0)
+            profile->background = GAME_BG_NEVER;
+        else
+            return false;
+    } else if (strcmp(key, "thread") == 0) {
+        // thread=<comm prefix>:<class>,...
+        for (char* item = strtok(value, ","); item && profile->nr_threads < MAX_GAME_THREAD_PATTERNS; item = strtok(NULL, ",")) {
+            char* cls = strrchr(item, ':');
+            if (!cls)
+                continue;
+            *cls++ = '\0';
+
+            for (int c = THREAD_MAIN; c < THREAD_CLASS_MAX; c++) {
+                if (strcmp(cls, thread_class_name[c]) != 0)
+                    continue;
+
+                ThreadPattern* pattern = &profile->threads[profile->nr_threads++];
+                snprintf(pattern->pattern, sizeof(pattern->pattern), "%s", item);
+                pattern->cls = c;
+                break;
+            }
+        }
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : load_game_config
+ * Inputs             : t (GameTable *) - table
+ * Returns            : int - number of tuned games
+ * Description        : One game per line, package followed by key=value
+ *                      overrides. Listed games count as games even when
+ *                      they are missing from gamelist.
+ ***********************************************************************************/
+static int load_game_config(GameTable* t) {
+    FILE* fp = fopen(GAME_CONFIG, "r");
+    if (!fp)
+        return 0;
+
+    char line[MAX_LINE * 2];
+    int count = 0;
+    int lineno = 0;
+
+    while (fgets(line, sizeof(line), fp)) {
+        lineno++;
+        char* save;
+        char* package = strtok_r(line, " \t\r\n", &save);
+        if (!package || package[0] == '#')
+            continue;
+
+        GameProfile profile = default_profile;
+        profile.background = GAME_BG_AUTO;
+        for (char* opt = strtok_r(NULL, " \t\r\n", &save); opt; opt = strtok_r(NULL, " \t\r\n", &save)) {
+            char* value = strchr(opt, '=');
+            if (!value) {
+                log_nusantara(LOG_WARN, "gameconfig line %d: expected key=value, got %s", lineno, opt);
+                continue;
+            }
+            *value++ = '\0';
+            if (!parse_option(&profile, opt, value))
+                log_nusantara(LOG_WARN, "gameconfig line %d: unknown option %s", lineno, opt);
+        }
+
+        // Render process alone means the game is in background without it
+        if (profile.background == GAME_BG_AUTO)
+            profile.background = profile.render[0] ? GAME_BG_RENDER_MISSING : GAME_BG_NEVER;
+
+        GameEntry* entry = table_add(t, package, strlen(package));
+        if (!entry)
+            break;
+
+        GameProfile* profiles = realloc(t->profiles, (t->nr_profiles + 1) * sizeof(GameProfile));
+        if (!profiles)
+            break;
+        t->profiles = profiles;
+        t->profiles[t->nr_profiles] = profile;
+        entry->profile = t->nr_profiles++;
+        count++;
+    }
+
+    fclose(fp);
+    return count;
+}
+
+/***********************************************************************************
+ * Function Name      : file_mtime
+ * Inputs             : filename (const char *) - file
+ * Returns            : time_t - modification time, 0 if missing
+ ***********************************************************************************/
+static time_t file_mtime(const char* filename) {
+    struct stat st;
+    return stat(filename, &st) == 0 ? st.st_mtime : 0;
+}
+
+/***********************************************************************************
+ * Function Name      : game_config_refresh
+ * Inputs             : None
+ * Returns            : bool - true if the table was (re)built
+ * Description        : Rebuilds the game table when gamelist or gameconfig
+ *                      changed on disk. Only two stat() calls otherwise.
+ ***********************************************************************************/
+bool game_config_refresh(void) {
+    time_t list_mtime = file_mtime(GAMELIST);
+    time_t cfg_mtime = file_mtime(GAME_CONFIG);
+    if (table.slots && list_mtime == gamelist_mtime && cfg_mtime == config_mtime)
+        return false;
+
+    GameTable fresh = {0};
+    int games = load_gamelist(&fresh);
+    int tuned = load_game_config(&fresh);
+
+    if (!fresh.slots && !table_grow(&fresh)) [[clang::unlikely]] {
+        log_nusantara(LOG_ERROR, "Unable to build game table, keeping previous one");
+        table_free(&fresh);
+        return false;
+    }
+
+    table_free(&table);
+    table = fresh;
+    gamelist_mtime = list_mtime;
+    config_mtime = cfg_mtime;
+
+    log_nusantara(LOG_INFO, "Game table loaded: %d gamelist entries, %d tuned games, %d slots", games, tuned,
+                  table.nr_slots);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : game_config_match
+ * Inputs             : name (const char *) - candidate package name
+ *                      len (size_t) - length of name
+ * Returns            : bool - true if the package is a game
+ ***********************************************************************************/
+bool game_config_match(const char* name, const size_t len) {
+    if (len == 0 || len >= MAX_PACKAGE)
+        return false;
+
+    if (table_find(&table, name, len))
+        return true;
+
+    if (!table.has_regex)
+        return false;
+
+    char package[MAX_PACKAGE];
+    memcpy(package, name, len);
+    package[len] = '\0';
+    return regexec(&table.regex, package, 0, NULL, 0) == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : game_config_get
+ * Inputs             : package (const char *) - game package name
+ * Returns            : const GameProfile * - overrides of the game, defaults when
+ *                                            the game has none
+ * Note               : Pointer is valid until next reload, copy it to keep it
+ *                      for a whole session.
+ ***********************************************************************************/
+const GameProfile* game_config_get(const char* package) {
+    if (!package)
+        return &default_profile;
+
+    GameEntry* entry = table_find(&table, package, strlen(package));
+    if (!entry || entry->profile < 0)
+        return &default_profile;
+
+    return &table.profiles[entry->profile];
+}
+
+/***********************************************************************************
+ * Function Name      : game_config_apply
+ * Inputs             : profile (const GameProfile *) - game overrides
+ * Returns            : None
+ * Description        : Writes governor and frequency floor overrides on top of
+ *                      performance profile. Runs before performance controller
+ *                      snapshots them, so they become its top level.
+ ***********************************************************************************/
+void game_config_apply(const GameProfile* profile) {
+    char path[MAX_PATH_LENGTH];
+
+    for (int c = 0; c < cpu_topology.nr_clusters; c++) {
+        const CpuCluster* cluster = &cpu_topology.cluster[c];
+
+        if (profile->governor[0]) {
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpufreq/policy%d/scaling_governor", cluster->policy);
+            write2file(path, false, false, "%s", profile->governor);
+        }
+
+        if (profile->floor_pct >= 0 && cluster->nr_freqs > 0) {
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpufreq/policy%d/scaling_min_freq", cluster->policy);
+            write2file(path, false, false, "%ld", cluster->freqs[(cluster->nr_freqs - 1) * profile->floor_pct / 100]);
+        }
+    }
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+static char retained_package[MAX_PACKAGE] = {0};
+static pid_t retained_pid = 0;
+static int retained_uid = 0;
+static time_t retained_since = 0;
+static long saved_memory_low = -1;
+static int rounds = 0;
+static int nr_warm = 0;
+static int nr_cold = 0;
+static int nr_expired = 0;
+static int nr_released = 0;
+static int nr_lost = 0;
+
+/***********************************************************************************
+ * Function Name      : memcg_node
+ * Inputs             : node (const char *) - memory controller file
+ *                      out (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : char * - out, per-process app cgroup node
+ ***********************************************************************************/
+static char* memcg_node(const char* node, char* out, const size_t len) {
+    snprintf(out, len, CGROUP_V2_ROOT "/uid_%d/pid_%d/%s", retained_uid, retained_pid, node);
+    return out;
+}
+
+/***********************************************************************************
+ * Function Name      : hold_oom_adj
+ * Inputs             : None
+ * Returns            : None
+ * Description        : ActivityManager rewrites oom_score_adj on every process
+ *                      state change, so the value is asserted each round.
+ ***********************************************************************************/
+static void hold_oom_adj(void) {
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "/proc/%d/oom_score_adj", retained_pid);
+
+    if (read_long(path, RETAIN_OOM_ADJ) > RETAIN_OOM_ADJ)
+        write2file(path, false, false, "%d", RETAIN_OOM_ADJ);
+}
+
+/***********************************************************************************
+ * Function Name      : warm_task
+ * Inputs             : task (Task *) - retained package and its library path
+ * Returns            : None
+ ***********************************************************************************/
+static void warm_task(Task* task) {
+    size_t warmed = preload_directory("retain", task->text, RETAIN_WARM_BUDGET_MB, 0);
+    log_nusantara(LOG_DEBUG, "Kept %zuMB of %s warm", warmed >> 20, task->package);
+}
+
+/***********************************************************************************
+ * Function Name      : warm_pages
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Reads native libraries of the game back into page
+ *                      cache, they are what a resume faults on first. Runs on
+ *                      the preload lane, skipped while that lane is busy.
+ ***********************************************************************************/
+static void warm_pages(void) {
+    if (executor_busy(TASK_PRELOAD))
+        return;
+
+    Task task = {.run = warm_task, .priority = TASK_PRELOAD};
+    if (!package_lib_dir(retained_package, task.text, sizeof(task.text)))
+        return;
+
+    snprintf(task.package, sizeof(task.package), "%s", retained_package);
+    executor_submit(&task);
+}
+
+/***********************************************************************************
+ * Function Name      : retention_release
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Gives the process back to ActivityManager and lmkd. The
+ *                      adj is left alone, the next state change rewrites it.
+ *                      Warming still queued or running is cancelled.
+ ***********************************************************************************/
+static void retention_release(void) {
+    char path[MAX_PATH_LENGTH];
+
+    executor_cancel(retained_package);
+
+    if (saved_memory_low >= 0 && kill(retained_pid, 0) == 0)
+        write2file(memcg_node("memory.low", path, sizeof(path)), false, false, "%ld", saved_memory_low);
+
+    saved_memory_low = -1;
+    retained_pid = 0;
+    retained_package[0] = '\0';
+}
+
+/***********************************************************************************
+ * Function Name      : retention_start
+ * Inputs             : session (const GameSession *) - game leaving foreground
+ * Returns            : None
+ * Description        : Lowers oom_score_adj below where lmkd reclaims first and
+ *                      protects the current footprint of the app memcg with
+ *                      memory.low, so proactive reclaim leaves it be too. Only
+ *                      one game is retained, the last one to leave.
+ ***********************************************************************************/
+void retention_start(const GameSession* session) {
+    long grace = read_long(RETAIN_GRACE, RETAIN_DEFAULT_GRACE_S);
+    if (grace <= 0 || kill(session->pid, 0) != 0)
+        return;
+
+    if (retained_pid != 0)
+        retention_release();
+
+    snprintf(retained_package, sizeof(retained_package), "%s", session->package);
+    retained_pid = session->main_pid ? session->main_pid : session->pid;
+    retained_uid = session->uid;
+    retained_since = time(NULL);
+    rounds = 0;
+
+    char path[MAX_PATH_LENGTH];
+    long current = read_long(memcg_node("memory.current", path, sizeof(path)), -1);
+    saved_memory_low = -1;
+    if (current > 0) {
+        saved_memory_low = read_long(memcg_node("memory.low", path, sizeof(path)), -1);
+        if (saved_memory_low >= 0)
+            write2file(path, false, false, "%ld", current);
+    }
+
+    hold_oom_adj();
+    log_nusantara(LOG_INFO, "Retaining %s for %lds after leaving foreground", retained_package, grace);
+}
+
+/***********************************************************************************
+ * Function Name      : retention_tick
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Once per round. Retention ends when the grace window
+ *                      runs out, or early once memory pressure reaches
+ *                      RETAIN_PSI_RELEASE, lmkd needs the memory more than a
+ *                      fast resume does.
+ ***********************************************************************************/
+void retention_tick(void) {
+    if (retained_pid == 0)
+        return;
+
+    if (kill(retained_pid, 0) != 0) {
+        log_nusantara(LOG_INFO, "Retained %s was killed", retained_package);
+        nr_lost++;
+        retention_release();
+        return;
+    }
+
+    if (time(NULL) - retained_since >= read_long(RETAIN_GRACE, RETAIN_DEFAULT_GRACE_S)) {
+        log_nusantara(LOG_DEBUG, "Retention of %s expired", retained_package);
+        nr_expired++;
+        retention_release();
+        return;
+    }
+
+    PsiStat mem;
+    if (psi_read(PSI_MEMORY, &mem) && mem.some_avg10 >= RETAIN_PSI_RELEASE) {
+        log_nusantara(LOG_INFO, "Memory pressure %.1f%%, releasing %s", mem.some_avg10, retained_package);
+        nr_released++;
+        retention_release();
+        return;
+    }
+
+    hold_oom_adj();
+    if (++rounds % RETAIN_WARM_ROUNDS == 0 && is_enabled(RETAIN_WARM))
+        warm_pages();
+}
+
+/***********************************************************************************
+ * Function Name      : retention_resume
+ * Inputs             : session (const GameSession *) - game entering foreground
+ *                      cached (bool) - true if the game process was tracked
+ * Returns            : None
+ * Description        : Counts warm resumes against cold starts and ends
+ *                      retention of a game coming back.
+ ***********************************************************************************/
+void retention_resume(const GameSession* session, const bool cached) {
+    if (cached)
+        nr_warm++;
+    else
+        nr_cold++;
+
+    if (retained_pid != 0 && strcmp(retained_package, session->package) == 0)
+        retention_release();
+}
+
+/***********************************************************************************
+ * Function Name      : retention_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes retention section of daemon status.
+ ***********************************************************************************/
+void retention_status(FILE* fp) {
+    fprintf(fp, "retained=%s\n", retained_package);
+    fprintf(fp, "retain_warm_resumes=%d\n", nr_warm);
+    fprintf(fp, "retain_cold_starts=%d\n", nr_cold);
+    fprintf(fp, "retain_expired=%d\n", nr_expired);
+    fprintf(fp, "retain_released=%d\n", nr_released);
+    fprintf(fp, "retain_killed=%d\n", nr_lost);
+}
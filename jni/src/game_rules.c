@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2024-2025 Rem01Gaming
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+// Cached process of the active rule
+static char cached_package[MAX_PACKAGE] = {0};
+static char cached_proc[MAX_PACKAGE] = {0};
+static pid_t cached_pid = 0;
+static pid_t cached_main_pid = 0;
+
+/***********************************************************************************
+ * Function Name      : proc_matches
+ * Inputs             : pid (pid_t) - process id
+ *                      name (const char *) - expected process name
+ * Returns            : bool - true if pid is alive and still runs name
+ * Description        : Validates a cached PID, catches PID reuse after the game
+ *                      process died between two rounds.
+ ***********************************************************************************/
+static bool proc_matches(const pid_t pid, const char* name) {
+    if (pid <= 0 || kill(pid, 0) != 0)
+        return false;
+
+    char path[MAX_PATH_LENGTH];
+    char cmdline[MAX_PACKAGE] = {0};
+    snprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return false;
+
+    size_t len = fread(cmdline, 1, sizeof(cmdline) - 1, fp);
+    fclose(fp);
+    cmdline[len] = '\0';
+    return strcmp(cmdline, name) == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : is_background
+ * Inputs             : pid (pid_t) - main process of the game
+ * Returns            : bool - true if ActivityManager ranks it below visible apps
+ ***********************************************************************************/
+static bool is_background(const pid_t pid) {
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "/proc/%d/oom_score_adj", pid);
+    return read_long(path, 0) >= GAME_BG_MIN_OOM_ADJ;
+}
+
+/***********************************************************************************
+ * Function Name      : resolve_game_process
+ * Inputs             : package (const char *) - game package name
+ *                      profile (const GameProfile *) - game rules
+ *                      pid (pid_t *) - receives PID to boost when running
+ * Returns            : GameState - GAME_NO_RULE when the main process should be
+ *                                  boosted as usual, GAME_RUN_BG when the
+ *                                  game only lingers in background,
+ *                                  GAME_RUNNING with *pid set otherwise
+ * Description        : Applies render process and background indicator rules
+ *                      of a game. Resolved PIDs are cached and validated on
+ *                      every call, /proc is only scanned again once the cached
+ *                      process is gone.
+ ***********************************************************************************/
+GameState resolve_game_process(const char* package, const GameProfile* profile, pid_t* pid) {
+    if (!profile->render[0] && profile->background == GAME_BG_NEVER) {
+        cached_pid = 0;
+        cached_main_pid = 0;
+        return GAME_NO_RULE;
+    }
+
+    char proc[MAX_PACKAGE];
+    if (profile->render[0] == ':')
+        snprintf(proc, sizeof(proc), "%s%s", package, profile->render);
+    else
+        snprintf(proc, sizeof(proc), "%s", profile->render[0] ? profile->render : package);
+
+    // Another game or edited rules, drop cache
+    if (strcmp(cached_package, package) != 0 || strcmp(cached_proc, proc) != 0) {
+        snprintf(cached_package, sizeof(cached_package), "%s", package);
+        snprintf(cached_proc, sizeof(cached_proc), "%s", proc);
+        cached_pid = 0;
+        cached_main_pid = 0;
+    }
+
+    if (profile->background == GAME_BG_OOM_ADJ) {
+        if (!proc_matches(cached_main_pid, package))
+            cached_main_pid = pidof(package);
+        if (cached_main_pid == 0 || is_background(cached_main_pid))
+            return GAME_RUN_BG;
+    }
+
+    if (!proc_matches(cached_pid, cached_proc)) {
+        cached_pid = pidof(cached_proc);
+        if (cached_pid != 0)
+            log_nusantara(LOG_INFO, "Boosting %s process %s (%d)", package, cached_proc, cached_pid);
+    }
+
+    if (cached_pid == 0) {
+        // Render process only lives while the game is on screen
+        if (profile->background == GAME_BG_RENDER_MISSING)
+            return GAME_RUN_BG;
+        return GAME_NO_RULE;
+    }
+
+    *pid = cached_pid;
+    return GAME_RUNNING;
+}
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+static GameSession sessions[MAX_GAME_SESSIONS];
+static int nr_sessions = 0;
+static ProfileMode account_mode = PERFCOMMON;
+static struct timespec account_last = {0};
+
+/***********************************************************************************
+ * Function Name      : session_record
+ * Inputs             : session (const GameSession *) - session being dropped
+ * Returns            : None
+ * Description        : Stores the finished session in the history ring.
+ ***********************************************************************************/
+static void session_record(const GameSession* session) {
+    HistoryRecord record = {0};
+    memcpy(record.package, session->package, strnlen(session->package, HISTORY_PACKAGE));
+    record.start = (uint32_t)session->started;
+    record.end = (uint32_t)time(NULL);
+    record.boost_ms = (uint32_t)session->boost_ms;
+    record.preload_ms = (uint32_t)session->preload_ms;
+    record.preload_kb = (uint32_t)(session->preload_bytes >> 10);
+
+    for (int m = 0; m < PROFILE_MODE_MAX; m++)
+        record.profile_s[m] = (uint32_t)(session->profile_ms[m] / 1000);
+    for (int c = 0; c < HISTORY_CLUSTERS; c++) {
+        if (session->freq_time[c] > 0)
+            record.cluster_mhz[c] = (uint16_t)(session->freq_weight[c] / session->freq_time[c] / 1000);
+    }
+    for (int t = 0; t < THERMAL_CLASS_MAX; t++)
+        record.peak_temp[t] = (int16_t)(session->peak_temp[t] / 100);
+    record.thermal_steps = (uint16_t)session->thermal_steps;
+
+    history_append(SESSION_HISTORY, &record);
+}
+
+/***********************************************************************************
+ * Function Name      : session_find
+ * Inputs             : package (const char *) - game package name
+ * Returns            : GameSession * - tracked session, NULL if none
+ ***********************************************************************************/
+GameSession* session_find(const char* package) {
+    if (!package)
+        return NULL;
+
+    for (int i = 0; i < nr_sessions; i++) {
+        if (strcmp(sessions[i].package, package) == 0)
+            return &sessions[i];
+    }
+
+    return NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : session_active
+ * Inputs             : None
+ * Returns            : GameSession * - session currently boosted, NULL if none
+ ***********************************************************************************/
+GameSession* session_active(void) {
+    for (int i = 0; i < nr_sessions; i++) {
+        if (sessions[i].active)
+            return &sessions[i];
+    }
+
+    return NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : session_open
+ * Inputs             : package (const char *) - game package name
+ *                      pid (pid_t) - process to boost
+ *                      profile (const GameProfile *) - game overrides
+ * Returns            : GameSession * - new session
+ * Description        : Tracks a new game session. When the table is full the
+ *                      least recently used inactive session is dropped.
+ ***********************************************************************************/
+GameSession* session_open(const char* package, const pid_t pid, const GameProfile* profile) {
+    GameSession* session = session_find(package);
+
+    if (!session && nr_sessions < MAX_GAME_SESSIONS) {
+        session = &sessions[nr_sessions++];
+    } else if (!session) {
+        for (int i = 0; i < nr_sessions; i++) {
+            if (!sessions[i].active && (!session || sessions[i].last_active < session->last_active))
+                session = &sessions[i];
+        }
+        if (!session) [[clang::unlikely]]
+            session = &sessions[0];
+
+        log_nusantara(LOG_DEBUG, "Session table full, dropping %s", session->package);
+        session_record(session);
+    }
+
+    memset(session, 0, sizeof(*session));
+    snprintf(session->package, sizeof(session->package), "%s", package);
+    session->pid = pid;
+    session->main_pid = pidof(package);
+    session->uid = uidof(pid);
+    session->started = time(NULL);
+    session->last_active = session->started;
+    session->profile = *profile;
+    return session;
+}
+
+/***********************************************************************************
+ * Function Name      : session_activate
+ * Inputs             : session (GameSession *) - session to mark active, NULL
+ *                                                to deactivate every session
+ * Returns            : None
+ ***********************************************************************************/
+void session_activate(GameSession* session) {
+    time_t now = time(NULL);
+
+    for (int i = 0; i < nr_sessions; i++) {
+        if (sessions[i].active)
+            sessions[i].last_active = now;
+        sessions[i].active = &sessions[i] == session;
+    }
+
+    if (session) {
+        session->last_active = now;
+        session->switches++;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : session_prune
+ * Inputs             : None
+ * Returns            : bool - true if the active session was dropped
+ * Description        : Drops sessions whose boosted process exited.
+ ***********************************************************************************/
+bool session_prune(void) {
+    bool active_gone = false;
+
+    for (int i = 0; i < nr_sessions;) {
+        if (kill(sessions[i].pid, 0) == 0) {
+            i++;
+            continue;
+        }
+
+        log_nusantara(LOG_INFO, "Game %s exited after %lds, %lldmJ used over %llds boosted", sessions[i].package,
+                      (long)(time(NULL) - sessions[i].started), sessions[i].energy_mj, sessions[i].metered_ms / 1000);
+        if (sessions[i].active)
+            active_gone = true;
+        session_record(&sessions[i]);
+        executor_cancel(sessions[i].package);
+        sessions[i] = sessions[--nr_sessions];
+    }
+
+    return active_gone;
+}
+
+/***********************************************************************************
+ * Function Name      : session_account
+ * Inputs             : mode (ProfileMode) - profile in effect from now on
+ * Returns            : None
+ * Description        : Once per round. Time since the last call goes to the
+ *                      active session under the profile that was in effect.
+ ***********************************************************************************/
+void session_account(const ProfileMode mode) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long elapsed_ms = (now.tv_sec - account_last.tv_sec) * 1000 + (now.tv_nsec - account_last.tv_nsec) / 1000000;
+    bool first = account_last.tv_sec == 0;
+    account_last = now;
+
+    GameSession* session = session_active();
+    if (session && !first)
+        session->profile_ms[account_mode] += elapsed_ms;
+    account_mode = mode;
+}
+
+/***********************************************************************************
+ * Function Name      : session_thermal
+ * Inputs             : stepped (bool) - true if thermal state changed
+ * Returns            : None
+ * Description        : Called on every thermal tick while a game is boosted.
+ ***********************************************************************************/
+void session_thermal(const bool stepped) {
+    GameSession* session = session_active();
+    if (!session)
+        return;
+
+    for (int c = 0; c < THERMAL_CLASS_MAX; c++) {
+        int temp = thermal_temp((ThermalClass)c);
+        if (temp > session->peak_temp[c])
+            session->peak_temp[c] = temp;
+    }
+    if (stepped)
+        session->thermal_steps++;
+}
+
+/***********************************************************************************
+ * Function Name      : session_on_screen
+ * Inputs             : session (const GameSession *) - session
+ * Returns            : bool - true if the game is still ranked as visible
+ * Description        : Cheap replacement for a dumpsys round trip while a game
+ *                      is being played, ActivityManager raises oom_score_adj of
+ *                      the main process once the game leaves the screen.
+ ***********************************************************************************/
+bool session_on_screen(const GameSession* session) {
+    pid_t pid = session->main_pid ? session->main_pid : session->pid;
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "/proc/%d/oom_score_adj", pid);
+    return read_long(path, GAME_BG_MIN_OOM_ADJ) < GAME_BG_MIN_OOM_ADJ;
+}
+
+/***********************************************************************************
+ * Function Name      : session_publish
+ * Inputs             : in_game (bool) - true on performance profile
+ * Returns            : None
+ * Description        : Writes gameinfo as a list of "package pid uid" lines. The
+ *                      first line is the active game, or "NULL 0 0" when not in
+ *                      game, so single line readers keep working.
+ ***********************************************************************************/
+void session_publish(const bool in_game) {
+    char data[MAX_DATA_LENGTH];
+    size_t len = 0;
+    const GameSession* active = in_game ? session_active() : NULL;
+
+    if (active)
+        len += snprintf(data + len, sizeof(data) - len, "%s %d %d\n", active->package, active->pid, active->uid);
+    else
+        len += snprintf(data + len, sizeof(data) - len, "NULL 0 0\n");
+
+    for (int i = 0; i < nr_sessions && len < sizeof(data); i++) {
+        if (&sessions[i] != active)
+            len += snprintf(data + len, sizeof(data) - len, "%s %d %d\n", sessions[i].package, sessions[i].pid, sessions[i].uid);
+    }
+
+    write2file(GAME_INFO, false, false, "%s", data);
+}
+
+/***********************************************************************************
+ * Function Name      : session_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes session section of daemon status.
+ ***********************************************************************************/
+void session_status(FILE* fp) {
+    time_t now = time(NULL);
+
+    fprintf(fp, "sessions=%d\n", nr_sessions);
+    for (int i = 0; i < nr_sessions; i++) {
+        const GameSession* s = &sessions[i];
+        fprintf(fp, "session%d=%s pid=%d uid=%d age=%ld switches=%d energy_mj=%lld mw=%lld %s\n", i, s->package, s->pid, s->uid,
+                (long)(now - s->started), s->switches, s->energy_mj, s->metered_ms ? s->energy_mj * 1000 / s->metered_ms : 0,
+                s->active ? "active" : "idle");
+    }
+}
@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+typedef struct {
+    GpuBackend backend;
+    char busy[MAX_PATH_LENGTH];   // busy percent, leading number of the node
+    char cur[MAX_PATH_LENGTH];    // current frequency
+    char floor[MAX_PATH_LENGTH];  // devfreq min_freq, or boost OPP index on MediaTek
+    long freqs[MAX_GPU_FREQS];    // ascending
+    int nr_freqs;
+    long mhz_div;                 // frequency unit per MHz
+} GpuDevice;
+
+// Floors in percent of the GPU frequency table, PERF_LEVEL_MAX never goes below the profiler floor
+static const int level_floor_pct[PERF_LEVEL_MAX + 1] = {0, 40, 65, 85};
+
+// Demand (percent) needed to step up from a level, and to stay on it
+static const int level_up_demand[PERF_LEVEL_MAX] = {40, 60, 80};
+static const int level_down_demand[PERF_LEVEL_MAX + 1] = {0, 25, 45, 65};
+
+static const char* gpu_backend_name[GPU_BACKEND_MAX] = {"none", "adreno", "mali-mtk", "devfreq"};
+
+// Matched as substring of /sys/class/devfreq entries
+static const char* devfreq_patterns[] = {"kgsl", "gpu", "mali", "g3d"};
+
+static GpuDevice gpu = {0};
+static long saved_floor = -1;
+static int saved_idx = 0;
+static char session_package[MAX_PACKAGE] = {0};
+static unsigned long residency_ms[MAX_GPU_FREQS];
+static struct timespec last_sample = {0};
+static PerfLevel cur_level = PERF_LEVEL_MAX;
+static bool controlling = false;
+static int below_count = 0;
+static int busy = -1;
+static int touch_pct = 0;
+
+/***********************************************************************************
+ * Function Name      : compare_freq
+ * Inputs             : a, b (const void *) - frequencies
+ * Returns            : int - qsort order, ascending
+ ***********************************************************************************/
+static int compare_freq(const void* a, const void* b) {
+    long x = *(const long*)a, y = *(const long*)b;
+    return (x > y) - (x < y);
+}
+
+/***********************************************************************************
+ * Function Name      : load_freqs
+ * Inputs             : path (const char *) - frequency list or OPP table
+ *                      opp_table (bool) - true for "[idx] freq: <khz>, ..." lines
+ * Returns            : int - number of frequencies, sorted ascending
+ * Description        : Adreno lists frequencies high to low, MediaTek OPP tables
+ *                      start at the fastest OPP, so every table gets sorted.
+ ***********************************************************************************/
+static int load_freqs(const char* path, const bool opp_table) {
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return 0;
+
+    gpu.nr_freqs = 0;
+    if (opp_table) {
+        char line[MAX_LINE];
+        long freq;
+        while (gpu.nr_freqs < MAX_GPU_FREQS && fgets(line, sizeof(line), fp)) {
+            if (sscanf(line, "[%*d]%*[^0-9]%ld", &freq) == 1 && freq > 0)
+                gpu.freqs[gpu.nr_freqs++] = freq;
+        }
+    } else {
+        long freq;
+        while (gpu.nr_freqs < MAX_GPU_FREQS && fscanf(fp, "%ld", &freq) == 1) {
+            if (freq > 0)
+                gpu.freqs[gpu.nr_freqs++] = freq;
+        }
+    }
+    fclose(fp);
+
+    qsort(gpu.freqs, (size_t)gpu.nr_freqs, sizeof(long), compare_freq);
+    return gpu.nr_freqs;
+}
+
+/***********************************************************************************
+ * Function Name      : probe_devfreq
+ * Inputs             : dir (const char *) - devfreq device directory
+ * Returns            : bool - true if the device can take a floor
+ ***********************************************************************************/
+static bool probe_devfreq(const char* dir) {
+    snprintf(gpu.floor, sizeof(gpu.floor), "%s/min_freq", dir);
+    snprintf(gpu.cur, sizeof(gpu.cur), "%s/cur_freq", dir);
+
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/available_frequencies", dir);
+    if (access(gpu.floor, W_OK) != 0 || load_freqs(path, false) < 2)
+        return false;
+
+    gpu.mhz_div = 1000000;
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : probe_adreno
+ * Inputs             : None
+ * Returns            : bool - true on a kgsl GPU
+ ***********************************************************************************/
+static bool probe_adreno(void) {
+    if (!probe_devfreq(KGSL_ROOT "/devfreq"))
+        return false;
+
+    snprintf(gpu.busy, sizeof(gpu.busy), KGSL_ROOT "/gpu_busy_percentage");
+    gpu.backend = GPU_ADRENO;
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : probe_mali_mtk
+ * Inputs             : None
+ * Returns            : bool - true when GED takes a boost OPP
+ * Description        : GED boost index is a floor, unlike gpufreq fixed OPP
+ *                      which pins the GPU. Lower index is faster.
+ ***********************************************************************************/
+static bool probe_mali_mtk(void) {
+    if (access(GED_HAL_ROOT "/custom_boost_gpu_freq", W_OK) != 0)
+        return false;
+
+    if (load_freqs("/proc/gpufreqv2/gpu_working_opp_table", true) < 2 &&
+        load_freqs("/proc/gpufreq/gpufreq_opp_dump", true) < 2)
+        return false;
+
+    snprintf(gpu.floor, sizeof(gpu.floor), GED_HAL_ROOT "/custom_boost_gpu_freq");
+    snprintf(gpu.busy, sizeof(gpu.busy), GED_HAL_ROOT "/gpu_utilization");
+    snprintf(gpu.cur, sizeof(gpu.cur), GED_HAL_ROOT "/current_freqency");
+    gpu.mhz_div = 1000;
+    gpu.backend = GPU_MALI_MTK;
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : probe_generic
+ * Inputs             : None
+ * Returns            : bool - true if a GPU devfreq device was found
+ * Description        : Load node is "<busy>@<freq>Hz" where the kernel has it,
+ *                      otherwise demand falls back to the frequency the
+ *                      devfreq governor picked.
+ ***********************************************************************************/
+static bool probe_generic(void) {
+    DIR* dir = opendir(DEVFREQ_ROOT);
+    if (!dir)
+        return false;
+
+    struct dirent* entry;
+    bool found = false;
+    while (!found && (entry = readdir(dir))) {
+        for (size_t i = 0; i < sizeof(devfreq_patterns) / sizeof(devfreq_patterns[0]); i++) {
+            if (!strstr(entry->d_name, devfreq_patterns[i]))
+                continue;
+
+            char path[MAX_PATH_LENGTH];
+            snprintf(path, sizeof(path), DEVFREQ_ROOT "/%s", entry->d_name);
+            if (probe_devfreq(path)) {
+                snprintf(gpu.busy, sizeof(gpu.busy), "%s/load", path);
+                gpu.backend = GPU_DEVFREQ;
+                found = true;
+            }
+            break;
+        }
+    }
+
+    closedir(dir);
+    return found;
+}
+
+/***********************************************************************************
+ * Function Name      : gpu_init
+ * Inputs             : None
+ * Returns            : GpuBackend - backend in use, GPU_NONE if unsupported
+ * Description        : Picks the vendor backend from soc_recognition, generic
+ *                      devfreq covers the rest and vendors without the usual
+ *                      nodes.
+ ***********************************************************************************/
+GpuBackend gpu_init(void) {
+    int soc = (int)read_long(SOC_RECOGNITION, 0);
+    memset(&gpu, 0, sizeof(gpu));
+
+    bool ok = (soc == 1 && probe_mali_mtk()) || (soc == 2 && probe_adreno());
+    if (!ok && !probe_generic())
+        memset(&gpu, 0, sizeof(gpu));
+
+    if (gpu.backend != GPU_NONE)
+        log_nusantara(LOG_INFO, "GPU controller using %s, %d OPPs %ld-%ldMHz", gpu_backend_name[gpu.backend],
+                      gpu.nr_freqs, gpu.freqs[0] / gpu.mhz_div, gpu.freqs[gpu.nr_freqs - 1] / gpu.mhz_div);
+    else
+        log_nusantara(LOG_INFO, "No supported GPU frequency control found");
+
+    return gpu.backend;
+}
+
+/***********************************************************************************
+ * Function Name      : freq_index
+ * Inputs             : freq (long) - frequency
+ * Returns            : int - highest table entry not above freq
+ ***********************************************************************************/
+static int freq_index(const long freq) {
+    int idx = 0;
+    while (idx + 1 < gpu.nr_freqs && gpu.freqs[idx + 1] <= freq)
+        idx++;
+    return idx;
+}
+
+/***********************************************************************************
+ * Function Name      : read_cur_freq
+ * Inputs             : None
+ * Returns            : long - current GPU frequency, 0 if unknown
+ * Description        : GED prints "<opp> <khz>", devfreq only the frequency.
+ ***********************************************************************************/
+static long read_cur_freq(void) {
+    FILE* fp = fopen(gpu.cur, "r");
+    if (!fp)
+        return 0;
+
+    long first = 0, second = 0;
+    int n = fscanf(fp, "%ld %ld", &first, &second);
+    fclose(fp);
+
+    if (n == 2 && gpu.backend == GPU_MALI_MTK)
+        return second;
+    return n >= 1 ? first : 0;
+}
+
+/***********************************************************************************
+ * Function Name      : apply_level
+ * Inputs             : level (PerfLevel) - level to apply
+ * Returns            : None
+ ***********************************************************************************/
+static void apply_level(const PerfLevel level) {
+    int pct = level_floor_pct[level] > touch_pct ? level_floor_pct[level] : touch_pct;
+    int idx = (gpu.nr_freqs - 1) * pct / 100;
+    if (level == PERF_LEVEL_MAX && saved_idx > idx)
+        idx = saved_idx;
+
+    if (gpu.backend == GPU_MALI_MTK)
+        write2file(gpu.floor, false, false, "%d", gpu.nr_freqs - 1 - idx);
+    else
+        write2file(gpu.floor, false, false, "%ld", gpu.freqs[idx]);
+
+    cur_level = level;
+}
+
+/***********************************************************************************
+ * Function Name      : gpu_controller_start
+ * Inputs             : package (const char *) - game package, names the session
+ * Returns            : None
+ * Description        : Snapshots the floor written by the profiler and resets
+ *                      residency of the session. Starts at top level so a new
+ *                      session never begins slower than before.
+ ***********************************************************************************/
+void gpu_controller_start(const char* package) {
+    if (gpu.backend == GPU_NONE || !is_enabled(GPU_CONTROLLER))
+        return;
+
+    saved_floor = read_long(gpu.floor, -1);
+    if (gpu.backend == GPU_MALI_MTK)
+        saved_idx = saved_floor >= 0 && saved_floor < gpu.nr_freqs ? gpu.nr_freqs - 1 - (int)saved_floor : 0;
+    else
+        saved_idx = freq_index(saved_floor);
+
+    snprintf(session_package, sizeof(session_package), "%s", package);
+    memset(residency_ms, 0, sizeof(residency_ms));
+    clock_gettime(CLOCK_MONOTONIC, &last_sample);
+    below_count = 0;
+    busy = -1;
+    touch_pct = 0;
+    cur_level = PERF_LEVEL_MAX;
+    controlling = true;
+}
+
+/***********************************************************************************
+ * Function Name      : gpu_controller_tick
+ * Inputs             : None
+ * Returns            : None
+ * Description        : One control step on the performance tick. Demand is GPU
+ *                      busy scaled by how fast the GPU was running, so a busy
+ *                      GPU at a low clock does not count as heavy. Steps up
+ *                      right away, steps down one level only after demand stays
+ *                      low for PERF_DOWN_SAMPLES ticks, which is what menus and
+ *                      pauses look like.
+ ***********************************************************************************/
+void gpu_controller_tick(void) {
+    if (!controlling)
+        return;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long elapsed_ms = (now.tv_sec - last_sample.tv_sec) * 1000 + (now.tv_nsec - last_sample.tv_nsec) / 1000000;
+    last_sample = now;
+
+    long freq = read_cur_freq();
+    int idx = freq > 0 ? freq_index(freq) : 0;
+    if (freq > 0)
+        residency_ms[idx] += (unsigned long)elapsed_ms;
+
+    int freq_pct = freq > 0 ? (int)(gpu.freqs[idx] * 100 / gpu.freqs[gpu.nr_freqs - 1]) : 100;
+    busy = gpu.busy[0] ? (int)read_long(gpu.busy, -1) : -1;
+    int demand = busy >= 0 && busy <= 100 ? busy * freq_pct / 100 : freq_pct;
+
+    PerfLevel target = cur_level;
+    if (cur_level < PERF_LEVEL_MAX && demand >= level_up_demand[cur_level]) {
+        target = cur_level + 1;
+        below_count = 0;
+    } else if (cur_level > PERF_LEVEL_LIGHT && demand < level_down_demand[cur_level]) {
+        if (++below_count >= PERF_DOWN_SAMPLES) {
+            target = cur_level - 1;
+            below_count = 0;
+        }
+    } else {
+        below_count = 0;
+    }
+
+    PerfLevel cap = thermal_level_cap();
+    if (target > cap)
+        target = cap;
+
+    if (target != cur_level) {
+        log_nusantara(LOG_DEBUG, "GPU level %s -> %s (demand %d%%)", perf_level_name[cur_level], perf_level_name[target],
+                      demand);
+        apply_level(target);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : format_residency
+ * Inputs             : out (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : char * - out, "<MHz>:<percent>" pairs of the session
+ ***********************************************************************************/
+static char* format_residency(char* out, const size_t len) {
+    unsigned long total = 0;
+    size_t used = 0;
+    out[0] = '\0';
+
+    for (int i = 0; i < gpu.nr_freqs; i++)
+        total += residency_ms[i];
+
+    for (int i = 0; total > 0 && i < gpu.nr_freqs && used < len; i++) {
+        if (residency_ms[i] == 0)
+            continue;
+        used += snprintf(out + used, len - used, "%s%ld:%lu", used ? "," : "", gpu.freqs[i] / gpu.mhz_div,
+                         residency_ms[i] * 100 / total);
+    }
+
+    return out;
+}
+
+/***********************************************************************************
+ * Function Name      : gpu_controller_stop
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Puts the profiler floor back before the next profile
+ *                      runs and logs where the GPU spent the session.
+ ***********************************************************************************/
+void gpu_controller_stop(void) {
+    if (!controlling)
+        return;
+
+    if (saved_floor >= 0)
+        write2file(gpu.floor, false, false, "%ld", saved_floor);
+
+    char residency[MAX_LINE];
+    log_nusantara(LOG_INFO, "GPU residency for %s: %s", session_package, format_residency(residency, sizeof(residency)));
+    touch_pct = 0;
+    controlling = false;
+}
+
+/***********************************************************************************
+ * Function Name      : gpu_controller_touch
+ * Inputs             : pct (int) - floor in percent of the OPP table, 0 ends
+ *                                  the touch boost
+ * Returns            : None
+ * Description        : Raises the GPU floor above the current level for a touch
+ *                      boost, capped to the floor of the thermal cap.
+ ***********************************************************************************/
+void gpu_controller_touch(const int pct) {
+    PerfLevel cap = thermal_level_cap();
+    int bump = pct > level_floor_pct[cap] ? level_floor_pct[cap] : pct;
+    if (!controlling || bump == touch_pct)
+        return;
+
+    touch_pct = bump;
+    apply_level(cur_level);
+}
+
+/***********************************************************************************
+ * Function Name      : gpu_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes GPU section of daemon status. Residency stays on
+ *                      the last session until the next one starts.
+ ***********************************************************************************/
+void gpu_status(FILE* fp) {
+    char residency[MAX_LINE];
+
+    fprintf(fp, "gpu_backend=%s\n", gpu_backend_name[gpu.backend]);
+    if (gpu.backend == GPU_NONE)
+        return;
+
+    fprintf(fp, "gpu_level=%s\n", controlling ? perf_level_name[cur_level] : "none");
+    fprintf(fp, "gpu_busy=%d\n", controlling ? busy : -1);
+    fprintf(fp, "gpu_session=%s\n", session_package);
+    fprintf(fp, "gpu_residency=%s\n", format_residency(residency, sizeof(residency)));
+}
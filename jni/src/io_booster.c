@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+typedef struct {
+    char path[MAX_PATH_LENGTH];  // queue directory
+    long read_ahead_kb;          // saved while boosted
+    long nr_requests;
+} IoQueue;
+
+static IoQueue queues[MAX_IO_QUEUES];
+static int nr_queues = 0;
+static char data_dev[32] = {0};
+static unsigned long long last_game_bytes = 0;
+static unsigned long long last_disk_sectors = 0;
+static struct timespec last_sample = {0};
+static pid_t sampled_pid = 0;
+static bool boosted = false;
+static int settle_count = 0;
+static int nr_bursts = 0;
+static long game_kbps = 0;
+static long disk_kbps = 0;
+
+/***********************************************************************************
+ * Function Name      : block_devname
+ * Inputs             : dir (const char *) - sysfs block device directory
+ *                      out (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : bool - true if uevent named the device
+ ***********************************************************************************/
+static bool block_devname(const char* dir, char* out, const size_t len) {
+    char path[MAX_PATH_LENGTH];
+    char line[MAX_LINE];
+    snprintf(path, sizeof(path), "%s/uevent", dir);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return false;
+
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, "DEVNAME=", 8) == 0) {
+            snprintf(out, len, "%s", trim_newline(line + 8));
+            found = true;
+        }
+    }
+
+    fclose(fp);
+    return found;
+}
+
+/***********************************************************************************
+ * Function Name      : add_queue
+ * Inputs             : name (const char *) - block device name
+ * Returns            : None
+ * Description        : Partitions have no queue of their own, it sits on the
+ *                      parent disk one directory up.
+ ***********************************************************************************/
+static void add_queue(const char* name) {
+    char path[MAX_PATH_LENGTH];
+
+    snprintf(path, sizeof(path), "/sys/class/block/%s/partition", name);
+    if (access(path, F_OK) == 0)
+        snprintf(path, sizeof(path), "/sys/class/block/%s/../queue", name);
+    else
+        snprintf(path, sizeof(path), "/sys/class/block/%s/queue", name);
+
+    if (nr_queues == MAX_IO_QUEUES || access(path, F_OK) != 0)
+        return;
+
+    for (int i = 0; i < nr_queues; i++) {
+        if (strcmp(queues[i].path, path) == 0)
+            return;
+    }
+
+    snprintf(queues[nr_queues++].path, sizeof(queues[0].path), "%s", path);
+}
+
+/***********************************************************************************
+ * Function Name      : io_boost_init
+ * Inputs             : None
+ * Returns            : int - number of block queues behind /data
+ * Description        : Resolves the device mounted on /data, then follows dm
+ *                      slaves down to the disk, since /data sits on dm-crypt or
+ *                      dm-default-key on most devices and readahead only counts
+ *                      where requests are actually built.
+ ***********************************************************************************/
+int io_boost_init(void) {
+    struct stat st;
+    nr_queues = 0;
+    data_dev[0] = '\0';
+
+    if (stat("/data", &st) != 0) [[clang::unlikely]]
+        return 0;
+
+    char dir[MAX_PATH_LENGTH];
+    char name[32];
+    snprintf(dir, sizeof(dir), "/sys/dev/block/%u:%u", major(st.st_dev), minor(st.st_dev));
+    if (!block_devname(dir, data_dev, sizeof(data_dev)))
+        return 0;
+
+    snprintf(name, sizeof(name), "%s", data_dev);
+    for (int depth = 0; depth < IO_MAX_STACK_DEPTH; depth++) {
+        add_queue(name);
+
+        snprintf(dir, sizeof(dir), "/sys/class/block/%s/slaves", name);
+        DIR* slaves = opendir(dir);
+        if (!slaves)
+            break;
+
+        struct dirent* entry;
+        bool found = false;
+        while (!found && (entry = readdir(slaves))) {
+            if (entry->d_name[0] == '.')
+                continue;
+            snprintf(name, sizeof(name), "%s", entry->d_name);
+            found = true;
+        }
+        closedir(slaves);
+
+        if (!found)
+            break;
+    }
+
+    log_nusantara(LOG_INFO, "I/O booster watching %s, %d block queues", data_dev, nr_queues);
+    return nr_queues;
+}
+
+/***********************************************************************************
+ * Function Name      : read_game_bytes
+ * Inputs             : pid (pid_t) - game PID
+ * Returns            : long long - read_bytes of /proc/<pid>/io, -1 if gone
+ * Description        : Bytes the game made storage fetch, page cache hits are
+ *                      not counted.
+ ***********************************************************************************/
+static long long read_game_bytes(const pid_t pid) {
+    char path[MAX_PATH_LENGTH];
+    char line[MAX_LINE];
+    snprintf(path, sizeof(path), "/proc/%d/io", pid);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return -1;
+
+    long long bytes = -1;
+    while (bytes < 0 && fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "read_bytes: %lld", &bytes) != 1)
+            bytes = -1;
+    }
+
+    fclose(fp);
+    return bytes;
+}
+
+/***********************************************************************************
+ * Function Name      : read_disk_sectors
+ * Inputs             : None
+ * Returns            : unsigned long long - sectors read from the /data device
+ ***********************************************************************************/
+static unsigned long long read_disk_sectors(void) {
+    FILE* fp = fopen("/proc/diskstats", "r");
+    if (!fp)
+        return 0;
+
+    char line[MAX_LINE];
+    char name[32];
+    unsigned long long sectors = 0;
+    bool found = false;
+
+    while (!found && fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "%*u %*u %31s %*u %*u %llu", name, &sectors) == 2 && strcmp(name, data_dev) == 0)
+            found = true;
+    }
+
+    fclose(fp);
+    return found ? sectors : 0;
+}
+
+/***********************************************************************************
+ * Function Name      : apply_boost
+ * Inputs             : enable (bool) - true to boost, false to revert
+ * Returns            : None
+ * Description        : Values in place when a burst starts are the profile
+ *                      ones, they are written back once reads settle.
+ ***********************************************************************************/
+static void apply_boost(const bool enable) {
+    char ra[MAX_PATH_LENGTH];
+    char nr[MAX_PATH_LENGTH];
+
+    for (int i = 0; i < nr_queues; i++) {
+        IoQueue* queue = &queues[i];
+        snprintf(ra, sizeof(ra), "%s/read_ahead_kb", queue->path);
+        snprintf(nr, sizeof(nr), "%s/nr_requests", queue->path);
+
+        if (!enable) {
+            if (queue->read_ahead_kb >= 0)
+                write2file(ra, false, false, "%ld", queue->read_ahead_kb);
+            if (queue->nr_requests >= 0)
+                write2file(nr, false, false, "%ld", queue->nr_requests);
+            continue;
+        }
+
+        // Stacked dm devices are bio based, only the disk has a request queue depth
+        queue->read_ahead_kb = read_long(ra, -1);
+        queue->nr_requests = read_long(nr, -1);
+        if (queue->read_ahead_kb >= IO_BOOST_READ_AHEAD_KB)
+            queue->read_ahead_kb = -1;
+        if (queue->nr_requests >= IO_BOOST_NR_REQUESTS)
+            queue->nr_requests = -1;
+
+        if (queue->read_ahead_kb >= 0)
+            write2file(ra, false, false, "%d", IO_BOOST_READ_AHEAD_KB);
+        if (queue->nr_requests >= 0)
+            write2file(nr, false, false, "%d", IO_BOOST_NR_REQUESTS);
+    }
+
+    boosted = enable;
+}
+
+/***********************************************************************************
+ * Function Name      : io_boost_start
+ * Inputs             : pid (pid_t) - game PID
+ * Returns            : None
+ * Description        : Primes the counters, the first tick only sees reads
+ *                      made after the session started.
+ ***********************************************************************************/
+void io_boost_start(const pid_t pid) {
+    if (nr_queues == 0 || !is_enabled(IO_BOOST))
+        return;
+
+    long long bytes = read_game_bytes(pid);
+    last_game_bytes = bytes > 0 ? (unsigned long long)bytes : 0;
+    last_disk_sectors = read_disk_sectors();
+    clock_gettime(CLOCK_MONOTONIC, &last_sample);
+    settle_count = 0;
+    game_kbps = 0;
+    disk_kbps = 0;
+    sampled_pid = pid;
+}
+
+/***********************************************************************************
+ * Function Name      : io_boost_tick
+ * Inputs             : None
+ * Returns            : None
+ * Description        : One step on the performance tick. A burst starts once
+ *                      the game reads faster than IO_BURST_START_KBPS. It ends
+ *                      after game and disk both stay under IO_BURST_SETTLE_KBPS
+ *                      for IO_SETTLE_TICKS ticks, readahead issued for the game
+ *                      keeps the disk busy a little after the game is done.
+ ***********************************************************************************/
+void io_boost_tick(void) {
+    if (sampled_pid == 0)
+        return;
+
+    long long bytes = read_game_bytes(sampled_pid);
+    if (bytes < 0)
+        return;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long elapsed_ms = (now.tv_sec - last_sample.tv_sec) * 1000 + (now.tv_nsec - last_sample.tv_nsec) / 1000000;
+    if (elapsed_ms <= 0)
+        return;
+    last_sample = now;
+
+    unsigned long long sectors = read_disk_sectors();
+    game_kbps = (long)(((unsigned long long)bytes - last_game_bytes) / 1024 * 1000 / (unsigned long long)elapsed_ms);
+    disk_kbps = (long)((sectors - last_disk_sectors) / 2 * 1000 / (unsigned long long)elapsed_ms);
+    last_game_bytes = (unsigned long long)bytes;
+    last_disk_sectors = sectors;
+
+    if (!boosted) {
+        if (game_kbps >= IO_BURST_START_KBPS) {
+            log_nusantara(LOG_DEBUG, "Loading burst, game reads %ldKB/s", game_kbps);
+            apply_boost(true);
+            settle_count = 0;
+            nr_bursts++;
+        }
+        return;
+    }
+
+    if (game_kbps < IO_BURST_SETTLE_KBPS && disk_kbps < IO_BURST_SETTLE_KBPS) {
+        if (++settle_count >= IO_SETTLE_TICKS) {
+            log_nusantara(LOG_DEBUG, "Loading burst settled");
+            apply_boost(false);
+        }
+    } else {
+        settle_count = 0;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : io_boost_stop
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Reverts a running burst before the next profile runs.
+ ***********************************************************************************/
+void io_boost_stop(void) {
+    if (boosted)
+        apply_boost(false);
+    sampled_pid = 0;
+}
+
+/***********************************************************************************
+ * Function Name      : io_boost_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes I/O booster section of daemon status.
+ ***********************************************************************************/
+void io_boost_status(FILE* fp) {
+    fprintf(fp, "io_device=%s\n", data_dev);
+    fprintf(fp, "io_boost=%s\n", boosted ? "active" : "idle");
+    fprintf(fp, "io_bursts=%d\n", nr_bursts);
+    fprintf(fp, "io_game_kbps=%ld\n", sampled_pid ? game_kbps : 0);
+    fprintf(fp, "io_disk_kbps=%ld\n", sampled_pid ? disk_kbps : 0);
+}
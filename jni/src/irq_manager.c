@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+typedef struct {
+    int irq;
+    IrqClass cls;
+    char saved[64];                // smp_affinity_list before steering
+    unsigned long long count;      // summed over CPUs at last sample
+    long rate;                     // per second
+} IrqEntry;
+
+// Matched case-insensitively against chip and action names, first match wins
+static const struct {
+    const char* pattern;
+    IrqClass cls;
+} irq_patterns[] = {
+    {"touch", IRQ_TOUCH},
+    {"nvt_ts", IRQ_TOUCH},
+    {"sec_ts", IRQ_TOUCH},
+    {"goodix", IRQ_TOUCH},
+    {"synaptics", IRQ_TOUCH},
+    {"fts", IRQ_TOUCH},
+    {"himax", IRQ_TOUCH},
+    {"ilitek", IRQ_TOUCH},
+    {"tpd", IRQ_TOUCH},
+    {"kgsl", IRQ_GPU},
+    {"mali", IRQ_GPU},
+    {"gpu", IRQ_GPU},
+    {"ufshcd", IRQ_STORAGE},
+    {"mmc", IRQ_STORAGE},
+    {"sdhci", IRQ_STORAGE},
+    {"modem", IRQ_MODEM},
+    {"ccci", IRQ_MODEM},
+    {"ipa", IRQ_MODEM},
+    {"mhi", IRQ_MODEM},
+};
+
+static const char* irq_class_name[IRQ_CLASS_MAX] = {"touch", "gpu", "storage", "modem"};
+
+static IrqEntry irqs[MAX_MANAGED_IRQS];
+static int nr_irqs = 0;
+static cpu_set_t target[IRQ_CLASS_MAX];
+static struct timespec last_sample = {0};
+static bool steered = false;
+static int tick_count = 0;
+static unsigned int generation = 0;
+
+// Affinity before steering, saved by a previous instance that had IRQs steered
+static struct {
+    int irq;
+    char saved[64];
+} adopted[MAX_MANAGED_IRQS];
+static int nr_adopted = 0;
+
+/***********************************************************************************
+ * Function Name      : classify_irq
+ * Inputs             : names (const char *) - rest of a /proc/interrupts line
+ * Returns            : int - IrqClass, -1 if not managed
+ ***********************************************************************************/
+static int classify_irq(const char* names) {
+    for (size_t i = 0; i < sizeof(irq_patterns) / sizeof(irq_patterns[0]); i++) {
+        if (strcasestr(names, irq_patterns[i].pattern))
+            return irq_patterns[i].cls;
+    }
+
+    return -1;
+}
+
+/***********************************************************************************
+ * Function Name      : sample_counts
+ * Inputs             : classify (bool) - true to build the managed IRQ list
+ * Returns            : int - number of managed IRQs
+ * Description        : Walks /proc/interrupts once. Counts of managed IRQs are
+ *                      summed over every CPU column, the rate is the delta
+ *                      since the last sample.
+ ***********************************************************************************/
+static int sample_counts(const bool classify) {
+    FILE* fp = fopen("/proc/interrupts", "r");
+    if (!fp)
+        return 0;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long elapsed_ms = (now.tv_sec - last_sample.tv_sec) * 1000 + (now.tv_nsec - last_sample.tv_nsec) / 1000000;
+    last_sample = now;
+
+    char line[MAX_DATA_LENGTH];
+    int nr_cpus = 0;
+
+    // Header names one column per online CPU
+    if (fgets(line, sizeof(line), fp)) {
+        for (char* p = line; (p = strstr(p, "CPU")); p += 3)
+            nr_cpus++;
+    }
+
+    if (classify)
+        nr_irqs = 0;
+
+    while (fgets(line, sizeof(line), fp)) {
+        char* p = line;
+        while (*p == ' ')
+            p++;
+        if (!isdigit((unsigned char)*p))
+            continue;
+
+        int irq = (int)strtol(p, &p, 10);
+        if (*p != ':')
+            continue;
+        p++;
+
+        unsigned long long count = 0;
+        for (int c = 0; c < nr_cpus; c++)
+            count += strtoull(p, &p, 10);
+
+        IrqEntry* entry = NULL;
+        if (classify) {
+            int cls = classify_irq(p);
+            if (cls < 0 || nr_irqs == MAX_MANAGED_IRQS)
+                continue;
+            entry = &irqs[nr_irqs++];
+            entry->irq = irq;
+            entry->cls = (IrqClass)cls;
+            entry->saved[0] = '\0';
+            entry->rate = 0;
+        } else {
+            for (int i = 0; i < nr_irqs && !entry; i++) {
+                if (irqs[i].irq == irq)
+                    entry = &irqs[i];
+            }
+            if (!entry)
+                continue;
+            if (elapsed_ms > 0 && count >= entry->count)
+                entry->rate = (long)((count - entry->count) * 1000 / (unsigned long long)elapsed_ms);
+        }
+
+        entry->count = count;
+    }
+
+    fclose(fp);
+    return nr_irqs;
+}
+
+/***********************************************************************************
+ * Function Name      : irq_init
+ * Inputs             : None
+ * Returns            : int - number of managed IRQs
+ * Description        : Classifies interrupts and picks target cores from the
+ *                      topology. Touch gets the last little core to itself,
+ *                      GPU the one before it, storage and modem share the
+ *                      rest of the little cluster. CPU0 keeps its timer and
+ *                      IPI load and big cores stay free for the game.
+ ***********************************************************************************/
+int irq_init(void) {
+    const cpu_set_t* little = &cpu_topology.mask[CLUSTER_LITTLE];
+    int last = -1, before_last = -1;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, little))
+            continue;
+        before_last = last;
+        last = cpu;
+    }
+
+    // Single cluster SoCs have nowhere to steer to
+    if (cpu_topology.nr_clusters < 2 || last < 0) {
+        nr_irqs = 0;
+        return 0;
+    }
+
+    for (int c = 0; c < IRQ_CLASS_MAX; c++)
+        CPU_ZERO(&target[c]);
+
+    CPU_SET(last, &target[IRQ_TOUCH]);
+    CPU_SET(before_last > 0 ? before_last : last, &target[IRQ_GPU]);
+    CPU_OR(&target[IRQ_STORAGE], &target[IRQ_STORAGE], little);
+    if (CPU_COUNT(little) > 2) {
+        CPU_CLR(last, &target[IRQ_STORAGE]);
+        CPU_CLR(before_last, &target[IRQ_STORAGE]);
+    }
+    target[IRQ_MODEM] = target[IRQ_STORAGE];
+
+    sample_counts(true);
+
+    int per_class[IRQ_CLASS_MAX] = {0};
+    for (int i = 0; i < nr_irqs; i++)
+        per_class[irqs[i].cls]++;
+
+    log_nusantara(LOG_INFO, "IRQ manager found touch %d, gpu %d, storage %d, modem %d", per_class[IRQ_TOUCH],
+                  per_class[IRQ_GPU], per_class[IRQ_STORAGE], per_class[IRQ_MODEM]);
+    return nr_irqs;
+}
+
+/***********************************************************************************
+ * Function Name      : irq_steer
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Saves affinity of every managed IRQ and writes the
+ *                      class target. Per-CPU and chained IRQs refuse the
+ *                      write, those are left alone and not restored later.
+ ***********************************************************************************/
+void irq_steer(void) {
+    if (nr_irqs == 0 || steered || !is_enabled(IRQ_AFFINITY))
+        return;
+
+    char path[MAX_PATH_LENGTH];
+    char list[64];
+    int moved = 0;
+
+    for (int i = 0; i < nr_irqs; i++) {
+        IrqEntry* entry = &irqs[i];
+        snprintf(path, sizeof(path), "/proc/irq/%d/smp_affinity_list", entry->irq);
+        entry->saved[0] = '\0';
+
+        FILE* fp = fopen(path, "r");
+        if (!fp)
+            continue;
+        bool ok = fgets(entry->saved, sizeof(entry->saved), fp) != NULL;
+        fclose(fp);
+        if (!ok)
+            continue;
+        trim_newline(entry->saved);
+
+        // Still steered by a previous instance, its original is the real one
+        for (int a = 0; a < nr_adopted; a++) {
+            if (adopted[a].irq == entry->irq)
+                snprintf(entry->saved, sizeof(entry->saved), "%s", adopted[a].saved);
+        }
+
+        format_cpu_list(&target[entry->cls], list, sizeof(list));
+        if (write2file(path, false, false, "%s", list) != 0) {
+            entry->saved[0] = '\0';
+            continue;
+        }
+        moved++;
+    }
+
+    log_nusantara(LOG_DEBUG, "Steered %d of %d IRQs off game cores", moved, nr_irqs);
+    tick_count = 0;
+    sample_counts(false);
+    steered = true;
+    nr_adopted = 0;
+    generation++;
+}
+
+/***********************************************************************************
+ * Function Name      : irq_tick
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Refreshes per-IRQ rates every IRQ_SAMPLE_TICKS ticks.
+ ***********************************************************************************/
+void irq_tick(void) {
+    if (!steered || ++tick_count < IRQ_SAMPLE_TICKS)
+        return;
+
+    tick_count = 0;
+    sample_counts(false);
+}
+
+/***********************************************************************************
+ * Function Name      : irq_restore
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Also gives back IRQs a previous instance left steered
+ *                      when they were never steered again by this one.
+ ***********************************************************************************/
+void irq_restore(void) {
+    char path[MAX_PATH_LENGTH];
+    for (int a = 0; a < nr_adopted; a++) {
+        snprintf(path, sizeof(path), "/proc/irq/%d/smp_affinity_list", adopted[a].irq);
+        write2file(path, false, false, "%s", adopted[a].saved);
+    }
+    if (nr_adopted > 0)
+        generation++;
+    nr_adopted = 0;
+
+    if (!steered)
+        return;
+
+    for (int i = 0; i < nr_irqs; i++) {
+        if (!irqs[i].saved[0])
+            continue;
+        snprintf(path, sizeof(path), "/proc/irq/%d/smp_affinity_list", irqs[i].irq);
+        write2file(path, false, false, "%s", irqs[i].saved);
+    }
+
+    steered = false;
+    generation++;
+}
+
+/***********************************************************************************
+ * Function Name      : irq_generation
+ * Inputs             : None
+ * Returns            : unsigned int - changes whenever IRQs get steered or
+ *                                     restored
+ * Description        : Lets daemon state know its irq= lines are outdated.
+ ***********************************************************************************/
+unsigned int irq_generation(void) {
+    return generation;
+}
+
+/***********************************************************************************
+ * Function Name      : irq_save
+ * Inputs             : fp (FILE *) - daemon state output
+ * Returns            : None
+ * Description        : Writes one irq=<irq> <cpus> line per IRQ we steered with
+ *                      its affinity before steering, so a restarted daemon
+ *                      restores the original instead of its own mask.
+ ***********************************************************************************/
+void irq_save(FILE* fp) {
+    for (int a = 0; a < nr_adopted; a++)
+        fprintf(fp, "irq=%d %s\n", adopted[a].irq, adopted[a].saved);
+
+    for (int i = 0; steered && i < nr_irqs; i++) {
+        if (irqs[i].saved[0])
+            fprintf(fp, "irq=%d %s\n", irqs[i].irq, irqs[i].saved);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : irq_adopt
+ * Inputs             : value (const char *) - "<irq> <cpus>" from daemon state
+ * Returns            : None
+ * Description        : Takes over an original affinity saved by a previous
+ *                      instance, used by the next steer or restore.
+ ***********************************************************************************/
+void irq_adopt(const char* value) {
+    if (nr_adopted == MAX_MANAGED_IRQS)
+        return;
+
+    if (sscanf(value, "%d %63s", &adopted[nr_adopted].irq, adopted[nr_adopted].saved) == 2)
+        nr_adopted++;
+}
+
+/***********************************************************************************
+ * Function Name      : irq_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes IRQ section of daemon status, one line per
+ *                      managed IRQ with its class, target and rate.
+ ***********************************************************************************/
+void irq_status(FILE* fp) {
+    char list[64];
+
+    fprintf(fp, "irq_steered=%d\n", steered);
+    for (int i = 0; i < nr_irqs; i++) {
+        const IrqEntry* entry = &irqs[i];
+        fprintf(fp, "irq%d=%s cpus=%s rate=%ld\n", entry->irq, irq_class_name[entry->cls],
+                steered && entry->saved[0] ? format_cpu_list(&target[entry->cls], list, sizeof(list)) : "default",
+                steered ? entry->rate : 0);
+    }
+}
@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+static int sock = -1;
+static char launch_package[MAX_PACKAGE] = {0};
+static pid_t launch_pid = 0;
+static long launch_since_ms = 0;
+static bool launch_boosted = false;
+
+// Owned by profile lane tasks, which run one at a time
+static long saved_floor[MAX_CLUSTERS];
+static bool floors_saved = false;
+static int nr_launches = 0;
+static int nr_timeouts = 0;
+static long long boosted_ms = 0;
+static int nr_boosted = 0;
+static long long plain_ms = 0;
+static int nr_plain = 0;
+
+/***********************************************************************************
+ * Function Name      : monotonic_ms
+ * Inputs             : None
+ * Returns            : long - monotonic time in milliseconds
+ ***********************************************************************************/
+static long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/***********************************************************************************
+ * Function Name      : floor_node
+ * Inputs             : cluster (const CpuCluster *) - cluster
+ *                      out (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : char * - out, scaling_min_freq of the cluster policy
+ ***********************************************************************************/
+static char* floor_node(const CpuCluster* cluster, char* out, const size_t len) {
+    snprintf(out, len, "/sys/devices/system/cpu/cpufreq/policy%d/scaling_min_freq", cluster->policy);
+    return out;
+}
+
+/***********************************************************************************
+ * Function Name      : floor_task
+ * Inputs             : task (Task *) - unused
+ * Returns            : None
+ * Description        : Raises every cluster floor to LAUNCH_FLOOR_PCT of its
+ *                      table. On the profile lane, so the floors it saves are
+ *                      never those of a half applied profile.
+ ***********************************************************************************/
+static void floor_task(Task* task) {
+    (void)task;
+    char path[MAX_PATH_LENGTH];
+
+    for (int c = 0; c < cpu_topology.nr_clusters; c++) {
+        const CpuCluster* cluster = &cpu_topology.cluster[c];
+        saved_floor[c] = read_long(floor_node(cluster, path, sizeof(path)), 0);
+        if (cluster->nr_freqs == 0)
+            continue;
+
+        long floor = cluster->freqs[(cluster->nr_freqs - 1) * LAUNCH_FLOOR_PCT / 100];
+        if (floor > saved_floor[c])
+            write2file(path, false, false, "%ld", floor);
+    }
+    floors_saved = true;
+}
+
+/***********************************************************************************
+ * Function Name      : restore_task
+ * Inputs             : task (Task *) - unused
+ * Returns            : None
+ * Description        : Puts floors back, ahead of any profile queued later.
+ ***********************************************************************************/
+static void restore_task(Task* task) {
+    (void)task;
+    char path[MAX_PATH_LENGTH];
+
+    for (int c = 0; floors_saved && c < cpu_topology.nr_clusters; c++) {
+        if (saved_floor[c] > 0)
+            write2file(floor_node(&cpu_topology.cluster[c], path, sizeof(path)), false, false, "%ld", saved_floor[c]);
+    }
+    floors_saved = false;
+}
+
+/***********************************************************************************
+ * Function Name      : preload_task
+ * Inputs             : task (Task *) - launching package and its library path
+ * Returns            : None
+ ***********************************************************************************/
+static void preload_task(Task* task) {
+    preload_directory("launch", task->text, LAUNCH_PRELOAD_MB, 0);
+}
+
+/***********************************************************************************
+ * Function Name      : apply_launch_boost
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Queues the floors and warming of native libraries of
+ *                      the game, they are mapped right after class loading.
+ *                      Detection keeps running meanwhile.
+ ***********************************************************************************/
+static void apply_launch_boost(void) {
+    Task floors = {.run = floor_task, .priority = TASK_PROFILE};
+    executor_submit(&floors);
+    launch_boosted = true;
+
+    Task preload = {.run = preload_task, .priority = TASK_PRELOAD};
+    if (!package_lib_dir(launch_package, preload.text, sizeof(preload.text)))
+        return;
+    snprintf(preload.package, sizeof(preload.package), "%s", launch_package);
+    executor_submit(&preload);
+}
+
+/***********************************************************************************
+ * Function Name      : launch_end
+ * Inputs             : restore (bool) - true to put cluster floors back
+ * Returns            : None
+ * Description        : Without restore the floors are left to the profile of
+ *                      the game, which is queued behind them.
+ ***********************************************************************************/
+static void launch_end(const bool restore) {
+    if (restore && launch_boosted) {
+        Task task = {.run = restore_task, .priority = TASK_PROFILE};
+        executor_submit(&task);
+        executor_cancel(launch_package);
+    }
+
+    launch_boosted = false;
+    launch_pid = 0;
+    launch_package[0] = '\0';
+}
+
+/***********************************************************************************
+ * Function Name      : check_process
+ * Inputs             : pid (pid_t) - process whose main thread was renamed
+ * Returns            : bool - true if a game launch started
+ * Description        : Zygote names a child after its package while it
+ *                      specializes it, cmdline follows right after with a
+ *                      second rename. Only app UIDs whose cmdline is a
+ *                      gamelist package count, secondary processes carry a
+ *                      ":name" suffix and never match.
+ ***********************************************************************************/
+static bool check_process(const pid_t pid) {
+    if (pid == launch_pid || uidof(pid) < FIRST_APPLICATION_UID)
+        return false;
+
+    char path[MAX_PATH_LENGTH];
+    char cmdline[MAX_PACKAGE] = {0};
+    snprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return false;
+    size_t len = fread(cmdline, 1, sizeof(cmdline) - 1, fp);
+    fclose(fp);
+
+    len = strnlen(cmdline, len);
+    if (!game_config_match(cmdline, len))
+        return false;
+
+    // A game coming back to foreground is a resume, not a launch
+    const GameSession* session = session_find(cmdline);
+    if (session && session->pid == pid)
+        return false;
+
+    if (launch_pid != 0)
+        launch_end(true);
+
+    snprintf(launch_package, sizeof(launch_package), "%s", cmdline);
+    launch_pid = pid;
+    launch_since_ms = monotonic_ms();
+    nr_launches++;
+
+    if (!is_enabled(LAUNCH_BOOST)) {
+        log_nusantara(LOG_DEBUG, "Launch of %s seen (PID %d), boost disabled", launch_package, pid);
+        return false;
+    }
+
+    apply_launch_boost();
+    log_nusantara(LOG_INFO, "Launch boost for %s (PID %d)", launch_package, pid);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : read_events
+ * Inputs             : None
+ * Returns            : bool - true if a game launch started
+ * Description        : Drains every queued event. Renames older than
+ *                      LAUNCH_TIMEOUT_MS would time out right away and are
+ *                      skipped. A socket that overflowed only lost events,
+ *                      reading carries on with what is left.
+ ***********************************************************************************/
+static bool read_events(void) {
+    alignas(struct nlmsghdr) char buf[4096];
+    bool launched = false;
+    ssize_t len;
+
+    // Event timestamps come from the monotonic clock
+    long oldest_ms = monotonic_ms() - LAUNCH_TIMEOUT_MS;
+    unsigned long long oldest_ns = oldest_ms > 0 ? (unsigned long long)oldest_ms * 1000000ULL : 0;
+
+    while ((len = recv(sock, buf, sizeof(buf), MSG_DONTWAIT)) > 0 || (len == -1 && errno == ENOBUFS)) {
+        if (len == -1) {
+            log_nusantara(LOG_DEBUG, "Process event queue overflowed");
+            continue;
+        }
+
+        for (struct nlmsghdr* nl = (struct nlmsghdr*)buf; NLMSG_OK(nl, (size_t)len); nl = NLMSG_NEXT(nl, len)) {
+            const struct cn_msg* cn = NLMSG_DATA(nl);
+            const struct proc_event* ev = (const struct proc_event*)cn->data;
+
+            if (ev->what == PROC_EVENT_COMM && ev->event_data.comm.process_pid == ev->event_data.comm.process_tgid &&
+                ev->timestamp_ns >= oldest_ns)
+                launched |= check_process(ev->event_data.comm.process_tgid);
+        }
+    }
+
+    return launched;
+}
+
+/***********************************************************************************
+ * Function Name      : launch_init
+ * Inputs             : None
+ * Returns            : bool - true if process events are available
+ * Description        : Subscribes to the kernel process connector. Kernels
+ *                      without CONFIG_PROC_EVENTS leave launches to the
+ *                      normal foreground detection.
+ ***********************************************************************************/
+bool launch_init(void) {
+    sock = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (sock == -1) {
+        log_nusantara(LOG_WARN, "Process connector unavailable, launch boost disabled");
+        return false;
+    }
+
+    struct sockaddr_nl addr = {.nl_family = AF_NETLINK, .nl_groups = CN_IDX_PROC};
+    alignas(struct nlmsghdr) char buf[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))] = {0};
+    struct nlmsghdr* nl = (struct nlmsghdr*)buf;
+    struct cn_msg* cn = NLMSG_DATA(nl);
+
+    nl->nlmsg_len = NLMSG_LENGTH(sizeof(*cn) + sizeof(enum proc_cn_mcast_op));
+    nl->nlmsg_type = NLMSG_DONE;
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len = sizeof(enum proc_cn_mcast_op);
+    *(enum proc_cn_mcast_op*)cn->data = PROC_CN_MCAST_LISTEN;
+
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) == -1 || send(sock, nl, nl->nlmsg_len, 0) == -1) {
+        log_nusantara(LOG_WARN, "Unable to subscribe to process events, launch boost disabled");
+        close(sock);
+        sock = -1;
+        return false;
+    }
+
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : launch_wait
+ * Inputs             : timeout_ms (int) - longest wait
+ * Returns            : bool - true if cut short by a game launch
+ * Description        : Replaces the idle sleep between rounds. The round after
+ *                      a launch runs right away and rounds stay LAUNCH_POLL_MS
+ *                      short while a launch is pending, so the game window is
+ *                      caught without waiting out LOOP_INTERVAL.
+ ***********************************************************************************/
+bool launch_wait(const int timeout_ms) {
+    if (sock == -1) {
+        usleep((useconds_t)timeout_ms * 1000);
+        return false;
+    }
+
+    long deadline = monotonic_ms() + (launch_boosted ? LAUNCH_POLL_MS : timeout_ms);
+    struct pollfd pfd = {.fd = sock, .events = POLLIN};
+
+    for (long left; (left = deadline - monotonic_ms()) > 0;) {
+        int ret = poll(&pfd, 1, (int)left);
+        if (ret < 0 && errno != EINTR)
+            break;
+        if (ret > 0 && read_events())
+            return true;
+    }
+
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : launch_poll
+ * Inputs             : None
+ * Returns            : bool - true if a game launch started
+ * Description        : Non-blocking launch_wait for the performance loop, so
+ *                      a second game started mid-session is boosted too and
+ *                      events do not pile up while a game is played.
+ ***********************************************************************************/
+bool launch_poll(void) {
+    return sock != -1 && read_events();
+}
+
+/***********************************************************************************
+ * Function Name      : launch_tick
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Once per round. Ends a launch boost that never reached
+ *                      the foreground within LAUNCH_TIMEOUT_MS, or whose
+ *                      process died on the way.
+ ***********************************************************************************/
+void launch_tick(void) {
+    if (launch_pid == 0)
+        return;
+
+    if (kill(launch_pid, 0) != 0 || monotonic_ms() - launch_since_ms >= LAUNCH_TIMEOUT_MS) {
+        log_nusantara(LOG_DEBUG, "Launch of %s timed out", launch_package);
+        nr_timeouts++;
+        launch_end(true);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : launch_handover
+ * Inputs             : session (const GameSession *) - game being boosted, NULL
+ *                                                      on any other profile
+ * Returns            : None
+ * Description        : Called before the profiler runs. The launching game
+ *                      keeps its floors for the profiler to overwrite and its
+ *                      launch to foreground time is counted, boosted or not.
+ ***********************************************************************************/
+void launch_handover(const GameSession* session) {
+    if (launch_pid == 0)
+        return;
+
+    if (!session || strcmp(session->package, launch_package) != 0) {
+        launch_end(true);
+        return;
+    }
+
+    long elapsed = monotonic_ms() - launch_since_ms;
+    if (launch_boosted) {
+        boosted_ms += elapsed;
+        nr_boosted++;
+    } else {
+        plain_ms += elapsed;
+        nr_plain++;
+    }
+
+    log_nusantara(LOG_INFO, "%s reached foreground %ldms after launch", launch_package, elapsed);
+    launch_end(false);
+}
+
+/***********************************************************************************
+ * Function Name      : launch_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes launch section of daemon status. Launch to
+ *                      foreground averages with and without the boost give
+ *                      the cold start gain.
+ ***********************************************************************************/
+void launch_status(FILE* fp) {
+    fprintf(fp, "launch_events=%s\n", sock != -1 ? "proc_connector" : "none");
+    fprintf(fp, "launch_pending=%s\n", launch_package);
+    fprintf(fp, "launch_seen=%d\n", nr_launches);
+    fprintf(fp, "launch_timeouts=%d\n", nr_timeouts);
+    fprintf(fp, "launch_boosted=%d avg_ms=%lld\n", nr_boosted, nr_boosted ? boosted_ms / nr_boosted : 0);
+    fprintf(fp, "launch_plain=%d avg_ms=%lld\n", nr_plain, nr_plain ? plain_ms / nr_plain : 0);
+}
@@ -76,20 +76,21 @@ void toast(const char* message) {
 /***********************************************************************************
  * Function Name      : timern
  * Inputs             : None
- * Returns            : char * - pointer to a statically allocated string
+ * Returns            : char * - pointer to a per-thread static string
  *                      with the formatted time.
  * Description        : Generates a timestamp with the format
  *                      [YYYY-MM-DD HH:MM:SS.milliseconds].
  ***********************************************************************************/
 char* timern(void) {
-    static char timestamp[64];
+    static _Thread_local char timestamp[64];
     struct timeval tv;
     time_t current_time;
+    struct tm tm_buf;
     struct tm* local_time;
 
     gettimeofday(&tv, NULL);
     current_time = tv.tv_sec;
-    local_time = localtime(&current_time);
+    local_time = localtime_r(&current_time, &tm_buf);
 
     if (local_time == NULL) [[clang::unlikely]] {
         strcpy(timestamp, "[TimeError]");
@@ -172,3 +173,32 @@ bool return_true(void) {
 bool return_false(void) {
     return false;
 }
+
+/***********************************************************************************
+ * Function Name      : get_meminfo
+ * Inputs             : mem_total_mb (long *) - output, MemTotal in MB
+ *                      mem_avail_mb (long *) - output, MemAvailable in MB
+ * Returns            : bool - true if /proc/meminfo was readable
+ * Description        : Reads total and available memory.
+ ***********************************************************************************/
+bool get_meminfo(long* mem_total_mb, long* mem_avail_mb) {
+    FILE* meminfo = fopen("/proc/meminfo", "r");
+    if (!meminfo) [[clang::unlikely]]
+        return false;
+
+    char line[MAX_OUTPUT_LENGTH];
+    long v;
+    int found = 0;
+    while (found < 2 && fgets(line, sizeof(line), meminfo)) {
+        if (sscanf(line, "MemTotal: %ld kB", &v) == 1) {
+            *mem_total_mb = v / 1024;
+            found++;
+        } else if (sscanf(line, "MemAvailable: %ld kB", &v) == 1) {
+            *mem_avail_mb = v / 1024;
+            found++;
+        }
+    }
+
+    fclose(meminfo);
+    return found == 2;
+}
@@ -0,0 +1,377 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+#define NET_SYSCTLS (sizeof(net_sysctls) / sizeof(net_sysctls[0]))
+
+typedef enum : char {
+    NET_HELD,      // values before performance profile
+    NET_LATENCY,   // game has live real-time flows
+    NET_PROFILED   // whatever the profiler wrote, not managed
+} NetMode;
+
+// Latency value of each managed sysctl, congestion control is picked from the available list
+static const struct {
+    const char* node;
+    const char* latency;
+} net_sysctls[] = {
+    {"/proc/sys/net/ipv4/tcp_slow_start_after_idle", "0"},
+    {"/proc/sys/net/ipv4/tcp_fastopen", "3"},
+    {"/proc/sys/net/ipv4/tcp_ecn", "1"},
+    {"/proc/sys/net/ipv4/tcp_low_latency", "1"},
+    {"/proc/sys/net/ipv4/tcp_congestion_control", NULL},
+};
+
+static const char* net_congestion_pref[] = {"bbr", "westwood", "cubic"};
+static const char* net_mode_name[] = {"held", "latency", "profiled"};
+
+// Socket tables, udp before tcp so connected UDP is seen first
+static const struct {
+    const char* path;
+    bool udp;
+} net_tables[] = {
+    {"/proc/net/udp", true},
+    {"/proc/net/udp6", true},
+    {"/proc/net/tcp", false},
+    {"/proc/net/tcp6", false},
+};
+
+static char held[NET_SYSCTLS][32];
+static char profiled[NET_SYSCTLS][32];
+static bool have_held = false;
+static NetMode cur_mode = NET_PROFILED;
+static int game_uid = -1;
+static int tick_count = 0;
+static int idle_count = 0;
+static int game_flows = 0;
+static unsigned long long last_packets = 0;
+static unsigned long long last_bytes = 0;
+static struct timespec last_sample = {0};
+static long pps = 0;
+static long packet_size = 0;
+
+/***********************************************************************************
+ * Function Name      : read_sysctls
+ * Inputs             : out (char [][32]) - receives current values
+ * Returns            : None
+ ***********************************************************************************/
+static void read_sysctls(char out[][32]) {
+    for (size_t i = 0; i < NET_SYSCTLS; i++) {
+        out[i][0] = '\0';
+        FILE* fp = fopen(net_sysctls[i].node, "r");
+        if (!fp)
+            continue;
+        if (!fgets(out[i], sizeof(out[i]), fp))
+            out[i][0] = '\0';
+        fclose(fp);
+        trim_newline(out[i]);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : write_sysctls
+ * Inputs             : values (char [][32]) - values, empty ones are skipped
+ * Returns            : None
+ ***********************************************************************************/
+static void write_sysctls(char values[][32]) {
+    for (size_t i = 0; i < NET_SYSCTLS; i++) {
+        if (values[i][0])
+            write2file(net_sysctls[i].node, false, false, "%s", values[i]);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : apply_latency
+ * Inputs             : None
+ * Returns            : None
+ ***********************************************************************************/
+static void apply_latency(void) {
+    char available[MAX_LINE] = {0};
+    FILE* fp = fopen("/proc/sys/net/ipv4/tcp_available_congestion_control", "r");
+    if (fp) {
+        if (!fgets(available, sizeof(available), fp))
+            available[0] = '\0';
+        fclose(fp);
+    }
+
+    for (size_t i = 0; i < NET_SYSCTLS; i++) {
+        if (net_sysctls[i].latency) {
+            write2file(net_sysctls[i].node, false, false, "%s", net_sysctls[i].latency);
+            continue;
+        }
+
+        // Word match, "bbr" must not match "bbr2" only lists
+        for (size_t c = 0; c < sizeof(net_congestion_pref) / sizeof(net_congestion_pref[0]); c++) {
+            const char* hit = strstr(available, net_congestion_pref[c]);
+            size_t len = strlen(net_congestion_pref[c]);
+            if (hit && (hit == available || hit[-1] == ' ') && (hit[len] == ' ' || hit[len] == '\n' || !hit[len])) {
+                write2file(net_sysctls[i].node, false, false, "%s", net_congestion_pref[c]);
+                break;
+            }
+        }
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : next_field
+ * Inputs             : p (char **) - parse position, advanced past the field
+ * Returns            : char * - start of the field
+ ***********************************************************************************/
+static inline char* next_field(char** p) {
+    char* s = *p;
+    while (*s == ' ')
+        s++;
+    char* start = s;
+    while (*s && *s != ' ')
+        s++;
+    *p = s;
+    return start;
+}
+
+/***********************************************************************************
+ * Function Name      : remote_is_peer
+ * Inputs             : addr (const char *) - "<hex address>:<hex port>" field
+ * Returns            : bool - true for a non loopback remote end
+ * Description        : Addresses are printed as host order words, IPv4
+ *                      127.0.0.0/8 ends in "7F", also inside a v4 mapped v6.
+ ***********************************************************************************/
+static bool remote_is_peer(const char* addr) {
+    const char* colon = strchr(addr, ':');
+    if (!colon || colon - addr < 8)
+        return false;
+
+    if (strncmp(colon + 1, "0000", 4) == 0)
+        return false;
+
+    bool zero = true;
+    for (const char* c = addr; c < colon && zero; c++)
+        zero = *c == '0';
+    if (zero)
+        return false;
+
+    if (colon - addr == 8)
+        return strncmp(colon - 2, "7F", 2) != 0;
+
+    // ::1 and ::ffff:127.x.x.x
+    if (strncmp(addr, "0000000000000000", 16) == 0 &&
+        (strncmp(addr + 16, "0000000001000000", 16) == 0 || (strncmp(addr + 16, "FFFF0000", 8) == 0 && strncmp(colon - 2, "7F", 2) == 0)))
+        return false;
+
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : net_game_flows
+ * Inputs             : uid (int) - game UID
+ * Returns            : int - established TCP and connected UDP sockets of the
+ *                            UID with a remote peer
+ * Description        : Parses the socket tables by hand, they reach tens of
+ *                      thousands of lines on busy devices and sscanf per line
+ *                      dominates the sample.
+ ***********************************************************************************/
+int net_game_flows(const int uid) {
+    char line[MAX_LINE];
+    int flows = 0;
+
+    for (size_t t = 0; t < sizeof(net_tables) / sizeof(net_tables[0]); t++) {
+        FILE* fp = fopen(net_tables[t].path, "r");
+        if (!fp)
+            continue;
+
+        // Header
+        if (!fgets(line, sizeof(line), fp)) {
+            fclose(fp);
+            continue;
+        }
+
+        while (fgets(line, sizeof(line), fp)) {
+            char* p = line;
+            next_field(&p);                // sl
+            next_field(&p);                // local_address
+            char* remote = next_field(&p);
+            char* st = next_field(&p);
+            next_field(&p);                // tx_queue:rx_queue
+            next_field(&p);                // tr:tm->when
+            next_field(&p);                // retrnsmt
+            char* owner = next_field(&p);
+
+            // Both TCP_ESTABLISHED and a connected UDP socket show state 01
+            if (st[0] != '0' || st[1] != '1' || atoi(owner) != uid)
+                continue;
+            if (remote_is_peer(remote))
+                flows++;
+        }
+
+        fclose(fp);
+    }
+
+    return flows;
+}
+
+/***********************************************************************************
+ * Function Name      : sample_traffic
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Packet rate and average packet size over every non
+ *                      loopback interface from /proc/net/dev.
+ ***********************************************************************************/
+static void sample_traffic(void) {
+    FILE* fp = fopen("/proc/net/dev", "r");
+    if (!fp)
+        return;
+
+    char line[MAX_LINE];
+    unsigned long long packets = 0, bytes = 0;
+
+    while (fgets(line, sizeof(line), fp)) {
+        char* colon = strchr(line, ':');
+        if (!colon)
+            continue;
+
+        char* name = line;
+        while (*name == ' ')
+            name++;
+        if (strncmp(name, "lo:", 3) == 0)
+            continue;
+
+        unsigned long long rx_bytes, rx_packets, tx_bytes, tx_packets;
+        if (sscanf(colon + 1, "%llu %llu %*u %*u %*u %*u %*u %*u %llu %llu", &rx_bytes, &rx_packets, &tx_bytes, &tx_packets) != 4)
+            continue;
+        packets += rx_packets + tx_packets;
+        bytes += rx_bytes + tx_bytes;
+    }
+    fclose(fp);
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long elapsed_ms = (now.tv_sec - last_sample.tv_sec) * 1000 + (now.tv_nsec - last_sample.tv_nsec) / 1000000;
+
+    if (elapsed_ms > 0 && last_packets > 0 && packets >= last_packets) {
+        pps = (long)((packets - last_packets) * 1000 / (unsigned long long)elapsed_ms);
+        packet_size = packets > last_packets ? (long)((bytes - last_bytes) / (packets - last_packets)) : 0;
+    }
+
+    last_packets = packets;
+    last_bytes = bytes;
+    last_sample = now;
+}
+
+/***********************************************************************************
+ * Function Name      : net_monitor_hold
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Called before the profiler applies performance, keeps
+ *                      the network values in place outside of a game so they
+ *                      can be held until the game goes online.
+ ***********************************************************************************/
+void net_monitor_hold(void) {
+    if (!is_enabled(NET_MONITOR))
+        return;
+
+    read_sysctls(held);
+    have_held = true;
+}
+
+/***********************************************************************************
+ * Function Name      : net_monitor_start
+ * Inputs             : uid (int) - game UID
+ * Returns            : None
+ * Description        : Snapshots what the profiler wrote and goes back to the
+ *                      held values until the game shows real-time traffic.
+ *                      Without held values, e.g. resumed after a restart, the
+ *                      profiler values stay until the first online round.
+ ***********************************************************************************/
+void net_monitor_start(const int uid) {
+    if (!is_enabled(NET_MONITOR) || uid < FIRST_APPLICATION_UID)
+        return;
+
+    read_sysctls(profiled);
+    if (have_held)
+        write_sysctls(held);
+
+    cur_mode = have_held ? NET_HELD : NET_PROFILED;
+    game_uid = uid;
+    tick_count = 0;
+    idle_count = 0;
+    last_packets = 0;
+    pps = 0;
+    packet_size = 0;
+    sample_traffic();
+}
+
+/***********************************************************************************
+ * Function Name      : net_monitor_tick
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Samples every NET_SAMPLE_TICKS performance ticks. Real
+ *                      time play is a live game flow plus a steady rate of
+ *                      small packets, bulk downloads move full sized packets.
+ *                      Latency mode ends after NET_IDLE_SAMPLES samples
+ *                      without it, matchmaking gaps keep it on.
+ ***********************************************************************************/
+void net_monitor_tick(void) {
+    if (game_uid < 0 || ++tick_count < NET_SAMPLE_TICKS)
+        return;
+    tick_count = 0;
+
+    sample_traffic();
+    game_flows = net_game_flows(game_uid);
+    bool realtime = game_flows > 0 && pps >= NET_ACTIVE_PPS && packet_size <= NET_RT_MAX_PACKET;
+
+    if (realtime) {
+        idle_count = 0;
+        if (cur_mode != NET_LATENCY) {
+            log_nusantara(LOG_DEBUG, "Game online, %d flows at %ld packets/s", game_flows, pps);
+            apply_latency();
+            cur_mode = NET_LATENCY;
+        }
+    } else if (cur_mode == NET_LATENCY && ++idle_count >= NET_IDLE_SAMPLES) {
+        log_nusantara(LOG_DEBUG, "Game offline, restoring network values");
+        write_sysctls(have_held ? held : profiled);
+        cur_mode = have_held ? NET_HELD : NET_PROFILED;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : net_monitor_stop
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Puts the profiler values back before the next profile
+ *                      runs.
+ ***********************************************************************************/
+void net_monitor_stop(void) {
+    if (game_uid < 0)
+        return;
+
+    if (cur_mode != NET_PROFILED)
+        write_sysctls(profiled);
+
+    cur_mode = NET_PROFILED;
+    game_uid = -1;
+}
+
+/***********************************************************************************
+ * Function Name      : net_monitor_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes network section of daemon status.
+ ***********************************************************************************/
+void net_monitor_status(FILE* fp) {
+    fprintf(fp, "net_mode=%s\n", game_uid < 0 ? "none" : net_mode_name[cur_mode]);
+    fprintf(fp, "net_game_flows=%d\n", game_uid < 0 ? 0 : game_flows);
+    fprintf(fp, "net_pps=%ld\n", game_uid < 0 ? 0 : pps);
+}
@@ -26,36 +26,91 @@ bool (*get_low_power_state)(void) = get_low_power_state_normal;
  *                            2 for normal
  *                            3 for powersave
  * Returns            : None
- * Description        : Switch to specified performance profile.
+ * Description        : Switch to specified performance profile. Runs on the
+ *                      profile lane of the executor, gameinfo is published by
+ *                      the caller before it is queued.
  ***********************************************************************************/
 void run_profiler(const int profile) {
     is_kanged();
 
-    if (profile == 1) {
-        write2file(GAME_INFO, false, false, "%s %d %d\n", gamestart, game_pid, uidof(game_pid));
-    } else {
-        write2file(GAME_INFO, false, false, "NULL 0 0\n");
-    }
-
     write2file(PROFILE_MODE, false, false, "%d\n", profile);
     if (systemv("nusantara_profiler %d", profile)) {
         log_nusantara(LOG_ERROR, "Unable to execute profiler changes to %d", profile);
     }
 }
 
+/***********************************************************************************
+ * Function Name      : focused_game
+ * Inputs             : games (char [][MAX_PACKAGE]) - visible games
+ *                      n (int) - number of visible games
+ * Returns            : int - index of the game holding focus, 0 if none does
+ * Description        : Split-screen and PiP show several games at once, the
+ *                      one the user last touched is the one to boost. Input
+ *                      focus comes first, focused activity covers a popup or
+ *                      IME holding it.
+ ***********************************************************************************/
+static int focused_game(char games[][MAX_PACKAGE], const int n) {
+    char* focus = execute_command("dumpsys window | grep -E 'mCurrentFocus=|mFocusedApp='");
+    if (!focus)
+        return 0;
+
+    for (char* line = strtok(focus, "\n"); line; line = strtok(NULL, "\n")) {
+        for (int i = 0; i < n; i++) {
+            char* hit = strstr(line, games[i]);
+            if (hit && hit[strlen(games[i])] == '/')
+                return i;
+        }
+    }
+
+    return 0;
+}
+
 /***********************************************************************************
  * Function Name      : get_gamestart
- * Inputs             : None
- * Returns            : char* (dynamically allocated string with the game package name)
+ * Inputs             : out (char *) - receives the game package name
+ *                      len (size_t) - output buffer size
+ * Returns            : bool - true if a game is visible
  * Description        : Searches for the currently visible application that matches
- *                      any package name listed in gamelist.
+ *                      any package name listed in gamelist or gameconfig.
  *                      This helps identify if a specific game is running in the foreground.
- *                      Uses dumpsys to retrieve visible apps and filters by packages
- *                      listed in Gamelist.
- * Note               : Caller is responsible for freeing the returned string.
+ *                      Reads visible apps from dumpsys and looks every package= token
+ *                      up in the game table, no grep pipeline involved. With more
+ *                      than one game visible the focused one wins.
  ***********************************************************************************/
-char* get_gamestart(void) {
-    return execute_command("dumpsys window visible-apps | grep 'package=.* ' | grep -Eo -f %s", GAMELIST);
+bool get_gamestart(char* out, const size_t len) {
+    FILE* fp = popen("/system/bin/dumpsys window visible-apps", "r");
+    if (!fp) [[clang::unlikely]]
+        return false;
+
+    char line[MAX_LINE];
+    char games[MAX_VISIBLE_GAMES][MAX_PACKAGE];
+    int n = 0;
+
+    while (n < MAX_VISIBLE_GAMES && fgets(line, sizeof(line), fp)) {
+        for (char* p = strstr(line, "package="); p && n < MAX_VISIBLE_GAMES; p = strstr(p, "package=")) {
+            p += strlen("package=");
+            size_t name_len = strcspn(p, " }\r\n");
+            if (name_len >= len || name_len >= MAX_PACKAGE || !game_config_match(p, name_len))
+                continue;
+
+            bool seen = false;
+            for (int i = 0; i < n && !seen; i++)
+                seen = strncmp(games[i], p, name_len) == 0 && games[i][name_len] == '\0';
+            if (!seen)
+                snprintf(games[n++], MAX_PACKAGE, "%.*s", (int)name_len, p);
+        }
+    }
+
+    // Drain so dumpsys does not die on SIGPIPE
+    while (fgets(line, sizeof(line), fp))
+        ;
+    pclose(fp);
+
+    if (n == 0)
+        return false;
+
+    snprintf(out, len, "%s", games[n > 1 ? focused_game(games, n) : 0]);
+    return true;
 }
 
 /***********************************************************************************
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+#define APP_DIR "/data/app"
+
+typedef struct {
+    char name[MAX_PACKAGE];
+    char apk[MAX_PATH_LENGTH];
+} PackageEntry;
+
+static PackageEntry* packages = NULL;
+static int nr_packages = 0;
+static int cap_packages = 0;
+
+/***********************************************************************************
+ * Function Name      : index_add
+ * Inputs             : parent (const char *) - directory holding the install dir
+ *                      dir (const char *) - install dir, "<package>-<suffix>"
+ * Returns            : None
+ ***********************************************************************************/
+static void index_add(const char* parent, const char* dir) {
+    const char* dash = strchr(dir, '-');
+    if (!dash || dash == dir || (size_t)(dash - dir) >= MAX_PACKAGE || nr_packages == MAX_INDEXED_PACKAGES)
+        return;
+
+    if (nr_packages == cap_packages) {
+        int cap = cap_packages ? cap_packages * 2 : 256;
+        PackageEntry* grown = realloc(packages, cap * sizeof(*packages));
+        if (!grown) [[clang::unlikely]]
+            return;
+        packages = grown;
+        cap_packages = cap;
+    }
+
+    PackageEntry* entry = &packages[nr_packages];
+    snprintf(entry->name, sizeof(entry->name), "%.*s", (int)(dash - dir), dir);
+    if (snprintf(entry->apk, sizeof(entry->apk), "%s/%s/base.apk", parent, dir) >= (int)sizeof(entry->apk))
+        return;
+
+    nr_packages++;
+}
+
+static int compare_entry(const void* a, const void* b) {
+    return strcmp(((const PackageEntry*)a)->name, ((const PackageEntry*)b)->name);
+}
+
+/***********************************************************************************
+ * Function Name      : package_index_build
+ * Inputs             : None
+ * Returns            : int - number of indexed packages
+ * Description        : Indexes install dirs of /data/app, both the flat layout
+ *                      and the randomized "~~<id>==/<package>-<id>==" layout of
+ *                      Android 11+. Lets preload find a game without spawning
+ *                      package manager.
+ ***********************************************************************************/
+int package_index_build(void) {
+    nr_packages = 0;
+
+    DIR* dir = opendir(APP_DIR);
+    if (!dir) [[clang::unlikely]]
+        return 0;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir))) {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        if (strncmp(entry->d_name, "~~", 2) != 0) {
+            index_add(APP_DIR, entry->d_name);
+            continue;
+        }
+
+        char parent[MAX_PATH_LENGTH];
+        snprintf(parent, sizeof(parent), APP_DIR "/%s", entry->d_name);
+        DIR* sub = opendir(parent);
+        if (!sub)
+            continue;
+
+        struct dirent* app;
+        while ((app = readdir(sub))) {
+            if (app->d_name[0] != '.')
+                index_add(parent, app->d_name);
+        }
+        closedir(sub);
+    }
+
+    closedir(dir);
+
+    qsort(packages, nr_packages, sizeof(*packages), compare_entry);
+    return nr_packages;
+}
+
+/***********************************************************************************
+ * Function Name      : package_index_find
+ * Inputs             : package (const char *) - package name
+ *                      out (char *) - receives base.apk path
+ *                      len (size_t) - output buffer size
+ * Returns            : bool - true if indexed and still installed there
+ * Description        : Updates move the install dir, callers fall back to
+ *                      package manager when this returns false.
+ ***********************************************************************************/
+bool package_index_find(const char* package, char* out, const size_t len) {
+    if (nr_packages == 0)
+        return false;
+
+    PackageEntry key;
+    snprintf(key.name, sizeof(key.name), "%s", package);
+    const PackageEntry* entry = bsearch(&key, packages, nr_packages, sizeof(*packages), compare_entry);
+    if (!entry || access(entry->apk, F_OK) != 0)
+        return false;
+
+    snprintf(out, len, "%s", entry->apk);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : package_lib_dir
+ * Inputs             : package (const char *) - package name
+ *                      out (char *) - receives lib directory path
+ *                      len (size_t) - output buffer size
+ * Returns            : bool - true if the package is indexed
+ * Description        : Native libraries extracted next to base.apk, one
+ *                      subdirectory per ABI.
+ ***********************************************************************************/
+bool package_lib_dir(const char* package, char* out, const size_t len) {
+    if (!package_index_find(package, out, len))
+        return false;
+
+    char* slash = strrchr(out, '/');
+    if (!slash)
+        return false;
+
+    snprintf(slash, len - (size_t)(slash - out), "/lib");
+    return true;
+}
@@ -0,0 +1,409 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+#define MAX_GAME_THREADS 512
+
+typedef struct {
+    pid_t tid;
+    unsigned long ticks;
+    bool seen;
+} ThreadSample;
+
+// Floors in percent of cluster frequency table, PERF_LEVEL_MAX keeps profiler floors
+static const int level_floor_pct[PERF_LEVEL_MAX] = {0, 40, 65};
+static const int level_uclamp[PERF_LEVEL_MAX] = {0, 256, 410};
+
+// Demand (percent) needed to step up from a level, and to stay on it
+static const int level_up_demand[PERF_LEVEL_MAX] = {35, 55, 75};
+static const int level_down_demand[PERF_LEVEL_MAX + 1] = {0, 20, 40, 60};
+
+const char* perf_level_name[PERF_LEVEL_MAX + 1] = {"light", "medium", "heavy", "max"};
+
+static ThreadSample samples[MAX_GAME_THREADS];
+static int nr_samples = 0;
+static unsigned long long tis_last[MAX_CLUSTERS][MAX_CLUSTER_FREQS];
+static long saved_floor[MAX_CLUSTERS];
+static char saved_gov[MAX_CLUSTERS][32];
+static char default_gov[32] = {0};
+static struct timespec last_sample = {0};
+static pid_t controlled_pid = 0;
+static PerfLevel cur_level = PERF_LEVEL_MAX;
+static int below_count = 0;
+static int demand = 0;
+static int touch_pct = 0;
+
+/***********************************************************************************
+ * Function Name      : policy_node
+ * Inputs             : cluster (const CpuCluster *) - cluster
+ *                      node (const char *) - cpufreq node name
+ *                      out (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : char * - out
+ * Description        : Builds path of a cpufreq policy node.
+ ***********************************************************************************/
+static char* policy_node(const CpuCluster* cluster, const char* node, char* out, const size_t len) {
+    snprintf(out, len, "/sys/devices/system/cpu/cpufreq/policy%d/%s", cluster->policy, node);
+    return out;
+}
+
+/***********************************************************************************
+ * Function Name      : read_string
+ * Inputs             : path (const char *) - node
+ *                      out (char *) - output buffer
+ *                      len (size_t) - output buffer size
+ * Returns            : bool - true on success
+ * Description        : Reads first line of a node without newline.
+ ***********************************************************************************/
+static bool read_string(const char* path, char* out, const size_t len) {
+    FILE* fp = fopen(path, "r");
+    if (!fp)
+        return false;
+
+    bool ok = fgets(out, len, fp) != NULL;
+    fclose(fp);
+    if (ok)
+        trim_newline(out);
+    return ok;
+}
+
+/***********************************************************************************
+ * Function Name      : sample_peak_thread
+ * Inputs             : pid (pid_t) - game PID
+ *                      elapsed_ticks (unsigned long) - clock ticks since last sample
+ * Returns            : int - utilization of the busiest thread in percent, -1 if
+ *                            the game is gone
+ * Description        : Sums utime + stime deltas of every game thread from
+ *                      /proc/<pid>/task/<tid>/stat and returns the heaviest one,
+ *                      which is what bounds frame time.
+ ***********************************************************************************/
+static int sample_peak_thread(const pid_t pid, const unsigned long elapsed_ticks) {
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "/proc/%d/task", pid);
+    DIR* task_dir = opendir(path);
+    if (!task_dir)
+        return -1;
+
+    for (int i = 0; i < nr_samples; i++)
+        samples[i].seen = false;
+
+    unsigned long peak = 0;
+    struct dirent* entry;
+    char stat[MAX_LINE];
+
+    while ((entry = readdir(task_dir))) {
+        if (!isdigit((unsigned char)entry->d_name[0]))
+            continue;
+
+        snprintf(path, sizeof(path), "/proc/%d/task/%s/stat", pid, entry->d_name);
+        FILE* fp = fopen(path, "r");
+        if (!fp)
+            continue;
+
+        bool ok = fgets(stat, sizeof(stat), fp) != NULL;
+        fclose(fp);
+        if (!ok)
+            continue;
+
+        // comm may contain spaces, fields restart after the last ')'
+        char* p = strrchr(stat, ')');
+        unsigned long utime, stime;
+        if (!p || sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2)
+            continue;
+
+        pid_t tid = (pid_t)atoi(entry->d_name);
+        unsigned long ticks = utime + stime;
+
+        ThreadSample* sample = NULL;
+        for (int i = 0; i < nr_samples; i++) {
+            if (samples[i].tid == tid) {
+                sample = &samples[i];
+                break;
+            }
+        }
+
+        if (!sample) {
+            if (nr_samples == MAX_GAME_THREADS)
+                continue;
+            sample = &samples[nr_samples++];
+            sample->tid = tid;
+            sample->ticks = ticks;
+        }
+
+        if (ticks - sample->ticks > peak)
+            peak = ticks - sample->ticks;
+        sample->ticks = ticks;
+        sample->seen = true;
+    }
+
+    closedir(task_dir);
+
+    // Drop exited threads
+    for (int i = 0; i < nr_samples;) {
+        if (!samples[i].seen)
+            samples[i] = samples[--nr_samples];
+        else
+            i++;
+    }
+
+    if (elapsed_ticks == 0)
+        return 0;
+
+    unsigned long util = peak * 100 / elapsed_ticks;
+    return util > 100 ? 100 : (int)util;
+}
+
+/***********************************************************************************
+ * Function Name      : sample_freq_ratio
+ * Inputs             : None
+ * Returns            : int - average frequency of the busiest performance
+ *                            cluster in percent of its max frequency
+ * Description        : Reads cpufreq stats/time_in_state deltas, so thread
+ *                      utilization can be normalized to work actually done.
+ ***********************************************************************************/
+static int sample_freq_ratio(void) {
+    int best = 100;
+    bool found = false;
+
+    for (int c = 0; c < cpu_topology.nr_clusters; c++) {
+        const CpuCluster* cluster = &cpu_topology.cluster[c];
+        char path[MAX_PATH_LENGTH];
+        FILE* fp = fopen(policy_node(cluster, "stats/time_in_state", path, sizeof(path)), "r");
+        if (!fp)
+            continue;
+
+        unsigned long long weighted = 0, total = 0;
+        long freq;
+        unsigned long long time;
+        int idx = 0;
+
+        while (idx < MAX_CLUSTER_FREQS && fscanf(fp, "%ld %llu", &freq, &time) == 2) {
+            unsigned long long delta = time - tis_last[c][idx];
+            tis_last[c][idx++] = time;
+            weighted += delta * (unsigned long long)freq;
+            total += delta;
+        }
+        fclose(fp);
+
+        // Game threads live on big + prime, little cluster says nothing here
+        if (cluster->type == CLUSTER_LITTLE && cpu_topology.nr_clusters > 1)
+            continue;
+        if (total == 0 || cluster->max_freq <= 0)
+            continue;
+
+        int ratio = (int)(weighted / total * 100 / cluster->max_freq);
+        if (!found || ratio > best)
+            best = ratio;
+        found = true;
+    }
+
+    return found ? (best > 100 ? 100 : best) : 100;
+}
+
+/***********************************************************************************
+ * Function Name      : level_floor
+ * Inputs             : c (int) - cluster index
+ *                      level (PerfLevel) - level
+ * Returns            : long - floor of the cluster at the level, raised to the
+ *                            touch floor while a touch boost is on
+ ***********************************************************************************/
+static long level_floor(const int c, const PerfLevel level) {
+    const CpuCluster* cluster = &cpu_topology.cluster[c];
+    int pct = level == PERF_LEVEL_MAX ? 0 : level_floor_pct[level];
+    if (touch_pct > pct)
+        pct = touch_pct;
+
+    long floor = cluster->nr_freqs > 0 ? cluster->freqs[(cluster->nr_freqs - 1) * pct / 100] : cluster->min_freq;
+    if (level == PERF_LEVEL_MAX && (touch_pct == 0 || saved_floor[c] > floor))
+        floor = saved_floor[c];
+    return floor;
+}
+
+/***********************************************************************************
+ * Function Name      : apply_level
+ * Inputs             : level (PerfLevel) - level to apply
+ * Returns            : None
+ * Description        : Writes per-cluster frequency floors and game uclamp of a
+ *                      level. PERF_LEVEL_MAX puts back what the profiler wrote.
+ ***********************************************************************************/
+static void apply_level(const PerfLevel level) {
+    char path[MAX_PATH_LENGTH];
+
+    for (int c = 0; c < cpu_topology.nr_clusters; c++) {
+        const CpuCluster* cluster = &cpu_topology.cluster[c];
+        long floor = level_floor(c, level);
+
+        if (level == PERF_LEVEL_MAX) {
+            if (saved_gov[c][0])
+                write2file(policy_node(cluster, "scaling_governor", path, sizeof(path)), false, false, "%s", saved_gov[c]);
+            if (floor > 0)
+                write2file(policy_node(cluster, "scaling_min_freq", path, sizeof(path)), false, false, "%ld", floor);
+            continue;
+        }
+
+        // Floors mean nothing under a pinned governor, hand frequency back to default one
+        if (strcmp(saved_gov[c], "performance") == 0 && default_gov[0])
+            write2file(policy_node(cluster, "scaling_governor", path, sizeof(path)), false, false, "%s", default_gov);
+
+        write2file(policy_node(cluster, "scaling_min_freq", path, sizeof(path)), false, false, "%ld", floor);
+    }
+
+    set_boost_uclamp_cap(level == PERF_LEVEL_MAX ? 1024 : level_uclamp[level]);
+    cur_level = level;
+}
+
+/***********************************************************************************
+ * Function Name      : perf_controller_start
+ * Inputs             : pid (pid_t) - game PID
+ * Returns            : None
+ * Description        : Snapshots floors and governors written by the profiler,
+ *                      they define the top level. Starts at top level so a new
+ *                      session never begins slower than before.
+ ***********************************************************************************/
+void perf_controller_start(const pid_t pid) {
+    char path[MAX_PATH_LENGTH];
+
+    for (int c = 0; c < cpu_topology.nr_clusters; c++) {
+        const CpuCluster* cluster = &cpu_topology.cluster[c];
+        saved_floor[c] = read_long(policy_node(cluster, "scaling_min_freq", path, sizeof(path)), 0);
+        if (!read_string(policy_node(cluster, "scaling_governor", path, sizeof(path)), saved_gov[c], sizeof(saved_gov[c])))
+            saved_gov[c][0] = '\0';
+    }
+
+    if (!read_string(MODULE_CONFIG "/custom_default_cpu_gov", default_gov, sizeof(default_gov)) &&
+        !read_string(MODULE_CONFIG "/default_cpu_gov", default_gov, sizeof(default_gov)))
+        default_gov[0] = '\0';
+
+    memset(tis_last, 0, sizeof(tis_last));
+    nr_samples = 0;
+    below_count = 0;
+    demand = 100;
+    touch_pct = 0;
+    controlled_pid = pid;
+    cur_level = PERF_LEVEL_MAX;
+
+    // Prime the deltas
+    clock_gettime(CLOCK_MONOTONIC, &last_sample);
+    sample_peak_thread(pid, 0);
+    sample_freq_ratio();
+}
+
+/***********************************************************************************
+ * Function Name      : perf_controller_tick
+ * Inputs             : pid (pid_t) - game PID
+ * Returns            : bool - false if the game process is gone
+ * Description        : One control step. Demand is the busiest game thread
+ *                      utilization scaled by how fast its cluster was running.
+ *                      Steps up right away when demand crosses the level
+ *                      threshold, steps down one level only after demand stays
+ *                      below the lower threshold for PERF_DOWN_SAMPLES ticks.
+ ***********************************************************************************/
+bool perf_controller_tick(const pid_t pid) {
+    if (pid != controlled_pid)
+        perf_controller_start(pid);
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long elapsed_ms = (now.tv_sec - last_sample.tv_sec) * 1000 + (now.tv_nsec - last_sample.tv_nsec) / 1000000;
+    unsigned long elapsed = (unsigned long)(sysconf(_SC_CLK_TCK) * elapsed_ms / 1000);
+    last_sample = now;
+
+    int peak = sample_peak_thread(pid, elapsed);
+    if (peak < 0)
+        return false;
+
+    demand = peak * sample_freq_ratio() / 100;
+
+    PerfLevel target = cur_level;
+    if (cur_level < PERF_LEVEL_MAX && demand >= level_up_demand[cur_level]) {
+        target = cur_level + 1;
+        below_count = 0;
+    } else if (cur_level > PERF_LEVEL_LIGHT && demand < level_down_demand[cur_level]) {
+        if (++below_count >= PERF_DOWN_SAMPLES) {
+            target = cur_level - 1;
+            below_count = 0;
+        }
+    } else {
+        below_count = 0;
+    }
+
+    // Thermal cap already walks down one level at a time
+    PerfLevel cap = thermal_level_cap();
+    if (target > cap)
+        target = cap;
+
+    if (target != cur_level) {
+        log_nusantara(LOG_DEBUG, "Performance level %s -> %s (demand %d%%)", perf_level_name[cur_level],
+                      perf_level_name[target], demand);
+        apply_level(target);
+    }
+
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : perf_controller_stop
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Puts profiler floors back before the next profile runs.
+ ***********************************************************************************/
+void perf_controller_stop(void) {
+    if (controlled_pid == 0)
+        return;
+
+    bool touched = touch_pct > 0;
+    touch_pct = 0;
+    if (cur_level != PERF_LEVEL_MAX || touched)
+        apply_level(PERF_LEVEL_MAX);
+
+    controlled_pid = 0;
+}
+
+/***********************************************************************************
+ * Function Name      : perf_controller_touch
+ * Inputs             : pct (int) - floor in percent of cluster frequency table,
+ *                                  0 ends the touch boost
+ * Returns            : None
+ * Description        : Raises cluster floors above the current level for a
+ *                      touch boost. Only floors are written, the level and
+ *                      uclamp stay with the controller. The bump never goes
+ *                      past the floor of the thermal cap.
+ ***********************************************************************************/
+void perf_controller_touch(const int pct) {
+    PerfLevel cap = thermal_level_cap();
+    int bump = cap < PERF_LEVEL_MAX && pct > level_floor_pct[cap] ? level_floor_pct[cap] : pct;
+    if (controlled_pid == 0 || bump == touch_pct)
+        return;
+
+    char path[MAX_PATH_LENGTH];
+    touch_pct = bump;
+    for (int c = 0; c < cpu_topology.nr_clusters; c++) {
+        long floor = level_floor(c, cur_level);
+        if (floor > 0)
+            write2file(policy_node(&cpu_topology.cluster[c], "scaling_min_freq", path, sizeof(path)), false, false, "%ld", floor);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : perf_controller_level
+ * Inputs             : None
+ * Returns            : PerfLevel - current performance sub-profile
+ * Description        : Exposes current level for status output.
+ ***********************************************************************************/
+PerfLevel perf_controller_level(void) {
+    return cur_level;
+}
@@ -15,43 +15,246 @@
  */
 
 #include <nusantara.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+typedef struct {
+    size_t budget;    // current budget, shrinks with MemAvailable
+    size_t planned;   // bytes we intend to touch
+    size_t preloaded; // bytes actually touched
+    long paused_ms;   // time spent waiting for pressure to settle
+    long chunk_delay_us;
+    bool aborted;
+    bool psi_ok;
+    PsiMonitor psi;
+} PreloadCtx;
 
 /***********************************************************************************
- * Function Name : NusantaraPreload
- * Inputs        : const char* package - target application package name
- * Returns       : void
- * Description   : Dynamically preloads native libraries or split APK contents
+ * Function Name : is_preload_target
+ * Inputs        : const char* name - file name
+ * Returns       : bool - true if file is worth preloading
+ * Description   : Filters native libs, APKs and ART artifacts.
  ***********************************************************************************/
-void NusantaraPreload(const char* package) {
-    /*  EARLY VALIDATION  */
-    if (!package || package[0] == '\0') {
-        log_nusantara(LOG_WARN, "Package is null or empty");
-        return;
+static bool is_preload_target(const char* name) {
+    static const char* exts[] = {".so", ".apk", ".odex", ".vdex", ".art", ".dm"};
+    const char* dot = strrchr(name, '.');
+    if (!dot)
+        return false;
+
+    for (size_t i = 0; i < sizeof(exts) / sizeof(exts[0]); i++) {
+        if (strcmp(dot, exts[i]) == 0)
+            return true;
     }
 
-    /*  DYNAMIC RAM INFO  */
-    long mem_total_mb = 0;
-    long mem_avail_mb = 0;
-    FILE* meminfo = fopen("/proc/meminfo", "r");
-    if (meminfo) {
-        char line[256];
-        long v;
-        while (fgets(line, sizeof(line), meminfo)) {
-            if (sscanf(line, "MemTotal: %ld kB", &v) == 1)
-                mem_total_mb = v / 1024;
-            else if (sscanf(line, "MemAvailable: %ld kB", &v) == 1)
-                mem_avail_mb = v / 1024;
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name : preload_should_continue
+ * Inputs        : PreloadCtx* ctx - preload context
+ * Returns       : bool - false once the preload must stop
+ * Description   : Re-evaluates memory and I/O pressure between chunks.
+ *                 Pauses while PSI triggers keep firing, shrinks the budget to
+ *                 what MemAvailable still allows and slows down the read rate
+ *                 with I/O stall time. Aborts before we push the game or other
+ *                 apps into reclaim.
+ ***********************************************************************************/
+static bool preload_should_continue(PreloadCtx* ctx) {
+    // Game exited meanwhile, its pages are of no use anymore
+    if (task_cancelled()) {
+        log_nusantara(LOG_INFO, "NusantaraPreload | Cancelled");
+        ctx->aborted = true;
+        return false;
+    }
+
+    if (ctx->psi_ok) {
+        long paused = 0;
+        // A cancel ends the pause, the next chunk stops on it
+        while (!task_cancelled() && psi_monitor_wait(&ctx->psi, paused ? PRELOAD_PAUSE_MS : 0) > 0) {
+            paused += PRELOAD_PAUSE_MS;
+            if (paused >= PRELOAD_MAX_PAUSE_MS) {
+                log_nusantara(LOG_WARN, "NusantaraPreload | Pressure did not settle after %ldms", paused);
+                ctx->paused_ms += paused;
+                ctx->aborted = true;
+                return false;
+            }
+        }
+        ctx->paused_ms += paused;
+
+        PsiStat mem, io;
+        if (psi_read(PSI_MEMORY, &mem) && mem.full_avg10 >= PRELOAD_ABORT_FULL_AVG10) {
+            log_nusantara(LOG_WARN, "NusantaraPreload | Memory full stall %.2f%%", mem.full_avg10);
+            ctx->aborted = true;
+            return false;
+        }
+
+        // 1% io stall costs 1ms per chunk, capped to keep preload alive
+        if (psi_read(PSI_IO, &io)) {
+            ctx->chunk_delay_us = (long)(io.some_avg10 * 1000.0f);
+            if (ctx->chunk_delay_us > PRELOAD_MAX_CHUNK_DELAY_US)
+                ctx->chunk_delay_us = PRELOAD_MAX_CHUNK_DELAY_US;
         }
-        fclose(meminfo);
     }
-    
-    if (mem_total_mb < 4000) {
-        log_nusantara(LOG_INFO,
-            "NusantaraPreload | RAM %ldMB < 4GB, skipping preload",
-            mem_total_mb);
-        return;
+
+    long mem_total_mb = 0, mem_avail_mb = 0;
+    if (get_meminfo(&mem_total_mb, &mem_avail_mb)) {
+        if (mem_avail_mb <= PRELOAD_RESERVE_MB) {
+            log_nusantara(LOG_WARN, "NusantaraPreload | MemAvailable %ldMB hit reserve", mem_avail_mb);
+            ctx->aborted = true;
+            return false;
+        }
+
+        size_t headroom = (size_t)(mem_avail_mb - PRELOAD_RESERVE_MB) << 20;
+        if (ctx->preloaded + headroom < ctx->budget)
+            ctx->budget = ctx->preloaded + headroom;
+    }
+
+    if (ctx->chunk_delay_us > 0)
+        usleep(ctx->chunk_delay_us);
+
+    return ctx->preloaded < ctx->budget;
+}
+
+/***********************************************************************************
+ * Function Name : preload_file
+ * Inputs        : PreloadCtx* ctx - preload context
+ *                 const char* path - file to preload
+ *                 size_t size - file size
+ * Returns       : size_t - bytes touched
+ * Description   : Maps the file and faults it into page cache chunk by chunk,
+ *                 checking pressure between every chunk.
+ ***********************************************************************************/
+static size_t preload_file(PreloadCtx* ctx, const char* path, size_t size) {
+    if (size == 0)
+        return 0;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return 0;
+
+    unsigned char* map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) [[clang::unlikely]]
+        return 0;
+
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t touched = 0;
+
+    for (size_t off = 0; off < size; off += PRELOAD_CHUNK_SIZE) {
+        if (!preload_should_continue(ctx))
+            break;
+
+        size_t len = size - off;
+        if (len > PRELOAD_CHUNK_SIZE)
+            len = PRELOAD_CHUNK_SIZE;
+        if (len > ctx->budget - ctx->preloaded)
+            len = ctx->budget - ctx->preloaded;
+
+        madvise(map + off, len, MADV_WILLNEED);
+
+        // Fault every page so it really lands in page cache
+        volatile unsigned char sink = 0;
+        for (size_t p = 0; p < len; p += page_size)
+            sink ^= map[off + p];
+        (void)sink;
+
+        touched += len;
+        ctx->preloaded += len;
+    }
+
+    munmap(map, size);
+    return touched;
+}
+
+/***********************************************************************************
+ * Function Name : preload_walk
+ * Inputs        : const char* dir - directory to scan
+ *                 PreloadCtx* ctx - preload context
+ *                 bool touch - false to only sum file sizes, true to preload
+ *                 int depth - recursion limit
+ * Returns       : size_t - bytes found (touch == false) or touched
+ * Description   : Walks the package directory and feeds every target file into
+ *                 preload_file().
+ ***********************************************************************************/
+static size_t preload_walk(const char* dir, PreloadCtx* ctx, const bool touch, const int depth) {
+    DIR* d = opendir(dir);
+    if (!d)
+        return 0;
+
+    size_t total = 0;
+    struct dirent* e;
+    char path[MAX_PATH_LENGTH * 2];
+
+    while ((e = readdir(d)) && !ctx->aborted) {
+        if (e->d_name[0] == '.')
+            continue;
+
+        snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+
+        struct stat st;
+        if (stat(path, &st) == -1)
+            continue;
+
+        if (S_ISDIR(st.st_mode)) {
+            if (depth > 0)
+                total += preload_walk(path, ctx, touch, depth - 1);
+            continue;
+        }
+
+        if (!S_ISREG(st.st_mode) || !is_preload_target(e->d_name))
+            continue;
+
+        if (!touch) {
+            total += st.st_size;
+            continue;
+        }
+
+        size_t touched = preload_file(ctx, path, st.st_size);
+        if (touched > 0)
+            log_nusantara(LOG_DEBUG, "Touched: %s (%zuKB)", path, touched >> 10);
+
+        total += touched;
+        if (ctx->preloaded >= ctx->budget)
+            break;
+    }
+
+    closedir(d);
+    return total;
+}
+
+/***********************************************************************************
+ * Function Name : preload_budget_mb
+ * Inputs        : long mem_total_mb - total RAM
+ *                 long mem_avail_mb - available RAM
+ * Returns       : long - initial preload budget in MB
+ * Description   : Picks starting budget by device class, lowered on narrow RAM.
+ ***********************************************************************************/
+static long preload_budget_mb(const long mem_total_mb, const long mem_avail_mb) {
+    long budget = 350;
+    if (mem_total_mb >= 12000)      budget = 900;
+    else if (mem_total_mb >= 8000)  budget = 700;
+    else if (mem_total_mb >= 6000)  budget = 500;
+    if (mem_avail_mb > 0) {
+        if (mem_avail_mb < 800)
+            budget = 300;
+        else if (mem_avail_mb < 1200)
+            budget = 350;
     }
 
+    return budget;
+}
+
+/***********************************************************************************
+ * Function Name : preload_legacy
+ * Inputs        : const char* package - target application package name
+ *                 const char* target - directory to preload
+ *                 long budget_mb - preload budget
+ *                 long mem_avail_mb - available RAM
+ * Returns       : void
+ * Description   : Fallback for kernels without PSI, hands the directory over to
+ *                 sys.npreloader with a budget fixed at start.
+ ***********************************************************************************/
+static void preload_legacy(const char* package, const char* target, const long budget_mb, const long mem_avail_mb) {
     /*  SMART TIMING 
      * Objective:
      * - give AMS time to resolve the package
@@ -66,88 +269,15 @@ void NusantaraPreload(const char* package) {
         usleep(250 * 1000);
     }
 
-    /*  DYNAMIC PRELOAD BUDGET  */
-    const char* budget = "350M";
-    if (mem_total_mb >= 12000)      budget = "900M";
-    else if (mem_total_mb >= 8000)  budget = "700M";
-    else if (mem_total_mb >= 6000)  budget = "500M";
-    if (mem_avail_mb > 0) {
-        if (mem_avail_mb < 800)
-            budget = "300M";
-        else if (mem_avail_mb < 1200)
-            budget = "350M";
-    }
-
-    log_nusantara(LOG_INFO,
-        "NusantaraPreload | Budget %s | Avail %ldMB",
-        budget, mem_avail_mb);
-
-    /*  GET APK PATH  */
-    char apk_path[256] = {0};
-    char cmd_apk[512];
-    snprintf(cmd_apk, sizeof(cmd_apk),
-             "cmd package path %s | head -n1 | cut -d: -f2",
-             package);
-
-    FILE* apk = popen(cmd_apk, "r");
-    if (!apk || !fgets(apk_path, sizeof(apk_path), apk)) {
-        log_nusantara(LOG_WARN,
-            "Failed to get APK path for %s", package);
-        if (apk) pclose(apk);
-        return;
-    }
-    pclose(apk);
-    apk_path[strcspn(apk_path, "\n")] = 0;
-
-    /*  EXTRACT APK DIR  */
-    char* last_slash = strrchr(apk_path, '/');
-    if (!last_slash) {
-        log_nusantara(LOG_WARN,
-            "Invalid APK path: %s", apk_path);
-        return;
-    }
-    *last_slash = '\0';
-
-    /*  ABI LIB DETECTION (ARM64 ONLY)  */
-    char lib_path[300] = {0};
-    bool lib_exists = false;
-    snprintf(lib_path, sizeof(lib_path),
-             "%s/lib/arm64", apk_path);
-
-    DIR* d = opendir(lib_path);
-    if (d) {
-        struct dirent* e;
-        while ((e = readdir(d))) {
-            if (strstr(e->d_name, ".so")) {
-                lib_exists = true;
-                break;
-            }
-        }
-        closedir(d);
-    }
-
-    /*  EXECUTE PRELOAD  */
-    FILE* fp = NULL;
     char line[1024];
     int total_pages = 0;
     char last_size[32] = {0};
     char preload_cmd[512];
-    if (lib_exists) {
-        snprintf(preload_cmd, sizeof(preload_cmd),
-                 "sys.npreloader -v -t -m %s \"%s\"",
-                 budget, lib_path);
-        log_nusantara(LOG_INFO,
-            "Preloading native libs: %s", lib_path);
-    } else {
-        snprintf(preload_cmd, sizeof(preload_cmd),
-                 "sys.npreloader -v -t -m %s \"%s\"",
-                 budget, apk_path);
-
-        log_nusantara(LOG_INFO,
-            "Preloading split APKs: %s", apk_path);
-    }
+    snprintf(preload_cmd, sizeof(preload_cmd),
+             "sys.npreloader -v -t -m %ldM \"%s\"",
+             budget_mb, target);
 
-    fp = popen(preload_cmd, "r");
+    FILE* fp = popen(preload_cmd, "r");
     if (!fp) {
         log_nusantara(LOG_WARN,
             "Failed to execute preloader for %s", package);
@@ -187,3 +317,135 @@ void NusantaraPreload(const char* package) {
         "Application %s preloaded: %d pages (~%s)",
         package, total_pages, last_size);
 }
+
+/***********************************************************************************
+ * Function Name : preload_directory
+ * Inputs        : const char* label - name used in the final log
+ *                 const char* target - directory to preload
+ *                 long budget_mb - preload budget
+ *                 int settle_ms - delay between planning and touching
+ * Returns       : size_t - bytes preloaded
+ * Description   : Plans the walk against the budget, then touches files in
+ *                 chunks while PSI and MemAvailable allow it.
+ ***********************************************************************************/
+size_t preload_directory(const char* label, const char* target, const long budget_mb, const int settle_ms) {
+    PreloadCtx ctx = {0};
+    ctx.budget = (size_t)budget_mb << 20;
+    ctx.psi_ok = psi_monitor_open(&ctx.psi, PRELOAD_PSI_STALL_US, PRELOAD_PSI_WINDOW_US);
+
+    size_t found = preload_walk(target, &ctx, false, PRELOAD_MAX_DEPTH);
+    ctx.planned = found < ctx.budget ? found : ctx.budget;
+    ctx.budget = ctx.planned;
+
+    // Give AMS time to resolve the package, pressure checks handle the rest
+    if (settle_ms > 0)
+        usleep(settle_ms * 1000);
+    preload_walk(target, &ctx, true, PRELOAD_MAX_DEPTH);
+
+    if (ctx.psi_ok)
+        psi_monitor_close(&ctx.psi);
+
+    /*  FINAL LOG  */
+    size_t remaining = ctx.planned - ctx.preloaded;
+    log_nusantara(LOG_INFO,
+        "Application %s preloaded: %zuMB, throttled: %zuMB, aborted: %zuMB (paused %ldms)",
+        label, ctx.preloaded >> 20, ctx.aborted ? 0 : remaining >> 20,
+        ctx.aborted ? remaining >> 20 : 0, ctx.paused_ms);
+
+    return ctx.preloaded;
+}
+
+/***********************************************************************************
+ * Function Name : NusantaraPreload
+ * Inputs        : const char* package - target application package name
+ *                 long budget_mb_override - budget from game config, 0 picks by RAM
+ * Returns       : size_t - bytes preloaded, 0 when skipped or unknown
+ * Description   : Dynamically preloads native libraries or split APK contents
+ * Note          : Budget and read rate follow PSI memory/io pressure while
+ *                 preloading, falls back to sys.npreloader without PSI.
+ ***********************************************************************************/
+size_t NusantaraPreload(const char* package, const long budget_mb_override) {
+    /*  EARLY VALIDATION  */
+    if (!package || package[0] == '\0') {
+        log_nusantara(LOG_WARN, "Package is null or empty");
+        return 0;
+    }
+
+    /*  DYNAMIC RAM INFO  */
+    long mem_total_mb = 0;
+    long mem_avail_mb = 0;
+    get_meminfo(&mem_total_mb, &mem_avail_mb);
+    
+    // Below 4GB only when app freezer made room and PSI can stop us in time
+    if (mem_total_mb < 4000 && !(app_freezer_active() && psi_available())) {
+        log_nusantara(LOG_INFO,
+            "NusantaraPreload | RAM %ldMB < 4GB, skipping preload",
+            mem_total_mb);
+        return 0;
+    }
+
+    /*  DYNAMIC PRELOAD BUDGET  */
+    long budget_mb = budget_mb_override > 0 ? budget_mb_override : preload_budget_mb(mem_total_mb, mem_avail_mb);
+
+    log_nusantara(LOG_INFO,
+        "NusantaraPreload | Budget %ldM | Avail %ldMB",
+        budget_mb, mem_avail_mb);
+
+    /*  GET APK PATH  */
+    char apk_path[256] = {0};
+    if (!package_index_find(package, apk_path, sizeof(apk_path))) {
+        // Installed after startup, ask package manager
+        char cmd_apk[512];
+        snprintf(cmd_apk, sizeof(cmd_apk),
+                 "cmd package path %s | head -n1 | cut -d: -f2",
+                 package);
+
+        FILE* apk = popen(cmd_apk, "r");
+        if (!apk || !fgets(apk_path, sizeof(apk_path), apk)) {
+            log_nusantara(LOG_WARN,
+                "Failed to get APK path for %s", package);
+            if (apk) pclose(apk);
+            return 0;
+        }
+        pclose(apk);
+        apk_path[strcspn(apk_path, "\n")] = 0;
+    }
+
+    /*  EXTRACT APK DIR  */
+    char* last_slash = strrchr(apk_path, '/');
+    if (!last_slash) {
+        log_nusantara(LOG_WARN,
+            "Invalid APK path: %s", apk_path);
+        return 0;
+    }
+    *last_slash = '\0';
+
+    /*  ABI LIB DETECTION (ARM64 ONLY)  */
+    char lib_path[300] = {0};
+    bool lib_exists = false;
+    snprintf(lib_path, sizeof(lib_path),
+             "%s/lib/arm64", apk_path);
+
+    DIR* d = opendir(lib_path);
+    if (d) {
+        struct dirent* e;
+        while ((e = readdir(d))) {
+            if (strstr(e->d_name, ".so")) {
+                lib_exists = true;
+                break;
+            }
+        }
+        closedir(d);
+    }
+
+    const char* target = lib_exists ? lib_path : apk_path;
+    log_nusantara(LOG_INFO, lib_exists ? "Preloading native libs: %s" : "Preloading split APKs: %s", target);
+
+    if (!psi_available()) {
+        preload_legacy(package, target, budget_mb, mem_avail_mb);
+        return 0;
+    }
+
+    /*  EXECUTE PRELOAD  */
+    return preload_directory(package, target, budget_mb, PRELOAD_SETTLE_MS);
+}
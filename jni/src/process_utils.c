@@ -121,19 +121,3 @@ int uidof(pid_t pid) {
     return uid;
 }
 
-/***********************************************************************************
- * Function Name      : set_priority
- * Inputs             : pid (pid_t) - PID to be boosted
- * Returns            : None
- * Description        : Sets the maximum CPU nice priority and I/O priority of a
- *                      given process.
- ***********************************************************************************/
-void set_priority(const pid_t pid) {
-    log_nusantara(LOG_DEBUG, "Applying priority settings for PID %d", pid);
-
-    if (setpriority(PRIO_PROCESS, pid, -20) == -1)
-        log_nusantara(LOG_ERROR, "Unable to set nice priority for %d", pid);
-
-    if (syscall(SYS_ioprio_set, 1, pid, (1 << 13) | 0) == -1)
-        log_nusantara(LOG_ERROR, "Unable to set IO priority for %d", pid);
-}
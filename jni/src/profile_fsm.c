@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+const char* profile_mode_name[PROFILE_MODE_MAX] = {"perfcommon", "performance", "normal", "powersave"};
+
+/***********************************************************************************
+ * Function Name      : profile_wanted
+ * Inputs             : in (const ProfileInputs *) - sampled inputs of a round
+ * Returns            : ProfileMode - profile the inputs ask for
+ * Description        : Pure decision, shared by the daemon, trace recorder and
+ *                      host simulator. Inputs the daemon did not sample because
+ *                      an earlier one already decided are left false.
+ ***********************************************************************************/
+ProfileMode profile_wanted(const ProfileInputs* in) {
+    if (in->game && in->screen_on && !in->game_bg)
+        return PERFORMANCE_PROFILE;
+
+    return in->low_power ? POWERSAVE_PROFILE : NORMAL_PROFILE;
+}
+
+/***********************************************************************************
+ * Function Name      : profile_fsm_init
+ * Inputs             : fsm (ProfileFsm *) - state machine
+ *                      config (const FsmConfig *) - dwell times, copied
+ *                      initial (ProfileMode) - starting profile
+ * Returns            : None
+ ***********************************************************************************/
+void profile_fsm_init(ProfileFsm* fsm, const FsmConfig* config, const ProfileMode initial) {
+    memset(fsm, 0, sizeof(*fsm));
+    fsm->config = *config;
+    fsm->current = initial;
+    fsm->pending = initial;
+}
+
+/***********************************************************************************
+ * Function Name      : profile_fsm_dwell
+ * Inputs             : fsm (const ProfileFsm *) - state machine
+ *                      to (ProfileMode) - wanted profile
+ *                      game_alive (bool) - true if the boosted game still runs
+ * Returns            : long - milliseconds the wanted profile must hold first
+ * Description        : Leaving performance while the game process lives is
+ *                      brief backgrounding or a screen-off blip, it waits at
+ *                      least the grace period.
+ ***********************************************************************************/
+static long profile_fsm_dwell(const ProfileFsm* fsm, const ProfileMode to, const bool game_alive) {
+    long dwell = fsm->config.dwell_ms[fsm->current][to];
+
+    if (fsm->current == PERFORMANCE_PROFILE && game_alive && fsm->config.grace_ms > dwell)
+        dwell = fsm->config.grace_ms;
+
+    return dwell;
+}
+
+/***********************************************************************************
+ * Function Name      : profile_fsm_step
+ * Inputs             : fsm (ProfileFsm *) - state machine
+ *                      wanted (ProfileMode) - profile the inputs ask for
+ *                      game_alive (bool) - true if the boosted game still runs
+ *                      now_ms (long) - monotonic time in milliseconds
+ * Returns            : ProfileMode - profile to be in after this step
+ * Description        : Pure transition function, no I/O. A transition commits
+ *                      once the wanted profile held for its dwell time. A
+ *                      pending transition dropped before that, or replaced by
+ *                      another one, counts as suppressed.
+ ***********************************************************************************/
+ProfileMode profile_fsm_step(ProfileFsm* fsm, const ProfileMode wanted, const bool game_alive, const long now_ms) {
+    if (wanted == fsm->current) {
+        if (fsm->pending != fsm->current) {
+            fsm->suppressed[fsm->current][fsm->pending]++;
+            fsm->nr_suppressed++;
+        }
+        fsm->pending = fsm->current;
+        return fsm->current;
+    }
+
+    if (wanted != fsm->pending) {
+        if (fsm->pending != fsm->current) {
+            fsm->suppressed[fsm->current][fsm->pending]++;
+            fsm->nr_suppressed++;
+        }
+        fsm->pending = wanted;
+        fsm->pending_since_ms = now_ms;
+    }
+
+    if (now_ms - fsm->pending_since_ms < profile_fsm_dwell(fsm, wanted, game_alive))
+        return fsm->current;
+
+    fsm->current = wanted;
+    fsm->last_change_ms = now_ms;
+    fsm->nr_transitions++;
+    return fsm->current;
+}
+
+/***********************************************************************************
+ * Function Name      : profile_fsm_force
+ * Inputs             : fsm (ProfileFsm *) - state machine
+ *                      mode (ProfileMode) - profile actually in effect
+ * Returns            : None
+ * Description        : Resyncs the machine when a committed transition could
+ *                      not be applied, e.g. the game PID vanished.
+ ***********************************************************************************/
+void profile_fsm_force(ProfileFsm* fsm, const ProfileMode mode) {
+    fsm->current = mode;
+    fsm->pending = mode;
+}
+
+/***********************************************************************************
+ * Function Name      : profile_fsm_load
+ * Inputs             : config (FsmConfig *) - receives dwell times
+ *                      filename (const char *) - transition dwell file
+ * Returns            : None
+ * Description        : Fills defaults, then applies "<from> <to> <ms>" and
+ *                      "grace <ms>" lines from the file when it exists.
+ ***********************************************************************************/
+void profile_fsm_load(FsmConfig* config, const char* filename) {
+    memset(config, 0, sizeof(*config));
+    config->grace_ms = FSM_DEFAULT_GRACE_MS;
+
+    FILE* fp = fopen(filename, "r");
+    if (!fp)
+        return;
+
+    char line[MAX_LINE];
+    while (fgets(line, sizeof(line), fp)) {
+        char from[32], to[32];
+        long ms;
+
+        if (line[0] == '#')
+            continue;
+
+        if (sscanf(line, "grace %ld", &ms) == 1) {
+            config->grace_ms = ms < 0 ? 0 : ms;
+            continue;
+        }
+
+        if (sscanf(line, "%31s %31s %ld", from, to, &ms) != 3)
+            continue;
+
+        int f = -1, t = -1;
+        for (int i = 0; i < PROFILE_MODE_MAX; i++) {
+            if (strcmp(from, profile_mode_name[i]) == 0)
+                f = i;
+            if (strcmp(to, profile_mode_name[i]) == 0)
+                t = i;
+        }
+
+        if (f < 0 || t < 0) {
+            log_nusantara(LOG_WARN, "Ignoring transition dwell line: %s", trim_newline(line));
+            continue;
+        }
+
+        config->dwell_ms[f][t] = ms < 0 ? 0 : ms;
+    }
+
+    fclose(fp);
+}
+
+/***********************************************************************************
+ * Function Name      : profile_fsm_status
+ * Inputs             : fsm (const ProfileFsm *) - state machine
+ *                      fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes transition counters of daemon status.
+ ***********************************************************************************/
+void profile_fsm_status(const ProfileFsm* fsm, FILE* fp) {
+    fprintf(fp, "fsm_pending=%s\n", profile_mode_name[fsm->pending]);
+    fprintf(fp, "fsm_transitions=%d\n", fsm->nr_transitions);
+    fprintf(fp, "fsm_suppressed=%d\n", fsm->nr_suppressed);
+
+    for (int f = 0; f < PROFILE_MODE_MAX; f++) {
+        for (int t = 0; t < PROFILE_MODE_MAX; t++) {
+            if (fsm->suppressed[f][t] > 0)
+                fprintf(fp, "fsm_suppressed_%s_%s=%d\n", profile_mode_name[f], profile_mode_name[t], fsm->suppressed[f][t]);
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <poll.h>
+
+static const char* psi_path[PSI_MAX] = {PSI_MEMORY_PATH, PSI_IO_PATH};
+
+/***********************************************************************************
+ * Function Name      : psi_available
+ * Inputs             : None
+ * Returns            : bool - true if kernel exposes Pressure Stall Information
+ * Description        : Checks whether /proc/pressure is present (CONFIG_PSI=y and
+ *                      not disabled through psi=0 on cmdline).
+ ***********************************************************************************/
+bool psi_available(void) {
+    return access(PSI_MEMORY_PATH, R_OK) == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : psi_read
+ * Inputs             : resource (PsiResource) - pressure file to parse
+ *                      stat (PsiStat *) - output, avg10 of "some" and "full" lines
+ * Returns            : bool - true on success
+ * Description        : Reads current stall averages of a PSI resource.
+ * Note               : "full" line is not reported for cpu on old kernels,
+ *                      full_avg10 stays 0 in that case.
+ ***********************************************************************************/
+bool psi_read(const PsiResource resource, PsiStat* stat) {
+    FILE* fp = fopen(psi_path[resource], "r");
+    if (!fp) [[clang::unlikely]]
+        return false;
+
+    char line[MAX_OUTPUT_LENGTH];
+    stat->some_avg10 = 0.0f;
+    stat->full_avg10 = 0.0f;
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, "some", 4) == 0)
+            sscanf(line, "some avg10=%f", &stat->some_avg10);
+        else if (strncmp(line, "full", 4) == 0)
+            sscanf(line, "full avg10=%f", &stat->full_avg10);
+    }
+
+    fclose(fp);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : psi_monitor_open
+ * Inputs             : mon (PsiMonitor *) - monitor to initialize
+ *                      stall_us (long) - stall threshold that fires the trigger
+ *                      window_us (long) - tracking window, 500ms up to 10s
+ * Returns            : bool - true if at least one trigger was registered
+ * Description        : Registers "some" PSI triggers on memory and io pressure.
+ *                      Kernel wakes up poll() with POLLPRI once tasks stall
+ *                      longer than stall_us within window_us.
+ ***********************************************************************************/
+bool psi_monitor_open(PsiMonitor* mon, const long stall_us, const long window_us) {
+    char trigger[64];
+    int len = snprintf(trigger, sizeof(trigger), "some %ld %ld", stall_us, window_us);
+    bool registered = false;
+
+    for (int i = 0; i < PSI_MAX; i++) {
+        mon->fd[i] = open(psi_path[i], O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (mon->fd[i] == -1) [[clang::unlikely]]
+            continue;
+
+        // Trigger string must include its NUL terminator
+        if (write(mon->fd[i], trigger, len + 1) < 0) [[clang::unlikely]] {
+            log_nusantara(LOG_WARN, "Unable to register PSI trigger on %s", psi_path[i]);
+            close(mon->fd[i]);
+            mon->fd[i] = -1;
+            continue;
+        }
+
+        registered = true;
+    }
+
+    return registered;
+}
+
+/***********************************************************************************
+ * Function Name      : psi_monitor_wait
+ * Inputs             : mon (PsiMonitor *) - opened monitor
+ *                      timeout_ms (int) - poll timeout, 0 for non-blocking check
+ * Returns            : int - bitmask of fired resources (1 << PsiResource),
+ *                            0 on timeout, -1 on error
+ * Description        : Waits for any registered PSI trigger to fire.
+ ***********************************************************************************/
+int psi_monitor_wait(PsiMonitor* mon, const int timeout_ms) {
+    struct pollfd fds[PSI_MAX];
+    int nfds = 0;
+    PsiResource owner[PSI_MAX];
+
+    for (int i = 0; i < PSI_MAX; i++) {
+        if (mon->fd[i] == -1)
+            continue;
+
+        fds[nfds].fd = mon->fd[i];
+        fds[nfds].events = POLLPRI;
+        fds[nfds].revents = 0;
+        owner[nfds++] = (PsiResource)i;
+    }
+
+    if (nfds == 0)
+        return 0;
+
+    int ret = poll(fds, nfds, timeout_ms);
+    if (ret <= 0)
+        return ret;
+
+    int fired = 0;
+    for (int i = 0; i < nfds; i++) {
+        if (fds[i].revents & POLLERR) [[clang::unlikely]]
+            return -1;
+
+        if (fds[i].revents & POLLPRI)
+            fired |= 1 << owner[i];
+    }
+
+    return fired;
+}
+
+/***********************************************************************************
+ * Function Name      : psi_monitor_close
+ * Inputs             : mon (PsiMonitor *) - monitor to close
+ * Returns            : None
+ * Description        : Closes trigger fds, which also unregisters the triggers.
+ ***********************************************************************************/
+void psi_monitor_close(PsiMonitor* mon) {
+    for (int i = 0; i < PSI_MAX; i++) {
+        if (mon->fd[i] != -1)
+            close(mon->fd[i]);
+        mon->fd[i] = -1;
+    }
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+#define HISTORY_OFFSET(slot) ((off_t)sizeof(HistoryHeader) + (off_t)(slot) * (off_t)sizeof(HistoryRecord))
+
+typedef struct {
+    const HistoryRecord* record;
+    uint32_t key;
+} HistoryRef;
+
+/***********************************************************************************
+ * Function Name      : history_valid
+ * Inputs             : header (const HistoryHeader *) - header read from disk
+ * Returns            : bool - true if the ring matches this build
+ ***********************************************************************************/
+static bool history_valid(const HistoryHeader* header) {
+    return memcmp(header->magic, HISTORY_MAGIC, sizeof(header->magic)) == 0 && header->version == HISTORY_VERSION &&
+           header->record_size == sizeof(HistoryRecord) && header->capacity == HISTORY_CAPACITY &&
+           header->head < HISTORY_CAPACITY && header->count <= HISTORY_CAPACITY;
+}
+
+/***********************************************************************************
+ * Function Name      : history_append
+ * Inputs             : filename (const char *) - history ring file
+ *                      record (const HistoryRecord *) - finished session
+ * Returns            : bool - true if the record was stored
+ * Description        : The file is sized for HISTORY_CAPACITY records when it
+ *                      is created, later sessions overwrite the oldest slot.
+ *                      A ring of another layout is started over.
+ ***********************************************************************************/
+bool history_append(const char* filename, const HistoryRecord* record) {
+    int fd = open(filename, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        log_nusantara(LOG_WARN, "Unable to open session history %s", filename);
+        return false;
+    }
+
+    HistoryHeader header;
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || !history_valid(&header)) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, HISTORY_MAGIC, sizeof(header.magic));
+        header.version = HISTORY_VERSION;
+        header.record_size = sizeof(HistoryRecord);
+        header.capacity = HISTORY_CAPACITY;
+        if (ftruncate(fd, HISTORY_OFFSET(HISTORY_CAPACITY)) == -1) {
+            close(fd);
+            return false;
+        }
+    }
+
+    bool ok = pwrite(fd, record, sizeof(*record), HISTORY_OFFSET(header.head)) == (ssize_t)sizeof(*record);
+    if (ok) {
+        header.head = (header.head + 1) % HISTORY_CAPACITY;
+        if (header.count < HISTORY_CAPACITY)
+            header.count++;
+        ok = pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+    }
+
+    close(fd);
+    return ok;
+}
+
+/***********************************************************************************
+ * Function Name      : compare_ref
+ * Inputs             : a, b (const void *) - HistoryRef
+ * Returns            : int - qsort order, by package then key
+ ***********************************************************************************/
+static int compare_ref(const void* a, const void* b) {
+    const HistoryRef* x = a;
+    const HistoryRef* y = b;
+    int order = strncmp(x->record->package, y->record->package, HISTORY_PACKAGE);
+    if (order != 0)
+        return order;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+/***********************************************************************************
+ * Function Name      : group_median
+ * Inputs             : refs (HistoryRef *) - records of one package
+ *                      n (int) - number of records
+ *                      key (int) - 0 for time to boost, 1 for preload time
+ * Returns            : uint32_t - median of the key
+ ***********************************************************************************/
+static uint32_t group_median(HistoryRef* refs, const int n, const int key) {
+    for (int i = 0; i < n; i++)
+        refs[i].key = key == 0 ? refs[i].record->boost_ms : refs[i].record->preload_ms;
+    qsort(refs, (size_t)n, sizeof(*refs), compare_ref);
+    return n % 2 ? refs[n / 2].key : (refs[n / 2 - 1].key + refs[n / 2].key) / 2;
+}
+
+/***********************************************************************************
+ * Function Name      : history_query
+ * Inputs             : filename (const char *) - history ring file
+ *                      out (FILE *) - report output
+ *                      days (long) - window, 0 for everything kept
+ *                      package (const char *) - only this game, NULL for all
+ * Returns            : int - number of sessions aggregated, -1 on error
+ * Description        : Reads the whole ring in one go and groups sessions per
+ *                      game by sorting, medians come from the sorted groups.
+ ***********************************************************************************/
+int history_query(const char* filename, FILE* out, const long days, const char* package) {
+    static HistoryRecord records[HISTORY_CAPACITY];
+    static HistoryRef refs[HISTORY_CAPACITY];
+
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return -1;
+
+    HistoryHeader header;
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || !history_valid(&header)) {
+        close(fd);
+        return -1;
+    }
+
+    ssize_t len = pread(fd, records, sizeof(HistoryRecord) * header.count, HISTORY_OFFSET(0));
+    close(fd);
+    if (len != (ssize_t)(sizeof(HistoryRecord) * header.count))
+        return -1;
+
+    uint32_t since = days > 0 ? (uint32_t)(time(NULL) - days * 86400) : 0;
+    int n = 0;
+    for (uint32_t i = 0; i < header.count; i++) {
+        if (records[i].end < since || (package && strncmp(records[i].package, package, HISTORY_PACKAGE) != 0))
+            continue;
+        refs[n].record = &records[i];
+        refs[n++].key = 0;
+    }
+    qsort(refs, (size_t)n, sizeof(refs[0]), compare_ref);
+
+    fprintf(out, "%-40s %5s %8s %8s %8s %8s %6s %6s %6s %6s %6s  %s\n", "package", "runs", "play_min", "boost_ms", "load_ms",
+            "load_mb", "perf%", "cpu_c", "gpu_c", "skin_c", "steps", "cluster_mhz");
+
+    for (int start = 0, end; start < n; start = end) {
+        for (end = start + 1; end < n && strncmp(refs[end].record->package, refs[start].record->package, HISTORY_PACKAGE) == 0; end++)
+            ;
+
+        int runs = end - start;
+        unsigned long long play_s = 0, perf_s = 0, preload_kb = 0, steps = 0;
+        unsigned long long mhz[HISTORY_CLUSTERS] = {0};
+        int peak[THERMAL_CLASS_MAX] = {0};
+
+        for (int i = start; i < end; i++) {
+            const HistoryRecord* r = refs[i].record;
+            play_s += r->end - r->start;
+            perf_s += r->profile_s[PERFORMANCE_PROFILE];
+            preload_kb += r->preload_kb;
+            steps += r->thermal_steps;
+            for (int c = 0; c < HISTORY_CLUSTERS; c++)
+                mhz[c] += r->cluster_mhz[c];
+            for (int t = 0; t < THERMAL_CLASS_MAX; t++) {
+                if (r->peak_temp[t] > peak[t])
+                    peak[t] = r->peak_temp[t];
+            }
+        }
+
+        char name[HISTORY_PACKAGE + 1];
+        snprintf(name, sizeof(name), "%.*s", HISTORY_PACKAGE, refs[start].record->package);
+        uint32_t boost = group_median(&refs[start], runs, 0);
+        uint32_t load = group_median(&refs[start], runs, 1);
+
+        fprintf(out, "%-40s %5d %8llu %8u %8u %8llu %6llu %6d %6d %6d %6.1f ", name, runs, play_s / 60, boost, load,
+                preload_kb / 1024 / (unsigned long long)runs, play_s ? perf_s * 100 / play_s : 0, peak[THERMAL_CPU] / 10,
+                peak[THERMAL_GPU] / 10, peak[THERMAL_SKIN] / 10, (double)steps / runs);
+        for (int c = 0; c < HISTORY_CLUSTERS && mhz[c]; c++)
+            fprintf(out, "%s%llu", c ? "/" : " ", mhz[c] / (unsigned long long)runs);
+        fputc('\n', out);
+    }
+
+    return n;
+}
+
+/***********************************************************************************
+ * Function Name      : history_main
+ * Inputs             : argc (int) - argument count
+ *                      argv (char **) - [days] [package]
+ * Returns            : int - exit status
+ * Description        : nusantara_history entry of the multi-call binary, e.g.
+ *                      "nusantara_history 30" for the last 30 days per game.
+ ***********************************************************************************/
+int history_main(const int argc, char** argv) {
+    long days = argc > 1 ? atol(argv[1]) : HISTORY_DEFAULT_DAYS;
+    const char* package = argc > 2 ? argv[2] : NULL;
+
+    if (days < 0) {
+        fprintf(stderr, "Usage: nusantara_history [days, 0 for all] [package]\n");
+        return EXIT_FAILURE;
+    }
+
+    int n = history_query(SESSION_HISTORY, stdout, days, package);
+    if (n < 0) {
+        fprintf(stderr, "No session history at %s\n", SESSION_HISTORY);
+        return EXIT_FAILURE;
+    }
+
+    printf("%d sessions%s\n", n, days > 0 ? "" : " kept");
+    return EXIT_SUCCESS;
+}
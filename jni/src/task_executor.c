@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <pthread.h>
+
+typedef enum : char {
+    SLOT_FREE,
+    SLOT_QUEUED,
+    SLOT_RUNNING,
+    SLOT_DONE
+} SlotState;
+
+typedef struct {
+    Task task;
+    SlotState state;
+    bool cancelled;
+    unsigned int seq;
+    long queued_ms;
+} TaskSlot;
+
+typedef struct {
+    int done;
+    int cancelled;
+    int inline_runs;
+    long max_wait_ms;
+} LaneStats;
+
+static const char* task_priority_name[TASK_PRIORITY_MAX] = {"profile", "boost", "preload", "notify"};
+
+static TaskSlot slots[MAX_TASKS];
+static LaneStats lane_stats[TASK_PRIORITY_MAX];
+static bool lane_running[TASK_PRIORITY_MAX];
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t idle = PTHREAD_COND_INITIALIZER;
+static int nr_workers = 0;
+static unsigned int next_seq = 0;
+static _Thread_local TaskSlot* current = NULL;
+
+/***********************************************************************************
+ * Function Name      : monotonic_ms
+ * Inputs             : None
+ * Returns            : long - monotonic time in milliseconds
+ ***********************************************************************************/
+static long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/***********************************************************************************
+ * Function Name      : next_slot
+ * Inputs             : None
+ * Returns            : TaskSlot * - task to run next, NULL if none is runnable
+ * Description        : Highest priority first, oldest first within a lane.
+ *                      Lanes run one task at a time, so profile changes apply
+ *                      in the order they were decided. Caller holds the lock.
+ ***********************************************************************************/
+static TaskSlot* next_slot(void) {
+    TaskSlot* best = NULL;
+
+    for (int i = 0; i < MAX_TASKS; i++) {
+        TaskSlot* slot = &slots[i];
+        if (slot->state != SLOT_QUEUED || lane_running[slot->task.priority])
+            continue;
+        if (!best || slot->task.priority < best->task.priority ||
+            (slot->task.priority == best->task.priority && (int)(slot->seq - best->seq) < 0))
+            best = slot;
+    }
+
+    return best;
+}
+
+/***********************************************************************************
+ * Function Name      : run_slot
+ * Inputs             : task (Task *) - task to run
+ * Returns            : None
+ ***********************************************************************************/
+static void run_slot(Task* task) {
+    long started = monotonic_ms();
+    task->run(task);
+    task->elapsed_ms = monotonic_ms() - started;
+}
+
+/***********************************************************************************
+ * Function Name      : worker
+ * Inputs             : arg (void *) - unused
+ * Returns            : void * - never returns
+ ***********************************************************************************/
+static void* worker(void* arg) {
+    (void)arg;
+    pthread_setname_np(pthread_self(), "nusantara_exec");
+
+    pthread_mutex_lock(&lock);
+    while (true) {
+        TaskSlot* slot = next_slot();
+        if (!slot) {
+            pthread_cond_wait(&work, &lock);
+            continue;
+        }
+
+        TaskPriority lane = slot->task.priority;
+        long waited = monotonic_ms() - slot->queued_ms;
+        if (waited > lane_stats[lane].max_wait_ms)
+            lane_stats[lane].max_wait_ms = waited;
+        slot->state = SLOT_RUNNING;
+        lane_running[lane] = true;
+        pthread_mutex_unlock(&lock);
+
+        current = slot;
+        run_slot(&slot->task);
+        current = NULL;
+        arena_reset();
+
+        pthread_mutex_lock(&lock);
+        lane_running[lane] = false;
+        if (slot->cancelled)
+            lane_stats[lane].cancelled++;
+        else
+            lane_stats[lane].done++;
+        slot->state = slot->task.done && !slot->cancelled ? SLOT_DONE : SLOT_FREE;
+
+        // Lane is free again, tasks queued behind this one are runnable now
+        pthread_cond_broadcast(&work);
+        pthread_cond_broadcast(&idle);
+    }
+
+    return NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : executor_start
+ * Inputs             : None
+ * Returns            : int - number of worker threads
+ * Description        : Starts the fixed pool. Without workers every task runs
+ *                      inline at submit, as the daemon did before.
+ ***********************************************************************************/
+int executor_start(void) {
+    for (int i = 0; i < EXECUTOR_THREADS; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, worker, NULL) != 0) [[clang::unlikely]]
+            break;
+        pthread_detach(thread);
+        nr_workers++;
+    }
+
+    if (nr_workers == 0)
+        log_nusantara(LOG_WARN, "Unable to start task executor, running tasks inline");
+    return nr_workers;
+}
+
+/***********************************************************************************
+ * Function Name      : executor_submit
+ * Inputs             : task (const Task *) - task to run, copied
+ * Returns            : bool - true if queued, false if it ran inline
+ * Description        : A full queue makes the caller wait for a free slot
+ *                      rather than drop the task, profile changes must never
+ *                      get lost. Running it inline instead would overtake
+ *                      tasks queued in its lane.
+ ***********************************************************************************/
+bool executor_submit(const Task* task) {
+    pthread_mutex_lock(&lock);
+
+    TaskSlot* slot = NULL;
+    while (nr_workers > 0 && !slot) {
+        for (int i = 0; i < MAX_TASKS && !slot; i++) {
+            if (slots[i].state == SLOT_FREE)
+                slot = &slots[i];
+        }
+        if (!slot)
+            pthread_cond_wait(&idle, &lock);
+    }
+
+    if (!slot) {
+        lane_stats[task->priority].inline_runs++;
+        pthread_mutex_unlock(&lock);
+
+        Task copy = *task;
+        run_slot(&copy);
+        if (copy.done)
+            copy.done(&copy);
+        return false;
+    }
+
+    slot->task = *task;
+    slot->state = SLOT_QUEUED;
+    slot->cancelled = false;
+    slot->seq = next_seq++;
+    slot->queued_ms = monotonic_ms();
+
+    pthread_cond_signal(&work);
+    pthread_mutex_unlock(&lock);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : executor_cancel
+ * Inputs             : package (const char *) - game whose tasks to cancel
+ * Returns            : int - number of tasks cancelled
+ * Description        : Queued tasks are dropped, running ones are flagged and
+ *                      stop at their next task_cancelled() check.
+ ***********************************************************************************/
+int executor_cancel(const char* package) {
+    int cancelled = 0;
+    pthread_mutex_lock(&lock);
+
+    for (int i = 0; i < MAX_TASKS; i++) {
+        TaskSlot* slot = &slots[i];
+        if (slot->state == SLOT_FREE || strcmp(slot->task.package, package) != 0)
+            continue;
+
+        if (slot->state == SLOT_QUEUED) {
+            lane_stats[slot->task.priority].cancelled++;
+            slot->state = SLOT_FREE;
+            cancelled++;
+        } else if (slot->state == SLOT_RUNNING && !slot->cancelled) {
+            slot->cancelled = true;
+            cancelled++;
+        } else if (slot->state == SLOT_DONE) {
+            slot->state = SLOT_FREE;
+        }
+    }
+
+    pthread_cond_broadcast(&idle);
+    pthread_mutex_unlock(&lock);
+    return cancelled;
+}
+
+/***********************************************************************************
+ * Function Name      : task_cancelled
+ * Inputs             : None
+ * Returns            : bool - true if the task running on this thread was
+ *                             cancelled, always false outside the executor
+ ***********************************************************************************/
+bool task_cancelled(void) {
+    if (!current)
+        return false;
+
+    pthread_mutex_lock(&lock);
+    bool cancelled = current->cancelled;
+    pthread_mutex_unlock(&lock);
+    return cancelled;
+}
+
+/***********************************************************************************
+ * Function Name      : lane_busy
+ * Inputs             : lane (TaskPriority) - lane
+ * Returns            : bool - true if a task is queued or running in the lane
+ * Description        : Caller holds the lock.
+ ***********************************************************************************/
+static bool lane_busy(const TaskPriority lane) {
+    if (lane_running[lane])
+        return true;
+
+    for (int i = 0; i < MAX_TASKS; i++) {
+        if (slots[i].state == SLOT_QUEUED && slots[i].task.priority == lane)
+            return true;
+    }
+
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : executor_busy
+ * Inputs             : lane (TaskPriority) - lane
+ * Returns            : bool - true if a task is queued or running in the lane
+ ***********************************************************************************/
+bool executor_busy(const TaskPriority lane) {
+    pthread_mutex_lock(&lock);
+    bool busy = lane_busy(lane);
+    pthread_mutex_unlock(&lock);
+    return busy;
+}
+
+/***********************************************************************************
+ * Function Name      : executor_wait
+ * Inputs             : lane (TaskPriority) - lane
+ * Returns            : None
+ * Description        : Blocks until every task of the lane has finished. Only
+ *                      for short lanes, state they touch is about to change.
+ ***********************************************************************************/
+void executor_wait(const TaskPriority lane) {
+    pthread_mutex_lock(&lock);
+    while (lane_busy(lane))
+        pthread_cond_wait(&idle, &lock);
+    pthread_mutex_unlock(&lock);
+}
+
+/***********************************************************************************
+ * Function Name      : executor_reap
+ * Inputs             : None
+ * Returns            : int - number of completions handled
+ * Description        : Runs done callbacks of finished tasks on the calling
+ *                      thread, the main loop owns session state they update.
+ ***********************************************************************************/
+int executor_reap(void) {
+    int reaped = 0;
+
+    for (int i = 0; i < MAX_TASKS; i++) {
+        pthread_mutex_lock(&lock);
+        if (slots[i].state != SLOT_DONE) {
+            pthread_mutex_unlock(&lock);
+            continue;
+        }
+        Task task = slots[i].task;
+        slots[i].state = SLOT_FREE;
+        pthread_mutex_unlock(&lock);
+
+        task.done(&task);
+        reaped++;
+    }
+
+    return reaped;
+}
+
+/***********************************************************************************
+ * Function Name      : executor_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes executor section of daemon status, one line per
+ *                      lane with its queue and the longest wait for a worker.
+ ***********************************************************************************/
+void executor_status(FILE* fp) {
+    pthread_mutex_lock(&lock);
+
+    fprintf(fp, "executor_threads=%d\n", nr_workers);
+    for (int lane = 0; lane < TASK_PRIORITY_MAX; lane++) {
+        int queued = 0;
+        for (int i = 0; i < MAX_TASKS; i++) {
+            if (slots[i].state == SLOT_QUEUED && (int)slots[i].task.priority == lane)
+                queued++;
+        }
+
+        const LaneStats* stats = &lane_stats[lane];
+        fprintf(fp, "executor_%s=queued=%d running=%d done=%d cancelled=%d inline=%d max_wait_ms=%ld\n",
+                task_priority_name[lane], queued, lane_running[lane], stats->done, stats->cancelled, stats->inline_runs,
+                stats->max_wait_ms);
+    }
+
+    pthread_mutex_unlock(&lock);
+}
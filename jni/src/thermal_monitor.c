@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+#define MAX_THERMAL_ZONES 32
+#define SOC_ANY 0
+
+typedef struct {
+    int id;
+    ThermalClass cls;
+} ThermalZone;
+
+typedef struct {
+    int temp;      // millidegree
+    int limit;     // millidegree, lowest passive trip point
+    float slope;   // degree per second, smoothed
+    bool valid;
+} ThermalReading;
+
+// Matched as substring of thermal_zone*/type, first match wins
+static const struct {
+    int soc;
+    const char* pattern;
+    ThermalClass cls;
+} zone_patterns[] = {
+    {1, "mtktscpu", THERMAL_CPU},
+    {1, "mtktsAP", THERMAL_SKIN},
+    {1, "mtkts_gpu", THERMAL_GPU},
+    {2, "cpuss", THERMAL_CPU},
+    {2, "cpu-1-", THERMAL_CPU},
+    {2, "gpuss", THERMAL_GPU},
+    {2, "xo-therm", THERMAL_SKIN},
+    {2, "quiet_therm", THERMAL_SKIN},
+    {3, "BIG", THERMAL_CPU},
+    {3, "G3D", THERMAL_GPU},
+    {5, "BIG", THERMAL_CPU},
+    {5, "G3D", THERMAL_GPU},
+    {5, "neutral_therm", THERMAL_SKIN},
+    {SOC_ANY, "skin", THERMAL_SKIN},
+    {SOC_ANY, "shell", THERMAL_SKIN},
+    {SOC_ANY, "board", THERMAL_SKIN},
+    {SOC_ANY, "gpu", THERMAL_GPU},
+    {SOC_ANY, "cpu", THERMAL_CPU},
+    {SOC_ANY, "soc", THERMAL_CPU},
+};
+
+// Used when zones expose no passive trip point, millidegree
+static const int default_limit[THERMAL_CLASS_MAX] = {90000, 90000, 45000};
+
+// Performance level allowed per thermal state
+static const PerfLevel state_level_cap[THERMAL_STATE_MAX] = {PERF_LEVEL_MAX, PERF_LEVEL_HEAVY, PERF_LEVEL_MEDIUM, PERF_LEVEL_LIGHT};
+
+static const char* thermal_class_name[THERMAL_CLASS_MAX] = {"cpu", "gpu", "skin"};
+static const char* thermal_state_name[THERMAL_STATE_MAX] = {"normal", "warm", "hot", "critical"};
+
+static ThermalZone zones[MAX_THERMAL_ZONES];
+static int nr_zones = 0;
+static ThermalReading reading[THERMAL_CLASS_MAX];
+static ThermalState cur_state = THERMAL_NORMAL;
+static PerfLevel level_cap = PERF_LEVEL_MAX;
+static int cap_hold = 0;
+static int headroom_s = -1;
+static struct timespec last_sample = {0};
+
+/***********************************************************************************
+ * Function Name      : zone_limit
+ * Inputs             : id (int) - thermal zone number
+ * Returns            : int - lowest passive trip point in millidegree, 0 if none
+ * Description        : Passive trips are where the kernel starts throttling.
+ ***********************************************************************************/
+static int zone_limit(const int id) {
+    int limit = 0;
+
+    for (int trip = 0; trip < 16; trip++) {
+        char path[MAX_PATH_LENGTH];
+        char type[32] = {0};
+        snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/trip_point_%d_type", id, trip);
+        FILE* fp = fopen(path, "r");
+        if (!fp)
+            break;
+
+        bool ok = fgets(type, sizeof(type), fp) != NULL;
+        fclose(fp);
+        if (!ok || strncmp(type, "passive", 7) != 0)
+            continue;
+
+        snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/trip_point_%d_temp", id, trip);
+        long temp = read_long(path, 0);
+
+        // Ignore placeholder trips some vendors leave at 0 or absurd values
+        if (temp >= 40000 && temp <= 125000 && (limit == 0 || temp < limit))
+            limit = (int)temp;
+    }
+
+    return limit;
+}
+
+/***********************************************************************************
+ * Function Name      : thermal_init
+ * Inputs             : None
+ * Returns            : int - number of classified thermal zones
+ * Description        : Classifies thermal zones into CPU, GPU and skin sensors
+ *                      using per-SoC patterns from soc_recognition first, then
+ *                      generic ones.
+ ***********************************************************************************/
+int thermal_init(void) {
+    int soc = (int)read_long(SOC_RECOGNITION, 0);
+    nr_zones = 0;
+
+    DIR* dir = opendir("/sys/class/thermal");
+    if (!dir) [[clang::unlikely]]
+        return 0;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) && nr_zones < MAX_THERMAL_ZONES) {
+        int id;
+        if (sscanf(entry->d_name, "thermal_zone%d", &id) != 1)
+            continue;
+
+        char path[MAX_PATH_LENGTH];
+        char type[64] = {0};
+        snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/type", id);
+        FILE* fp = fopen(path, "r");
+        if (!fp)
+            continue;
+
+        bool ok = fgets(type, sizeof(type), fp) != NULL;
+        fclose(fp);
+        if (!ok)
+            continue;
+        trim_newline(type);
+
+        for (size_t i = 0; i < sizeof(zone_patterns) / sizeof(zone_patterns[0]); i++) {
+            if (zone_patterns[i].soc != SOC_ANY && zone_patterns[i].soc != soc)
+                continue;
+            if (!strstr(type, zone_patterns[i].pattern))
+                continue;
+
+            ThermalClass cls = zone_patterns[i].cls;
+            zones[nr_zones].id = id;
+            zones[nr_zones].cls = cls;
+            nr_zones++;
+
+            int limit = zone_limit(id);
+            if (limit > 0 && (reading[cls].limit == 0 || limit < reading[cls].limit))
+                reading[cls].limit = limit;
+
+            log_nusantara(LOG_DEBUG, "Thermal zone %d (%s) classified as %s", id, type, thermal_class_name[cls]);
+            break;
+        }
+    }
+
+    closedir(dir);
+
+    for (int c = 0; c < THERMAL_CLASS_MAX; c++) {
+        if (reading[c].limit == 0)
+            reading[c].limit = default_limit[c];
+    }
+
+    log_nusantara(LOG_INFO, "Thermal monitor tracking %d zones, limits cpu %d gpu %d skin %d", nr_zones,
+                  reading[THERMAL_CPU].limit / 1000, reading[THERMAL_GPU].limit / 1000, reading[THERMAL_SKIN].limit / 1000);
+    return nr_zones;
+}
+
+/***********************************************************************************
+ * Function Name      : thermal_tick
+ * Inputs             : None
+ * Returns            : ThermalState - current thermal state
+ * Description        : Samples the hottest zone of each class, smooths the slope
+ *                      and predicts seconds left before the nearest throttle
+ *                      point. The performance level cap follows the state one
+ *                      step at a time so floors walk down before the kernel
+ *                      cuts frequency hard.
+ ***********************************************************************************/
+ThermalState thermal_tick(void) {
+    if (nr_zones == 0)
+        return THERMAL_NORMAL;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    float dt = (now.tv_sec - last_sample.tv_sec) + (now.tv_nsec - last_sample.tv_nsec) / 1e9f;
+    bool first = last_sample.tv_sec == 0;
+    last_sample = now;
+
+    int hottest[THERMAL_CLASS_MAX] = {0};
+    for (int i = 0; i < nr_zones; i++) {
+        char path[MAX_PATH_LENGTH];
+        snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/temp", zones[i].id);
+        long temp = read_long(path, 0);
+
+        // Some vendors report plain degree
+        if (temp > 0 && temp < 1000)
+            temp *= 1000;
+        if (temp > hottest[zones[i].cls])
+            hottest[zones[i].cls] = (int)temp;
+    }
+
+    ThermalState state = THERMAL_NORMAL;
+    headroom_s = -1;
+
+    for (int c = 0; c < THERMAL_CLASS_MAX; c++) {
+        ThermalReading* r = &reading[c];
+        if (hottest[c] == 0)
+            continue;
+
+        if (r->valid && !first && dt > 0.05f) {
+            float slope = (hottest[c] - r->temp) / 1000.0f / dt;
+            r->slope = r->slope * 0.7f + slope * 0.3f;
+        }
+        r->temp = hottest[c];
+        r->valid = true;
+
+        float margin = (r->limit - r->temp) / 1000.0f;
+        int headroom = margin <= 0 ? 0 : (r->slope > 0.05f ? (int)(margin / r->slope) : -1);
+        if (headroom >= 0 && (headroom_s < 0 || headroom < headroom_s))
+            headroom_s = headroom;
+
+        ThermalState cls_state = THERMAL_NORMAL;
+        if (margin <= 0)
+            cls_state = THERMAL_CRITICAL;
+        else if (margin <= THERMAL_HOT_MARGIN || (headroom >= 0 && headroom < THERMAL_HOT_HEADROOM_S))
+            cls_state = THERMAL_HOT;
+        else if (margin <= THERMAL_WARM_MARGIN || (headroom >= 0 && headroom < THERMAL_WARM_HEADROOM_S))
+            cls_state = THERMAL_WARM;
+
+        if (cls_state > state)
+            state = cls_state;
+    }
+
+    if (state != cur_state) {
+        log_nusantara(LOG_INFO, "Thermal state %s -> %s (cpu %d.%dC, headroom %ds)", thermal_state_name[cur_state],
+                      thermal_state_name[state], reading[THERMAL_CPU].temp / 1000, reading[THERMAL_CPU].temp % 1000 / 100,
+                      headroom_s);
+        cur_state = state;
+    }
+
+    // Walk the cap one level per THERMAL_STEP_TICKS, down and back up
+    PerfLevel wanted = state_level_cap[state];
+    if (wanted != level_cap && ++cap_hold >= THERMAL_STEP_TICKS) {
+        level_cap += wanted < level_cap ? -1 : 1;
+        cap_hold = 0;
+    } else if (wanted == level_cap) {
+        cap_hold = 0;
+    }
+
+    return state;
+}
+
+/***********************************************************************************
+ * Function Name      : thermal_level_cap
+ * Inputs             : None
+ * Returns            : PerfLevel - highest performance level allowed right now
+ * Description        : Consumed by performance controller.
+ ***********************************************************************************/
+PerfLevel thermal_level_cap(void) {
+    return level_cap;
+}
+
+/***********************************************************************************
+ * Function Name      : thermal_temp
+ * Inputs             : cls (ThermalClass) - sensor class
+ * Returns            : int - last reading in millidegree, 0 if unknown
+ ***********************************************************************************/
+int thermal_temp(const ThermalClass cls) {
+    return reading[cls].valid ? reading[cls].temp : 0;
+}
+
+/***********************************************************************************
+ * Function Name      : thermal_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes thermal section of daemon status.
+ ***********************************************************************************/
+void thermal_status(FILE* fp) {
+    fprintf(fp, "thermal_state=%s\n", thermal_state_name[cur_state]);
+    fprintf(fp, "thermal_level_cap=%s\n", perf_level_name[level_cap]);
+    fprintf(fp, "thermal_headroom_s=%d\n", headroom_s);
+
+    for (int c = 0; c < THERMAL_CLASS_MAX; c++) {
+        if (!reading[c].valid)
+            continue;
+
+        fprintf(fp, "thermal_%s_temp=%d\n", thermal_class_name[c], reading[c].temp);
+        fprintf(fp, "thermal_%s_limit=%d\n", thermal_class_name[c], reading[c].limit);
+        fprintf(fp, "thermal_%s_slope=%.2f\n", thermal_class_name[c], reading[c].slope);
+    }
+}
@@ -0,0 +1,482 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/resource.h>
+
+#define SCHED_FLAG_KEEP_POLICY 0x08
+#define SCHED_FLAG_KEEP_PARAMS 0x10
+#define SCHED_FLAG_UTIL_CLAMP_MIN 0x20
+#define SCHED_FLAG_UTIL_CLAMP_MAX 0x40
+#define UCLAMP_FLAGS (SCHED_FLAG_KEEP_POLICY | SCHED_FLAG_KEEP_PARAMS | SCHED_FLAG_UTIL_CLAMP_MIN | SCHED_FLAG_UTIL_CLAMP_MAX)
+#define IOPRIO_WHO_PROCESS 1
+#define IOPRIO_BOOST (1 << 13)  // best effort class, highest level
+
+// Kernel ABI for sched_setattr(2), not exported by bionic
+struct sched_attr {
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+    uint32_t sched_util_min;
+    uint32_t sched_util_max;
+};
+
+typedef struct {
+    int nice;
+    int uclamp_min;
+    int uclamp_max;
+    ThreadAffinity affinity;
+    bool io_boost;
+} ThreadPolicy;
+
+// Indexed by ThreadClass
+static const ThreadPolicy thread_policy[THREAD_CLASS_MAX] = {
+    [THREAD_MAIN] = {-20, 512, 1024, AFFINITY_PERF, true},
+    [THREAD_RENDER] = {-20, 614, 1024, AFFINITY_PERF, false},
+    [THREAD_AUDIO] = {-16, 128, 1024, AFFINITY_ALL, false},
+    [THREAD_WORKER] = {-10, 0, 1024, AFFINITY_ALL, true},
+};
+
+const char* thread_class_name[THREAD_CLASS_MAX] = {"none", "main", "render", "audio", "worker"};
+
+// Matched as prefix of /proc/<pid>/task/<tid>/comm (15 chars max)
+static const struct {
+    const char* pattern;
+    ThreadClass cls;
+} thread_patterns[] = {
+    {"UnityMain", THREAD_MAIN},
+    {"GameThread", THREAD_MAIN},
+    {"MainThread-UE4", THREAD_MAIN},
+    {"UnityGfxDevice", THREAD_RENDER},
+    {"UnityGfx", THREAD_RENDER},
+    {"RenderThread", THREAD_RENDER},
+    {"GLThread", THREAD_RENDER},
+    {"RHIThread", THREAD_RENDER},
+    {"VkThread", THREAD_RENDER},
+    {"UnityChoreograp", THREAD_RENDER},
+    {"AudioTrack", THREAD_AUDIO},
+    {"AudioThread", THREAD_AUDIO},
+    {"FMOD", THREAD_AUDIO},
+    {"OboeAudio", THREAD_AUDIO},
+    {"Job.Worker", THREAD_WORKER},
+    {"Worker Thread", THREAD_WORKER},
+    {"TaskGraph", THREAD_WORKER},
+    {"UnityPreload", THREAD_WORKER},
+};
+
+// Everything the boost overwrote, written back by unboost_game_threads
+typedef struct {
+    pid_t tid;
+    ThreadClass cls;
+    int nice;
+    int uclamp_min;
+    int uclamp_max;
+    int ioprio;
+    bool has_affinity;
+    bool has_ioprio;
+    cpu_set_t affinity;
+} BoostedThread;
+
+static BoostedThread boosted[MAX_BOOSTED_THREADS];
+static int nr_boosted = 0;
+static BoostedThread secondary[MAX_SECONDARY_PROCS];
+static int nr_secondary = 0;
+static pid_t boosted_pid = 0;
+static bool uclamp_supported = true;
+static int uclamp_cap = 1024;
+static ThreadPattern game_patterns[MAX_GAME_THREAD_PATTERNS];
+static int nr_game_patterns = 0;
+
+// Boosting runs on the executor, the controller changes uclamp cap from the main loop
+static pthread_mutex_t boost_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/***********************************************************************************
+ * Function Name      : classify_thread
+ * Inputs             : comm (const char *) - thread name
+ *                      main_thread (bool) - true if tid equals the process pid
+ * Returns            : ThreadClass - matched class or THREAD_CLASS_NONE
+ * Description        : Matches thread name against per-game patterns first,
+ *                      then the built-in pattern table.
+ ***********************************************************************************/
+static ThreadClass classify_thread(const char* comm, const bool main_thread) {
+    for (int i = 0; i < nr_game_patterns; i++) {
+        if (strncmp(comm, game_patterns[i].pattern, strlen(game_patterns[i].pattern)) == 0)
+            return game_patterns[i].cls;
+    }
+
+    for (size_t i = 0; i < sizeof(thread_patterns) / sizeof(thread_patterns[0]); i++) {
+        if (strncmp(comm, thread_patterns[i].pattern, strlen(thread_patterns[i].pattern)) == 0)
+            return thread_patterns[i].cls;
+    }
+
+    // Main thread of Java games does not carry a recognizable name
+    return main_thread ? THREAD_MAIN : THREAD_CLASS_NONE;
+}
+
+/***********************************************************************************
+ * Function Name      : set_uclamp
+ * Inputs             : tid (pid_t) - thread id
+ *                      min (int) - uclamp.min, 0-1024
+ *                      max (int) - uclamp.max, 0-1024
+ * Returns            : bool - true on success
+ * Description        : Sets per-task utilization clamp via sched_setattr.
+ * Note               : Disabled after first failure, kernel lacks CONFIG_UCLAMP_TASK.
+ ***********************************************************************************/
+static bool set_uclamp(const pid_t tid, const int min, const int max) {
+    if (!uclamp_supported)
+        return false;
+
+    struct sched_attr attr = {0};
+    attr.size = sizeof(attr);
+    attr.sched_flags = UCLAMP_FLAGS;
+    attr.sched_util_min = min;
+    attr.sched_util_max = max;
+
+    if (syscall(SYS_sched_setattr, tid, &attr, 0) == -1) {
+        if (errno == EINVAL || errno == E2BIG || errno == EOPNOTSUPP || errno == ENOSYS) {
+            log_nusantara(LOG_WARN, "Kernel does not support uclamp, skipping per-thread clamps");
+            uclamp_supported = false;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : save_thread_state
+ * Inputs             : thread (BoostedThread *) - tid filled, receives originals
+ * Returns            : bool - false if the thread is gone
+ * Description        : Snapshots nice, uclamp, affinity and I/O priority before
+ *                      a boost. Missing uclamp falls back to the kernel default.
+ ***********************************************************************************/
+static bool save_thread_state(BoostedThread* thread) {
+    errno = 0;
+    thread->nice = getpriority(PRIO_PROCESS, thread->tid);
+    if (errno != 0)
+        return false;
+
+    struct sched_attr attr = {0};
+    thread->uclamp_min = 0;
+    thread->uclamp_max = 1024;
+    if (uclamp_supported && syscall(SYS_sched_getattr, thread->tid, &attr, sizeof(attr), 0) == 0 &&
+        attr.size >= sizeof(attr)) {
+        thread->uclamp_min = (int)attr.sched_util_min;
+        thread->uclamp_max = (int)attr.sched_util_max;
+    }
+
+    thread->has_affinity = sched_getaffinity(thread->tid, sizeof(cpu_set_t), &thread->affinity) == 0;
+
+    long ioprio = syscall(SYS_ioprio_get, IOPRIO_WHO_PROCESS, thread->tid);
+    thread->has_ioprio = ioprio >= 0;
+    thread->ioprio = (int)ioprio;
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : apply_thread_policy
+ * Inputs             : thread (BoostedThread *) - tid and class filled
+ * Returns            : bool - true if nice priority was applied
+ * Description        : Saves the thread's own values, then applies nice, uclamp,
+ *                      affinity and I/O priority of its class.
+ ***********************************************************************************/
+static bool apply_thread_policy(BoostedThread* thread) {
+    const ThreadPolicy* policy = &thread_policy[thread->cls];
+    pid_t tid = thread->tid;
+
+    if (!save_thread_state(thread))
+        return false;
+
+    // Nice value is per-thread on Linux, PRIO_PROCESS takes a tid here
+    if (setpriority(PRIO_PROCESS, tid, policy->nice) == -1)
+        return false;
+
+    set_uclamp(tid, policy->uclamp_min < uclamp_cap ? policy->uclamp_min : uclamp_cap, policy->uclamp_max);
+
+    const cpu_set_t* mask = affinity_mask(policy->affinity);
+    if (mask && sched_setaffinity(tid, sizeof(cpu_set_t), mask) == -1) {
+        log_nusantara(LOG_DEBUG, "Unable to set affinity for thread %d", tid);
+        thread->has_affinity = false;
+    } else if (!mask) {
+        thread->has_affinity = false;
+    }
+
+    if (!policy->io_boost || syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, IOPRIO_BOOST) == -1)
+        thread->has_ioprio = false;
+
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : restore_thread_state
+ * Inputs             : thread (const BoostedThread *) - boosted thread
+ * Returns            : None
+ * Description        : Writes back what save_thread_state found. Kernels that
+ *                      report an unset I/O priority but refuse it back get the
+ *                      "none" class, which follows nice again.
+ ***********************************************************************************/
+static void restore_thread_state(const BoostedThread* thread) {
+    pid_t tid = thread->tid;
+
+    setpriority(PRIO_PROCESS, tid, thread->nice);
+    set_uclamp(tid, thread->uclamp_min, thread->uclamp_max);
+    if (thread->has_affinity)
+        sched_setaffinity(tid, sizeof(cpu_set_t), &thread->affinity);
+    if (thread->has_ioprio && syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, thread->ioprio) == -1)
+        syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, 0);
+}
+
+/***********************************************************************************
+ * Function Name      : prune_threads
+ * Inputs             : pid (pid_t) - game PID
+ * Returns            : None
+ * Description        : Drops exited threads, so thread churn does not fill the
+ *                      table and stop later threads from being boosted.
+ *                      Caller holds boost_lock.
+ ***********************************************************************************/
+static void prune_threads(const pid_t pid) {
+    char path[MAX_PATH_LENGTH];
+
+    for (int i = 0; i < nr_boosted;) {
+        snprintf(path, sizeof(path), "/proc/%d/task/%d", pid, boosted[i].tid);
+        if (access(path, F_OK) == 0)
+            i++;
+        else
+            boosted[i] = boosted[--nr_boosted];
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : scan_threads
+ * Inputs             : pid (pid_t) - game PID
+ * Returns            : int - number of newly boosted threads
+ * Description        : Caller holds boost_lock.
+ ***********************************************************************************/
+static int scan_threads(const pid_t pid) {
+    if (pid != boosted_pid) {
+        nr_boosted = 0;
+        boosted_pid = pid;
+    }
+    prune_threads(pid);
+
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "/proc/%d/task", pid);
+    DIR* task_dir = opendir(path);
+    if (!task_dir) [[clang::unlikely]]
+        return 0;
+
+    int new_boosted = 0;
+    struct dirent* entry;
+
+    while ((entry = readdir(task_dir)) && nr_boosted < MAX_BOOSTED_THREADS) {
+        if (!isdigit((unsigned char)entry->d_name[0]))
+            continue;
+
+        pid_t tid = (pid_t)atoi(entry->d_name);
+        bool known = false;
+        for (int i = 0; i < nr_boosted; i++) {
+            if (boosted[i].tid == tid) {
+                known = true;
+                break;
+            }
+        }
+
+        if (known)
+            continue;
+
+        // Threads may rename themselves after creation, unmatched ones are rechecked later
+        char comm[32] = {0};
+        snprintf(path, sizeof(path), "/proc/%d/task/%d/comm", pid, tid);
+        FILE* fp = fopen(path, "r");
+        if (!fp)
+            continue;
+
+        bool ok = fgets(comm, sizeof(comm), fp) != NULL;
+        fclose(fp);
+        if (!ok)
+            continue;
+
+        trim_newline(comm);
+        ThreadClass cls = classify_thread(comm, tid == pid);
+        if (cls == THREAD_CLASS_NONE)
+            continue;
+
+        BoostedThread* thread = &boosted[nr_boosted];
+        thread->tid = tid;
+        thread->cls = cls;
+        if (!apply_thread_policy(thread))
+            continue;
+
+        nr_boosted++;
+        new_boosted++;
+        log_nusantara(LOG_INFO, "Boosted thread %s (%d) as %s", comm, tid, thread_class_name[cls]);
+    }
+
+    closedir(task_dir);
+
+    if (new_boosted > 0) {
+        int per_class[THREAD_CLASS_MAX] = {0};
+        for (int i = 0; i < nr_boosted; i++)
+            per_class[boosted[i].cls]++;
+
+        log_nusantara(LOG_INFO, "PID %d boosted threads: main=%d render=%d audio=%d worker=%d", pid, per_class[THREAD_MAIN],
+                      per_class[THREAD_RENDER], per_class[THREAD_AUDIO], per_class[THREAD_WORKER]);
+    }
+
+    return new_boosted;
+}
+
+/***********************************************************************************
+ * Function Name      : boost_game_threads
+ * Inputs             : pid (pid_t) - game PID
+ * Returns            : int - number of newly boosted threads
+ * Description        : Scans /proc/<pid>/task/<tid>/comm and boosts every thread that
+ *                      matches the pattern table. Already boosted threads are
+ *                      skipped, so this is cheap enough to call on every loop
+ *                      to catch threads created later.
+ ***********************************************************************************/
+int boost_game_threads(const pid_t pid) {
+    if (pid <= 0)
+        return 0;
+
+    pthread_mutex_lock(&boost_lock);
+    int new_boosted = scan_threads(pid);
+    pthread_mutex_unlock(&boost_lock);
+    return new_boosted;
+}
+
+/***********************************************************************************
+ * Function Name      : boost_secondary_process
+ * Inputs             : pid (pid_t) - PID of a secondary game process
+ * Returns            : bool - true if the process is boosted
+ * Description        : Gives the main thread of a helper process top nice and
+ *                      I/O priority, after saving its own values. Already
+ *                      boosted processes are skipped, exited ones dropped.
+ ***********************************************************************************/
+bool boost_secondary_process(const pid_t pid) {
+    if (pid <= 0)
+        return false;
+
+    pthread_mutex_lock(&boost_lock);
+    for (int i = 0; i < nr_secondary;) {
+        if (secondary[i].tid == pid) {
+            pthread_mutex_unlock(&boost_lock);
+            return true;
+        }
+
+        if (kill(secondary[i].tid, 0) == 0)
+            i++;
+        else
+            secondary[i] = secondary[--nr_secondary];
+    }
+
+    if (nr_secondary >= MAX_SECONDARY_PROCS) {
+        pthread_mutex_unlock(&boost_lock);
+        return false;
+    }
+
+    BoostedThread* proc = &secondary[nr_secondary];
+    proc->tid = pid;
+    proc->cls = THREAD_MAIN;
+    bool ok = save_thread_state(proc);
+    if (ok) {
+        // Only nice and I/O priority change, affinity stays as the process set it
+        proc->has_affinity = false;
+        ok = setpriority(PRIO_PROCESS, pid, thread_policy[THREAD_MAIN].nice) == 0;
+        if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, pid, IOPRIO_BOOST) == -1)
+            proc->has_ioprio = false;
+        if (ok || proc->has_ioprio)
+            nr_secondary++;
+    }
+    pthread_mutex_unlock(&boost_lock);
+
+    if (!ok)
+        log_nusantara(LOG_ERROR, "Unable to set priority for %d", pid);
+    return ok;
+}
+
+/***********************************************************************************
+ * Function Name      : unboost_game_threads
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Puts back the nice, uclamp, affinity and I/O priority each
+ *                      boosted thread had before, when leaving performance
+ *                      profile while the game is still alive. Secondary
+ *                      processes get their own nice and I/O priority back.
+ ***********************************************************************************/
+void unboost_game_threads(void) {
+    pthread_mutex_lock(&boost_lock);
+    if (boosted_pid != 0 && kill(boosted_pid, 0) == 0) {
+        for (int i = 0; i < nr_boosted; i++)
+            restore_thread_state(&boosted[i]);
+
+        log_nusantara(LOG_DEBUG, "Reverted %d boosted threads of PID %d", nr_boosted, boosted_pid);
+    }
+
+    for (int i = 0; i < nr_secondary; i++) {
+        if (kill(secondary[i].tid, 0) == 0)
+            restore_thread_state(&secondary[i]);
+    }
+
+    nr_boosted = 0;
+    nr_secondary = 0;
+    boosted_pid = 0;
+    pthread_mutex_unlock(&boost_lock);
+}
+
+/***********************************************************************************
+ * Function Name      : set_boost_uclamp_cap
+ * Inputs             : cap (int) - highest uclamp.min boosted threads may get
+ * Returns            : None
+ * Description        : Lowers (or restores) uclamp.min of boosted threads, used
+ *                      by performance controller levels. Applies to threads
+ *                      boosted later as well.
+ ***********************************************************************************/
+void set_boost_uclamp_cap(const int cap) {
+    pthread_mutex_lock(&boost_lock);
+    if (cap != uclamp_cap) {
+        uclamp_cap = cap;
+        for (int i = 0; i < nr_boosted; i++) {
+            const ThreadPolicy* policy = &thread_policy[boosted[i].cls];
+            set_uclamp(boosted[i].tid, policy->uclamp_min < cap ? policy->uclamp_min : cap, policy->uclamp_max);
+        }
+    }
+    pthread_mutex_unlock(&boost_lock);
+}
+
+/***********************************************************************************
+ * Function Name      : set_boost_game_patterns
+ * Inputs             : patterns (const ThreadPattern *) - per-game thread patterns
+ *                      count (int) - number of patterns
+ * Returns            : None
+ * Description        : Sets thread patterns from game config, checked before the
+ *                      built-in table. Pass 0 to clear them.
+ ***********************************************************************************/
+void set_boost_game_patterns(const ThreadPattern* patterns, const int count) {
+    pthread_mutex_lock(&boost_lock);
+    nr_game_patterns = count > MAX_GAME_THREAD_PATTERNS ? MAX_GAME_THREAD_PATTERNS : count;
+    if (nr_game_patterns > 0)
+        memcpy(game_patterns, patterns, nr_game_patterns * sizeof(ThreadPattern));
+    pthread_mutex_unlock(&boost_lock);
+}
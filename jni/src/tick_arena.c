@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+// Per thread, the main loop resets its own each tick and workers after each task
+static _Thread_local alignas(max_align_t) char arena[TICK_ARENA_SIZE];
+static _Thread_local size_t arena_used = 0;
+static _Thread_local size_t arena_peak = 0;
+static _Thread_local unsigned long arena_failed = 0;
+
+/***********************************************************************************
+ * Function Name      : arena_alloc
+ * Inputs             : size (size_t) - bytes wanted
+ * Returns            : void * - memory valid until arena_reset(), NULL when
+ *                               the tick used up the arena
+ ***********************************************************************************/
+static void* arena_alloc(const size_t size) {
+    size_t start = (arena_used + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+    if (start + size > sizeof(arena)) [[clang::unlikely]] {
+        // Logging here would not help, status shows the count
+        arena_failed++;
+        return NULL;
+    }
+
+    arena_used = start + size;
+    if (arena_used > arena_peak)
+        arena_peak = arena_used;
+    return arena + start;
+}
+
+/***********************************************************************************
+ * Function Name      : arena_strndup
+ * Inputs             : string (const char *) - source
+ *                      len (size_t) - maximum bytes to copy
+ * Returns            : char * - NUL terminated copy in the arena, or NULL
+ ***********************************************************************************/
+char* arena_strndup(const char* string, const size_t len) {
+    size_t n = strnlen(string, len);
+    char* copy = arena_alloc(n + 1);
+    if (!copy) [[clang::unlikely]]
+        return NULL;
+
+    memcpy(copy, string, n);
+    copy[n] = '\0';
+    return copy;
+}
+
+/***********************************************************************************
+ * Function Name      : arena_reset
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Ends the tick, every arena pointer is invalid after this.
+ ***********************************************************************************/
+void arena_reset(void) {
+    arena_used = 0;
+}
+
+/***********************************************************************************
+ * Function Name      : arena_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Reports the arena of the calling thread, the main loop.
+ ***********************************************************************************/
+void arena_status(FILE* fp) {
+    fprintf(fp, "arena_peak=%zu/%d\n", arena_peak, TICK_ARENA_SIZE);
+    fprintf(fp, "arena_failed=%lu\n", arena_failed);
+}
@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+
+#define BITS_PER_LONG (sizeof(long) * 8)
+#define NBITS(n) (((n) + BITS_PER_LONG - 1) / BITS_PER_LONG)
+#define TEST_BIT(bit, array) ((array[(bit) / BITS_PER_LONG] >> ((bit) % BITS_PER_LONG)) & 1)
+
+static int fd = -1;
+static char device_name[64] = {0};
+static bool monotonic_events = false;
+
+// Current evdev frame, decided on its SYN_REPORT
+static bool frame_down = false;
+static bool frame_contact = false;
+static bool dropping = false;
+
+static bool bumped = false;
+static long bump_start_ms = 0;
+static long bump_end_ms = 0;
+static long bump_len_ms = 0;
+static long last_end_ms = 0;
+static int nr_contacts = 0;
+static int nr_bumps = 0;
+static int nr_suppressed = 0;
+static int nr_stale = 0;
+static long long boosted_ms = 0;
+
+/***********************************************************************************
+ * Function Name      : monotonic_ms
+ * Inputs             : None
+ * Returns            : long - monotonic time in milliseconds
+ ***********************************************************************************/
+static long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/***********************************************************************************
+ * Function Name      : is_touchscreen
+ * Inputs             : dev (int) - opened evdev node
+ *                      direct (bool *) - set if the device is bound to a display
+ * Returns            : bool - true if the device reports multitouch positions
+ * Description        : Touchpads report the same axes, INPUT_PROP_DIRECT is
+ *                      what tells a touchscreen apart.
+ ***********************************************************************************/
+static bool is_touchscreen(const int dev, bool* direct) {
+    unsigned long abs_bits[NBITS(ABS_CNT)] = {0};
+    unsigned long prop_bits[NBITS(INPUT_PROP_CNT)] = {0};
+
+    if (ioctl(dev, EVIOCGBIT(EV_ABS, sizeof(abs_bits)), abs_bits) < 0)
+        return false;
+    if (!TEST_BIT(ABS_MT_POSITION_X, abs_bits) || !TEST_BIT(ABS_MT_POSITION_Y, abs_bits))
+        return false;
+
+    *direct = ioctl(dev, EVIOCGPROP(sizeof(prop_bits)), prop_bits) >= 0 && TEST_BIT(INPUT_PROP_DIRECT, prop_bits);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : open_touchscreen
+ * Inputs             : None
+ * Returns            : int - opened touchscreen, -1 if none
+ * Description        : Picks the first display bound multitouch device, any
+ *                      multitouch device otherwise. The device is never
+ *                      grabbed, InputFlinger keeps getting every event.
+ ***********************************************************************************/
+static int open_touchscreen(void) {
+    DIR* dir = opendir(INPUT_DEV_ROOT);
+    if (!dir)
+        return -1;
+
+    int found = -1;
+    bool found_direct = false;
+    struct dirent* entry;
+    char path[MAX_PATH_LENGTH];
+
+    while ((entry = readdir(dir)) && !found_direct) {
+        if (strncmp(entry->d_name, "event", 5) != 0)
+            continue;
+
+        snprintf(path, sizeof(path), INPUT_DEV_ROOT "/%s", entry->d_name);
+        int dev = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (dev == -1)
+            continue;
+
+        bool direct = false;
+        if (!is_touchscreen(dev, &direct) || (found != -1 && !direct)) {
+            close(dev);
+            continue;
+        }
+
+        if (found != -1)
+            close(found);
+        found = dev;
+        found_direct = direct;
+    }
+
+    closedir(dir);
+    return found;
+}
+
+/***********************************************************************************
+ * Function Name      : bump_start
+ * Inputs             : now (long) - monotonic time in milliseconds
+ * Returns            : None
+ * Description        : New contact. Floors are only written when a bump starts
+ *                      and ends, a bump ended less than TOUCH_COOLDOWN_MS ago
+ *                      is not restarted, the governor has not ramped down yet.
+ ***********************************************************************************/
+static void bump_start(const long now) {
+    if (bumped || !is_enabled(TOUCH_BOOST))
+        return;
+
+    if (last_end_ms && now - last_end_ms < TOUCH_COOLDOWN_MS) {
+        nr_suppressed++;
+        return;
+    }
+
+    long pct = read_long(TOUCH_BOOST_FLOOR, TOUCH_DEFAULT_FLOOR_PCT);
+    bump_len_ms = read_long(TOUCH_BOOST_MS, TOUCH_DEFAULT_BOOST_MS);
+    if (pct <= 0 || bump_len_ms <= 0)
+        return;
+    if (pct > 100)
+        pct = 100;
+    if (bump_len_ms > TOUCH_MAX_HOLD_MS)
+        bump_len_ms = TOUCH_MAX_HOLD_MS;
+
+    perf_controller_touch((int)pct);
+    gpu_controller_touch((int)pct);
+    bumped = true;
+    bump_start_ms = now;
+    bump_end_ms = now + bump_len_ms;
+    nr_bumps++;
+}
+
+/***********************************************************************************
+ * Function Name      : bump_extend
+ * Inputs             : now (long) - monotonic time in milliseconds
+ * Returns            : None
+ * Description        : Contacts keep a running bump alive, for no longer than
+ *                      TOUCH_MAX_HOLD_MS. A thumb resting on a virtual stick
+ *                      would hold floors up for the whole match otherwise.
+ ***********************************************************************************/
+static void bump_extend(const long now) {
+    if (!bumped)
+        return;
+
+    long end = now + bump_len_ms;
+    if (end > bump_start_ms + TOUCH_MAX_HOLD_MS)
+        end = bump_start_ms + TOUCH_MAX_HOLD_MS;
+    if (end > bump_end_ms)
+        bump_end_ms = end;
+}
+
+/***********************************************************************************
+ * Function Name      : bump_end
+ * Inputs             : now (long) - monotonic time in milliseconds
+ * Returns            : None
+ ***********************************************************************************/
+static void bump_end(const long now) {
+    if (!bumped)
+        return;
+
+    perf_controller_touch(0);
+    gpu_controller_touch(0);
+    boosted_ms += now - bump_start_ms;
+    last_end_ms = now;
+    bumped = false;
+}
+
+/***********************************************************************************
+ * Function Name      : frame_stale
+ * Inputs             : ev (const struct input_event *) - SYN_REPORT of the frame
+ *                      now (long) - monotonic time in milliseconds
+ * Returns            : bool - true if the frame queued up while nobody read
+ * Description        : Events pile up in the evdev buffer outside performance
+ *                      profile. Only a real device has monotonic timestamps,
+ *                      a recorded stream is replayed as if it were live.
+ ***********************************************************************************/
+static bool frame_stale(const struct input_event* ev, const long now) {
+    if (!monotonic_events)
+        return false;
+
+    long at = (long)ev->input_event_sec * 1000 + (long)ev->input_event_usec / 1000;
+    return now - at > TOUCH_STALE_MS;
+}
+
+/***********************************************************************************
+ * Function Name      : handle_event
+ * Inputs             : ev (const struct input_event *) - event
+ *                      now (long) - monotonic time in milliseconds
+ * Returns            : int - 1 if the event ended a frame with a new contact
+ * Description        : A new contact is a tracking ID being assigned (protocol
+ *                      B) or BTN_TOUCH going down, any multitouch axis counts
+ *                      as contact. SYN_DROPPED discards up to the next report.
+ ***********************************************************************************/
+static int handle_event(const struct input_event* ev, const long now) {
+    if (ev->type == EV_ABS && ev->code >= ABS_MT_SLOT && ev->code <= ABS_MT_TOOL_Y) {
+        frame_contact = true;
+        if (ev->code == ABS_MT_TRACKING_ID && ev->value >= 0)
+            frame_down = true;
+        return 0;
+    }
+
+    if (ev->type == EV_KEY && ev->code == BTN_TOUCH && ev->value == 1) {
+        frame_down = true;
+        return 0;
+    }
+
+    if (ev->type != EV_SYN)
+        return 0;
+
+    if (ev->code == SYN_DROPPED) {
+        dropping = true;
+        return 0;
+    }
+    if (ev->code != SYN_REPORT)
+        return 0;
+
+    bool down = frame_down, contact = frame_contact;
+    frame_down = frame_contact = false;
+    if (dropping) {
+        dropping = false;
+        return 0;
+    }
+    if (!down && !contact)
+        return 0;
+    if (frame_stale(ev, now)) {
+        nr_stale++;
+        return 0;
+    }
+
+    if (down) {
+        nr_contacts++;
+        bump_start(now);
+    }
+    bump_extend(now);
+    return down;
+}
+
+/***********************************************************************************
+ * Function Name      : read_events
+ * Inputs             : now (long) - monotonic time in milliseconds
+ * Returns            : int - number of new contacts
+ * Description        : Drains everything queued. A stand-in stream that ran
+ *                      out, or a device that went away, is closed.
+ ***********************************************************************************/
+static int read_events(const long now) {
+    struct input_event ev[64];
+    int contacts = 0;
+    ssize_t len;
+
+    while ((len = read(fd, ev, sizeof(ev))) > 0) {
+        for (size_t i = 0; i < (size_t)len / sizeof(ev[0]); i++)
+            contacts += handle_event(&ev[i], now);
+    }
+
+    if (len == 0 || (errno != EAGAIN && errno != EINTR)) {
+        log_nusantara(LOG_DEBUG, "Touch input %s closed", device_name);
+        close(fd);
+        fd = -1;
+    }
+
+    return contacts;
+}
+
+/***********************************************************************************
+ * Function Name      : touch_init
+ * Inputs             : stand_in (const char *) - recorded evdev stream to read
+ *                                                instead of the touchscreen,
+ *                                                NULL or empty for the device
+ * Returns            : bool - true if touch input is available
+ * Description        : The stand-in is raw struct input_event records, as
+ *                      read from the device node, or a FIFO fed by a player.
+ *                      Device timestamps are switched to CLOCK_MONOTONIC so
+ *                      stale events can be told apart.
+ ***********************************************************************************/
+bool touch_init(const char* stand_in) {
+    if (fd != -1)
+        close(fd);
+
+    bumped = dropping = frame_down = frame_contact = false;
+    last_end_ms = 0;
+    monotonic_events = false;
+
+    if (stand_in && stand_in[0]) {
+        const char* name = strrchr(stand_in, '/');
+        fd = open(stand_in, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        snprintf(device_name, sizeof(device_name), "%s", name ? name + 1 : stand_in);
+    } else {
+        fd = open_touchscreen();
+        if (fd != -1 && ioctl(fd, EVIOCGNAME(sizeof(device_name)), device_name) < 0)
+            snprintf(device_name, sizeof(device_name), "touchscreen");
+
+        int clock = CLOCK_MONOTONIC;
+        monotonic_events = fd != -1 && ioctl(fd, EVIOCSCLOCKID, &clock) == 0;
+    }
+
+    if (fd == -1) {
+        device_name[0] = '\0';
+        log_nusantara(LOG_INFO, "No touchscreen found, touch boost disabled");
+        return false;
+    }
+
+    log_nusantara(LOG_INFO, "Touch boost reading %s", device_name);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : touch_wait
+ * Inputs             : timeout_ms (int) - how long to wait
+ * Returns            : int - number of new contacts seen
+ * Description        : Replaces the sleep between performance ticks. Touches
+ *                      are handled as they arrive and a bump ends on time
+ *                      inside the wait, the control tick is far too coarse
+ *                      for either.
+ ***********************************************************************************/
+int touch_wait(const int timeout_ms) {
+    long deadline = monotonic_ms() + timeout_ms;
+    int contacts = 0;
+
+    for (long now; (now = monotonic_ms()) < deadline;) {
+        if (bumped && now >= bump_end_ms) {
+            bump_end(now);
+            continue;
+        }
+
+        long wake = bumped && bump_end_ms < deadline ? bump_end_ms : deadline;
+        if (fd == -1) {
+            usleep((useconds_t)(wake - now) * 1000);
+            continue;
+        }
+
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        int ret = poll(&pfd, 1, (int)(wake - now));
+        if (ret < 0 && errno != EINTR) {
+            usleep((useconds_t)(wake - now) * 1000);
+            continue;
+        }
+        if (ret > 0)
+            contacts += read_events(monotonic_ms());
+    }
+
+    return contacts;
+}
+
+/***********************************************************************************
+ * Function Name      : touch_release
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Ends a running bump when the game leaves performance
+ *                      profile, controllers are about to put floors back.
+ ***********************************************************************************/
+void touch_release(void) {
+    bump_end(monotonic_ms());
+}
+
+/***********************************************************************************
+ * Function Name      : touch_status
+ * Inputs             : fp (FILE *) - status output
+ * Returns            : None
+ * Description        : Writes touch section of daemon status. Suppressed
+ *                      contacts fell in the cooldown after a bump.
+ ***********************************************************************************/
+void touch_status(FILE* fp) {
+    fprintf(fp, "touch_device=%s\n", device_name);
+    fprintf(fp, "touch_boost=%s\n", bumped ? "on" : "off");
+    fprintf(fp, "touch_contacts=%d stale=%d\n", nr_contacts, nr_stale);
+    fprintf(fp, "touch_bumps=%d suppressed=%d boosted_ms=%lld\n", nr_bumps, nr_suppressed, boosted_ms);
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+static FILE* trace_fp = NULL;
+static long trace_start_ms = -1;
+static size_t trace_bytes = 0;
+static char packages[TRACE_MAX_PACKAGES][MAX_PACKAGE];
+static int nr_packages = 0;
+
+/***********************************************************************************
+ * Function Name      : trace_open
+ * Inputs             : filename (const char *) - trace file, truncated
+ * Returns            : bool - true if recording started
+ * Description        : Starts recording decision inputs for host replay.
+ ***********************************************************************************/
+bool trace_open(const char* filename) {
+    trace_fp = fopen(filename, "wb");
+    if (!trace_fp) {
+        log_nusantara(LOG_WARN, "Unable to open decision trace %s", filename);
+        return false;
+    }
+
+    TraceHeader header = {.version = TRACE_VERSION, .record_size = sizeof(TraceRecord)};
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    fwrite(&header, sizeof(header), 1, trace_fp);
+    fflush(trace_fp);
+
+    trace_bytes = sizeof(header);
+    trace_start_ms = -1;
+    nr_packages = 0;
+    log_nusantara(LOG_INFO, "Recording decision trace to %s", filename);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : trace_package_id
+ * Inputs             : package (const char *) - foreground game, may be NULL
+ *                      t_ms (uint32_t) - record time
+ * Returns            : uint16_t - package id, 0 when no game
+ * Description        : Names are written once as TRACE_PACKAGE records, rounds
+ *                      only carry the id.
+ ***********************************************************************************/
+static uint16_t trace_package_id(const char* package, const uint32_t t_ms) {
+    if (!package)
+        return 0;
+
+    for (int i = 0; i < nr_packages; i++) {
+        if (strcmp(packages[i], package) == 0)
+            return (uint16_t)(i + 1);
+    }
+
+    // Out of ids, later games share the last one
+    if (nr_packages == TRACE_MAX_PACKAGES)
+        return TRACE_MAX_PACKAGES;
+
+    snprintf(packages[nr_packages], MAX_PACKAGE, "%s", package);
+    uint16_t id = (uint16_t)++nr_packages;
+    uint8_t len = (uint8_t)strlen(packages[id - 1]);
+
+    TraceRecord record = {.t_ms = t_ms, .kind = TRACE_PACKAGE, .package = id};
+    fwrite(&record, sizeof(record), 1, trace_fp);
+    fwrite(&len, sizeof(len), 1, trace_fp);
+    fwrite(packages[id - 1], 1, len, trace_fp);
+    trace_bytes += sizeof(record) + sizeof(len) + len;
+    return id;
+}
+
+/***********************************************************************************
+ * Function Name      : trace_record
+ * Inputs             : in (const ProfileInputs *) - inputs of this round
+ *                      package (const char *) - foreground game, may be NULL
+ * Returns            : None
+ * Description        : Appends one 8 byte round record. Recording stops once
+ *                      the trace reaches TRACE_MAX_BYTES.
+ ***********************************************************************************/
+void trace_record(const ProfileInputs* in, const char* package) {
+    if (!trace_fp)
+        return;
+
+    if (trace_bytes >= TRACE_MAX_BYTES) {
+        log_nusantara(LOG_INFO, "Decision trace reached %d bytes, recording stopped", TRACE_MAX_BYTES);
+        trace_close();
+        return;
+    }
+
+    if (trace_start_ms < 0)
+        trace_start_ms = in->now_ms;
+
+    uint32_t t_ms = (uint32_t)(in->now_ms - trace_start_ms);
+    TraceRecord record = {.t_ms = t_ms, .kind = TRACE_ROUND, .package = trace_package_id(package, t_ms)};
+    record.flags = (in->screen_on ? TRACE_SCREEN_ON : 0) | (in->low_power ? TRACE_LOW_POWER : 0) |
+                   (in->game_alive ? TRACE_GAME_ALIVE : 0) | (in->game_bg ? TRACE_GAME_BG : 0);
+
+    fwrite(&record, sizeof(record), 1, trace_fp);
+    trace_bytes += sizeof(record);
+
+    // Daemon dies by signal, keep every round on disk
+    fflush(trace_fp);
+}
+
+/***********************************************************************************
+ * Function Name      : trace_close
+ * Inputs             : None
+ * Returns            : None
+ ***********************************************************************************/
+void trace_close(void) {
+    if (!trace_fp)
+        return;
+
+    fclose(trace_fp);
+    trace_fp = NULL;
+}
@@ -149,6 +149,7 @@ extract "$ZIPFILE" velocity.banner.avif "$MODPATH"
 extract "$ZIPFILE" "libs/$ARCH_TMP/sys.nusaservice" "$TMPDIR"
 cp "$TMPDIR/libs/$ARCH_TMP/"* "$MODPATH/system/bin"
 ln -sf "$MODPATH/system/bin/sys.nusaservice" "$MODPATH/system/bin/nusantara_log"
+ln -sf "$MODPATH/system/bin/sys.nusaservice" "$MODPATH/system/bin/nusantara_history"
 rm -rf "$TMPDIR/libs"
 
 # KernelSU / APatch Handling
@@ -166,6 +167,7 @@ if [ "$KSU" = "true" ] || [ "$APATCH" = "true" ]; then
 			ui_print "- Creating symlink in $dir"
 			ln -sf "$BIN_PATH/sys.nusaservice" "$dir/sys.nusaservice"
 			ln -sf "$BIN_PATH/sys.nusaservice" "$dir/nusantara_log"
+			ln -sf "$BIN_PATH/sys.nusaservice" "$dir/nusantara_history"
 			ln -sf "$BIN_PATH/nusantara_profiler" "$dir/nusantara_profiler"
 			ln -sf "$BIN_PATH/nusantara_utility" "$dir/nusantara_utility"
 			ln -sf "$BIN_PATH/sys.npreloader" "$dir/sys.npreloader"
@@ -193,6 +195,55 @@ make_dir "$MODULE_CONFIG"
 make_node 0 "$MODULE_CONFIG/lite_mode"
 make_node 0 "$MODULE_CONFIG/dnd_gameplay"
 make_node 0 "$MODULE_CONFIG/device_mitigation"
+make_node 1 "$MODULE_CONFIG/cgroup_placement"
+make_node 0 "$MODULE_CONFIG/app_freezer"
+make_node 1024 "$MODULE_CONFIG/freeze_budget"
+make_node 0 "$MODULE_CONFIG/trace_record"
+make_node 1 "$MODULE_CONFIG/gpu_controller"
+make_node 1 "$MODULE_CONFIG/io_boost"
+make_node 1 "$MODULE_CONFIG/net_monitor"
+make_node 1 "$MODULE_CONFIG/irq_affinity"
+make_node 300 "$MODULE_CONFIG/retain_grace"
+make_node 0 "$MODULE_CONFIG/retain_warm"
+make_node 1 "$MODULE_CONFIG/launch_boost"
+make_node 1 "$MODULE_CONFIG/touch_boost"
+make_node 250 "$MODULE_CONFIG/touch_boost_ms"
+make_node 50 "$MODULE_CONFIG/touch_boost_floor"
+[ ! -f "$MODULE_CONFIG/freeze_whitelist" ] && cat <<EOF >"$MODULE_CONFIG/freeze_whitelist"
+# Packages never frozen by app freezer, launcher and keyboard are added automatically
+com.spotify.music
+com.google.android.apps.youtube.music
+com.whatsapp
+org.telegram.messenger
+EOF
+[ ! -f "$MODULE_CONFIG/gameconfig.txt" ] && cat <<EOF >"$MODULE_CONFIG/gameconfig.txt"
+# Per-game tuning, one game per line: <package> key=value ...
+# Games listed here are detected even when missing from gamelist.txt
+#   governor=<name>         CPU governor during the session
+#   floor=<0-100>           frequency floor in percent of each cluster table
+#   thread=<comm>:<class>   extra thread patterns, class is main/render/audio/worker
+#   preload=<0|1>           preload game files on launch
+#   preload_budget=<MB>     preload budget, picked by RAM when unset
+#   secondary=<process>     extra processes to prioritize, comma separated
+#   cgroup=<0|1>            cgroup placement for this game
+#   render=<process>        process carrying the render workload, boosted instead
+#                           of the main one, ":name" is appended to the package
+#   background=<indicator>  what means the game only lingers in background:
+#                           render_missing (default with render), oom_adj, never
+# com.example.game floor=60 thread=GameThread:main preload_budget=400
+com.mobile.legends render=:UnityKillsMe
+com.mobilelegends.hwag render=:UnityKillsMe
+com.mobiin.gp render=:UnityKillsMe
+com.mobilechess.gp render=:UnityKillsMe
+EOF
+[ ! -f "$MODULE_CONFIG/transition_dwell" ] && cat <<EOF >"$MODULE_CONFIG/transition_dwell"
+# Profile transition dwell times in ms: <from> <to> <ms>
+# Profiles: performance normal powersave
+# grace keeps a game boosted while it is briefly in background or screen is off
+grace 30000
+normal powersave 0
+powersave normal 0
+EOF
 [ ! -f "$MODULE_CONFIG/ppm_policies_mediatek" ] && echo 'PWR_THRO|THERMAL' >"$MODULE_CONFIG/ppm_policies_mediatek"
 [ ! -f "$MODULE_CONFIG/gamelist.txt" ] && extract "$ZIPFILE" 'gamelist.txt' "$MODULE_CONFIG"
 
@@ -25,11 +25,6 @@ chmod 644 "$CPUFREQ/scaling_governor"
 default_gov=$(cat "$CPUFREQ/scaling_governor")
 echo "$default_gov" >$MODULE_CONFIG/default_cpu_gov
 
-# Wait until boot completed
-while [ -z "$(getprop sys.boot_completed)" ]; do
-	sleep 40
-done
-
 # Handle case when 'default_gov' is performance
 # Skip this routine custom_default_cpu_gov is defined
 if [ "$default_gov" == "performance" ] && [ ! -f $MODULE_CONFIG/custom_default_cpu_gov ]; then
@@ -42,20 +37,11 @@ if [ "$default_gov" == "performance" ] && [ ! -f $MODULE_CONFIG/custom_default_c
 	done
 fi
 
-# Revert to normal CPU governor
+# Daemon waits for boot completion itself, then puts default governor
+# back and restarts PPM on old MediaTek devices.
 custom_gov="$MODULE_CONFIG/custom_default_cpu_gov"
 [ -f "$custom_gov" ] && default_gov=$(cat "$custom_gov")
-echo "$default_gov" | tee /sys/devices/system/cpu/cpu*/cpufreq/scaling_governor
 [ ! -f $MODULE_CONFIG/powersave_cpu_gov ] && echo "$default_gov" >$MODULE_CONFIG/powersave_cpu_gov
 
-# Mitigate buggy thermal throttling on post-startup
-# in old MediaTek devices.
-ENABLE_PPM="/proc/ppm/enabled"
-if [ -f "$ENABLE_PPM" ]; then
-	echo 0 >"$ENABLE_PPM"
-	sleep 1
-	echo 1 >"$ENABLE_PPM"
-fi
-
 # Start nusantara Daemon
 sys.nusaservice
@@ -16,7 +16,7 @@
 
 pm uninstall --user 0 velocity.toast
 rm -rf /data/adb/.config/Nusantara
-need_gone="sys.nusaservice nusantara_profiler nusantara_utility nusantara_log"
+need_gone="sys.nusaservice nusantara_profiler nusantara_utility nusantara_log nusantara_history"
 manager_paths="/data/adb/ap/bin /data/adb/ksu/bin"
 
 for dir in $manager_paths; do
@@ -19,6 +19,17 @@
 MODULE_CONFIG="/data/adb/.config/Nusantara"
 
 change_cpu_gov() {
+	# Optional cluster class (little, mid, big, prime) from daemon CPU topology
+	[ -n "$2" ] && [ -f "$MODULE_CONFIG/cpu_topology" ] && {
+		awk -v class="$2" '$2 == class {print $1}' "$MODULE_CONFIG/cpu_topology" | while read -r policy; do
+			node="/sys/devices/system/cpu/cpufreq/$policy/scaling_governor"
+			chmod 644 "$node"
+			echo "$1" | tee "$node"
+			chmod 444 "$node"
+		done
+		return
+	}
+
 	chmod 644 /sys/devices/system/cpu/cpu*/cpufreq/scaling_governor
 	echo "$1" | tee /sys/devices/system/cpu/cpu*/cpufreq/scaling_governor
 	chmod 444 /sys/devices/system/cpu/cpu*/cpufreq/scaling_governor